@@ -0,0 +1,241 @@
+/* PDCurses */
+
+/* Prints a binary trace written by traceoff() when PDC_TRACE_RING is
+   set; see debug.c for the layout of the file. Each event is printed as
+   its time in microseconds since the first event kept, followed by its
+   format filled in with the numbers recorded; strings, which aren't
+   recorded, appear as "?".
+
+   Usage: tracedump [file]     (default "trace.bin")
+
+   This program doesn't need PDCurses, and builds on its own with a C99
+   compiler, e.g.:
+
+   cc -o tracedump tracedump.c
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TRACE_VERSION 2
+#define MAXARGS 16
+
+typedef unsigned long long TRACE_ARG;
+
+static FILE *fp;
+static int argbits;     /* the size of an argument where it was recorded */
+
+static int get_word(unsigned long *word)
+{
+    unsigned char bytes[4];
+
+    if (fread(bytes, 4, 1, fp) != 1)
+        return 0;
+
+    *word = bytes[0] | ((unsigned long)bytes[1] << 8) |
+            ((unsigned long)bytes[2] << 16) | ((unsigned long)bytes[3] << 24);
+
+    return 1;
+}
+
+/* read an argument, kept as two words, low word first */
+
+static int get_arg(TRACE_ARG *arg)
+{
+    unsigned long low, high;
+
+    if (!get_word(&low) || !get_word(&high))
+        return 0;
+
+    *arg = low | ((TRACE_ARG)high << 32);
+
+    return 1;
+}
+
+/* print fmt the way printf() would, taking the number for each
+   conversion from args */
+
+static void print_event(const char *fmt, int nargs, TRACE_ARG *args)
+{
+    char spec[32];
+    int arg = 0;
+
+    while (*fmt)
+    {
+        const char *start = fmt;
+        size_t len;
+
+        if (*fmt != '%')
+        {
+            putchar(*fmt++);
+            continue;
+        }
+
+        fmt++;
+
+        if (*fmt == '%')
+        {
+            putchar(*fmt++);
+            continue;
+        }
+
+        while (*fmt && strchr("-+ #0123456789.", *fmt))
+            fmt++;
+
+        len = fmt - start;
+
+        while (*fmt == 'l' || *fmt == 'h')
+            fmt++;
+
+        if (!*fmt || len + 4 > sizeof(spec) || arg >= nargs)
+        {
+            /* nothing was recorded for this conversion */
+
+            fwrite(start, fmt - start + (*fmt != 0), 1, stdout);
+
+            if (*fmt)
+                fmt++;
+
+            continue;
+        }
+
+        /* rebuild the conversion with the flags and width it had, for a
+           long long */
+
+        memcpy(spec, start, len);
+
+        switch (*fmt)
+        {
+        case 'd':
+        case 'i':
+            {
+                /* sign-extend from the size it was recorded at */
+
+                TRACE_ARG sign = (TRACE_ARG)1 << (argbits - 1);
+
+                strcpy(spec + len, "lld");
+                printf(spec, (long long)((args[arg] ^ sign) - sign));
+            }
+            break;
+        case 'c':
+            strcpy(spec + len, "c");
+            printf(spec, (int)(args[arg] & 0xff));
+            break;
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X':
+            spec[len] = 'l';
+            spec[len + 1] = 'l';
+            spec[len + 2] = *fmt;
+            spec[len + 3] = '\0';
+            printf(spec, args[arg]);
+            break;
+        case 'p':
+            printf("0x%0*llx", argbits / 4, args[arg]);
+            break;
+        case 's':
+            strcpy(spec + len, "s");
+            printf(spec, "?");
+            break;
+        default:
+            fwrite(start, fmt - start + 1, 1, stdout);
+        }
+
+        arg++;
+        fmt++;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = (argc > 1) ? argv[1] : "trace.bin";
+    unsigned long version, nargs, argbytes, nformats, recorded, kept;
+    unsigned long first = 0;
+    unsigned long i, j;
+    char **formats;
+    char magic[4];
+
+    fp = fopen(path, "rb");
+    if (!fp)
+    {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return 1;
+    }
+
+    if (fread(magic, 4, 1, fp) != 1 || memcmp(magic, "PDCT", 4) ||
+        !get_word(&version) || !get_word(&nargs) || !get_word(&argbytes) ||
+        !get_word(&nformats) || !get_word(&recorded) || !get_word(&kept))
+    {
+        fprintf(stderr, "%s: not a PDCurses trace\n", path);
+        return 1;
+    }
+
+    if (version != TRACE_VERSION || nargs > MAXARGS ||
+        (argbytes != 4 && argbytes != 8))
+    {
+        fprintf(stderr, "%s: version %lu with %lu arguments of %lu bytes "
+                "is not supported\n", path, version, nargs, argbytes);
+        return 1;
+    }
+
+    argbits = (int)argbytes * 8;
+
+    formats = malloc((nformats + 1) * sizeof(char *));
+    if (!formats)
+        return 1;
+
+    for (i = 0; i < nformats; i++)
+    {
+        unsigned long len;
+
+        if (!get_word(&len) || !(formats[i] = malloc(len + 1)) ||
+            fread(formats[i], 1, len, fp) != len)
+        {
+            fprintf(stderr, "%s: truncated in format %lu\n", path, i);
+            return 1;
+        }
+
+        formats[i][len] = '\0';
+    }
+
+    printf("%s: %lu events recorded, the last %lu kept\n",
+           path, recorded, kept);
+
+    for (i = 0; i < kept; i++)
+    {
+        unsigned long ticks, format, count;
+        TRACE_ARG args[MAXARGS];
+
+        if (!get_word(&ticks) || !get_word(&format) || !get_word(&count))
+        {
+            fprintf(stderr, "%s: truncated after %lu events\n", path, i);
+            return 1;
+        }
+
+        for (j = 0; j < nargs; j++)
+            if (!get_arg(args + j))
+            {
+                fprintf(stderr, "%s: truncated in event %lu\n", path, i);
+                return 1;
+            }
+
+        if (!i)
+            first = ticks;
+
+        /* the clock wraps around at 32 bits */
+
+        printf("At: %10lu us - ", (ticks - first) & 0xffffffffUL);
+
+        if (format < nformats)
+            print_event(formats[format], (int)(count < nargs ? count : nargs),
+                        args);
+        else
+            printf("(format table full)\n");
+    }
+
+    fclose(fp);
+
+    return 0;
+}
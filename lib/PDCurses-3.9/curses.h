@@ -16,6 +16,8 @@ Define before inclusion (only those needed):
     PDC_DLL_BUILD   True if building a Windows DLL.
     PDC_NCMOUSE     Use the ncurses mouse API instead
                     of PDCurses' traditional mouse API.
+    PDC_THREADS     True if building with a separate current screen
+                    for each thread (see set_term()).
 
 Defined by this header:
 
@@ -124,7 +126,8 @@ enum
     PDC_VFLAG_WIDE  = 2,  /* -DPDC_WIDE */
     PDC_VFLAG_UTF8  = 4,  /* -DPDC_FORCE_UTF8 */
     PDC_VFLAG_DLL   = 8,  /* -DPDC_DLL_BUILD */
-    PDC_VFLAG_RGB   = 16  /* -DPDC_RGB */
+    PDC_VFLAG_RGB   = 16, /* -DPDC_RGB */
+    PDC_VFLAG_THREADS = 32 /* -DPDC_THREADS */
 };
 
 /*----------------------------------------------------------------------
@@ -251,6 +254,8 @@ typedef struct
     int x, y, z;    /* x, y same as MOUSE_STATUS; z unused */
     mmask_t bstate; /* equivalent to changes + button[], but
                        in the same format as used for mousemask() */
+    unsigned long time; /* PDCurses: when the port received the event,
+                           from PDC_get_ticks() */
 } MEVENT;
 
 #if defined(PDC_NCMOUSE) && !defined(NCURSES_MOUSE_VERSION)
@@ -300,8 +305,21 @@ typedef struct _win       /* definition of a window */
     int   _delayms;       /* milliseconds of delay for getch() */
     int   _parx, _pary;   /* coords relative to parent (0,0) */
     struct _win *_parent; /* subwin's pointer to parent win */
+    unsigned long *_dirty; /* changed chunks of each line, as bitmaps */
 } WINDOW;
 
+/* Receives a span of PDCurses' work: what it was, when it began and
+   ended (from PDC_get_ticks()), and two figures that depend on the
+   span; see PDC_set_trace_hook() */
+
+typedef void (*PDC_TRACE_HOOK)(int span, unsigned long start,
+                               unsigned long end, long arg1, long arg2);
+
+#define PDC_SPAN_WNOUTREFRESH   0   /* lines and cells copied */
+#define PDC_SPAN_DOUPDATE       1   /* runs and cells sent to the port */
+#define PDC_SPAN_TRANSFORM_LINE 2   /* line and cells sent */
+#define PDC_SPAN_UPDATE_RECTS   3   /* rectangles presented */
+
 /* Avoid using the SCREEN struct directly -- use the corresponding
    functions if possible. This struct may eventually be made private. */
 
@@ -347,6 +365,10 @@ typedef struct
     bool  key_code;                /* TRUE if last key is a special key;
                                       used internally by get_wch() */
     MOUSE_STATUS mouse_status;     /* last returned mouse status */
+    unsigned long key_time;        /* when the port received the last
+                                      key or mouse event, in ticks */
+    int   pointer_y;               /* latest known pointer cell, */
+    int   pointer_x;               /* or -1 if there's none yet */
 #ifdef XCURSES
     bool  sb_on;
     int   sb_viewport_y;
@@ -360,12 +382,75 @@ typedef struct
     attr_t termattrs;     /* attribute capabilities */
     WINDOW *lastscr;      /* the last screen image */
     FILE *dbfp;           /* debug trace file pointer */
+    PDC_TRACE_HOOK trace_hook; /* receives timed spans, or NULL */
     bool  color_started;  /* TRUE after start_color() */
     bool  dirty;          /* redraw on napms() after init_color() */
     int   sel_start;      /* start of selection (y * COLS + x) */
     int   sel_end;        /* end of selection */
 } SCREEN;
 
+/* Multi-line text art converted to chtypes by new_sprite(), for drawing
+   with wblit_sprite() */
+
+typedef struct
+{
+    int   _maxy;          /* rows in the sprite */
+    int   _maxx;          /* columns in its widest row */
+    chtype *_cells;       /* _maxy rows of _maxx cells */
+    unsigned char *_mask; /* non-zero where a cell is opaque */
+    int   *_first;        /* first opaque cell in each row */
+    int   *_last;         /* last opaque cell in each row */
+} PDC_SPRITE;
+
+/* Allocation counters, kept per allocator; see PDC_set_allocator() */
+
+typedef struct
+{
+    unsigned long allocs;   /* successful allocations and reallocations */
+    unsigned long frees;    /* blocks released */
+    unsigned long failures; /* requests the allocator could not satisfy */
+    size_t bytes;           /* bytes currently allocated */
+    size_t peak;            /* high-water mark of bytes */
+    size_t total;           /* bytes handed out since the counters were
+                               last cleared */
+} PDC_ALLOC_STATS;
+
+/* The memory allocator used for everything PDCurses allocates: windows,
+   panels, soft labels, sprites and the SCREEN structure */
+
+typedef struct
+{
+    void *(*alloc)(void *ctx, size_t size);
+    void *(*resize)(void *ctx, void *ptr, size_t oldsize, size_t size);
+    void  (*release)(void *ctx, void *ptr, size_t size);
+    void  *ctx;             /* passed through to the functions above */
+    PDC_ALLOC_STATS stats;  /* maintained by PDCurses */
+} PDC_ALLOCATOR;
+
+/* A bump allocator over a caller-supplied buffer; see PDC_arena_init() */
+
+typedef struct
+{
+    PDC_ALLOCATOR _allocator;
+    unsigned char *_base; /* start of the usable (aligned) buffer */
+    size_t _size;         /* usable bytes in the buffer */
+    size_t _used;         /* bytes handed out so far */
+    size_t _last;         /* offset of the most recent block */
+} PDC_ARENA;
+
+/* Counters of the output sent to the port; see PDC_get_render_stats() */
+
+typedef struct
+{
+    unsigned long lines;    /* lines doupdate() scanned or redrew */
+    unsigned long compared; /* cells compared with the last screen */
+    unsigned long runs;     /* calls to PDC_transform_line() */
+    unsigned long cells;    /* cells passed to PDC_transform_line() */
+    unsigned long updates;  /* batches of output presented by the port */
+    unsigned long rects;    /* rectangles in those batches */
+    unsigned long bytes;    /* bytes the port wrote for those cells */
+} PDC_RENDER_STATS;
+
 /*----------------------------------------------------------------------
  *
  *  External Variables
@@ -382,17 +467,33 @@ typedef struct
 # define PDCEX extern
 #endif
 
-PDCEX  int          LINES;        /* terminal height */
-PDCEX  int          COLS;         /* terminal width */
-PDCEX  WINDOW       *stdscr;      /* the default screen window */
-PDCEX  WINDOW       *curscr;      /* the current screen image */
-PDCEX  SCREEN       *SP;          /* curses variables */
-PDCEX  MOUSE_STATUS Mouse_status;
-PDCEX  int          COLORS;
-PDCEX  int          COLOR_PAIRS;
-PDCEX  int          TABSIZE;
-PDCEX  chtype       acs_map[];    /* alternate character set map */
-PDCEX  char         ttytype[];    /* terminal name/description */
+/* With PDC_THREADS, the variables that describe the current screen are
+   kept per thread */
+
+#ifdef PDC_THREADS
+# ifdef PDC_DLL_BUILD
+#  error PDC_THREADS cannot be used with PDC_DLL_BUILD
+# endif
+# ifdef _MSC_VER
+#  define PDC_TLS __declspec(thread)
+# else
+#  define PDC_TLS __thread
+# endif
+#else
+# define PDC_TLS
+#endif
+
+PDCEX  PDC_TLS int          LINES;        /* terminal height */
+PDCEX  PDC_TLS int          COLS;         /* terminal width */
+PDCEX  PDC_TLS WINDOW       *stdscr;      /* the default screen window */
+PDCEX  PDC_TLS WINDOW       *curscr;      /* the current screen image */
+PDCEX  PDC_TLS SCREEN       *SP;          /* curses variables */
+PDCEX  PDC_TLS MOUSE_STATUS Mouse_status;
+PDCEX  PDC_TLS int          COLORS;
+PDCEX  PDC_TLS int          COLOR_PAIRS;
+PDCEX  PDC_TLS int          TABSIZE;
+PDCEX          chtype       acs_map[];    /* alternate character set map */
+PDCEX  PDC_TLS char         ttytype[];    /* terminal name/description */
 
 /*man-start**************************************************************
 
@@ -1290,6 +1391,7 @@ PDCEX  int     mouseinterval(int);
 PDCEX  mmask_t mousemask(mmask_t, mmask_t *);
 PDCEX  bool    mouse_trafo(int *, int *, bool);
 PDCEX  int     nc_getmouse(MEVENT *);
+PDCEX  int     nc_getmouse_batch(MEVENT *, int);
 PDCEX  int     ungetmouse(MEVENT *);
 PDCEX  bool    wenclose(const WINDOW *, int, int);
 PDCEX  bool    wmouse_trafo(const WINDOW *, int *, int *, bool);
@@ -1297,6 +1399,8 @@ PDCEX  bool    wmouse_trafo(const WINDOW *, int *, int *, bool);
 /* PDCurses */
 
 PDCEX  int     addrawch(chtype);
+PDCEX  int     blit_sprite(int, int, const PDC_SPRITE *);
+PDCEX  int     del_sprite(PDC_SPRITE *);
 PDCEX  int     insrawch(chtype);
 PDCEX  bool    is_termresized(void);
 PDCEX  int     mvaddrawch(int, int, chtype);
@@ -1307,10 +1411,12 @@ PDCEX  int     mvwaddrawch(WINDOW *, int, int, chtype);
 PDCEX  int     mvwdeleteln(WINDOW *, int, int);
 PDCEX  int     mvwinsertln(WINDOW *, int, int);
 PDCEX  int     mvwinsrawch(WINDOW *, int, int, chtype);
+PDCEX  PDC_SPRITE *new_sprite(const char *const *, int, chtype, char);
 PDCEX  int     raw_output(bool);
 PDCEX  int     resize_term(int, int);
 PDCEX  WINDOW *resize_window(WINDOW *, int, int);
 PDCEX  int     waddrawch(WINDOW *, chtype);
+PDCEX  int     wblit_sprite(WINDOW *, int, int, const PDC_SPRITE *);
 PDCEX  int     winsrawch(WINDOW *, chtype);
 PDCEX  char    wordchar(void);
 
@@ -1333,8 +1439,22 @@ PDCEX  int     PDC_setclipboard(const char *, long);
 
 PDCEX  unsigned long PDC_get_input_fd(void);
 PDCEX  unsigned long PDC_get_key_modifiers(void);
+PDCEX  int     PDC_get_pointer(int *, int *);
 PDCEX  int     PDC_return_key_modifiers(bool);
 
+PDCEX  int     PDC_cell_drawn(int, unsigned long *);
+PDCEX  unsigned long PDC_get_ticks(void);
+PDCEX  int     PDC_watch_cell(int, int);
+
+PDCEX  void    PDC_get_render_stats(PDC_RENDER_STATS *);
+PDCEX  void    PDC_reset_render_stats(void);
+PDCEX  int     PDC_set_trace_hook(PDC_TRACE_HOOK);
+
+PDCEX  PDC_ALLOCATOR *PDC_arena_init(PDC_ARENA *, void *, size_t);
+PDCEX  void    PDC_arena_reset(PDC_ARENA *);
+PDCEX  PDC_ALLOCATOR *PDC_get_allocator(void);
+PDCEX  int     PDC_set_allocator(PDC_ALLOCATOR *);
+
 #ifdef XCURSES
 PDCEX  WINDOW *Xinitscr(int, char **);
 PDCEX  void    XCursesExit(void);
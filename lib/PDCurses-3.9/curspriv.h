@@ -6,6 +6,7 @@
 
 #define CURSES_LIBRARY
 #include <curses.h>
+#include <limits.h>
 
 #if defined(__TURBOC__) || defined(__EMX__) || defined(__DJGPP__) || \
     defined(PDC_99) || defined(__WATCOMC__)
@@ -38,6 +39,29 @@ typedef struct           /* structure for ripped off lines */
 
 #define _NO_CHANGE -1    /* flags line edge unchanged */
 
+/* Change tracking: as well as its _firstch/_lastch span, each line of a
+   window has a bitmap with a bit for each chunk of 1 << _DIRTY_SHIFT
+   columns, so that refreshes can skip the unchanged chunks between
+   scattered updates. Use PDC_mark_changed() and PDC_mark_unchanged()
+   rather than setting the span directly.
+
+   The bitmaps are only kept if PDCurses is built with PDC_DIRTY_CHUNKS.
+   Marking them costs more than skipping saves unless lines are wide and
+   their changes few and far apart, so by default they take no room, and
+   refreshes work from the spans alone. */
+
+#define _DIRTY_SHIFT 3   /* 8 columns per chunk */
+#define _DIRTY_BITS  ((int)(CHAR_BIT * sizeof(unsigned long))) /* chunks a word */
+
+#ifdef PDC_DIRTY_CHUNKS
+# define _DIRTY_WORDS(ncols) \
+    (((ncols) + (_DIRTY_BITS << _DIRTY_SHIFT) - 1) / \
+     (_DIRTY_BITS << _DIRTY_SHIFT))
+#else
+# define _DIRTY_WORDS(ncols) 0
+#endif
+#define _DIRTY_MAP(win, y) ((win)->_dirty + (y) * _DIRTY_WORDS((win)->_maxx))
+
 #define _ECHAR     0x08  /* Erase char       (^H) */
 #define _DWCHAR    0x17  /* Delete Word char (^W) */
 #define _DLCHAR    0x15  /* Delete Line char (^U) */
@@ -74,14 +98,29 @@ void    PDC_scr_free(void);
 int     PDC_scr_open(int, char **);
 void    PDC_set_keyboard_binary(bool);
 void    PDC_transform_line(int, int, int, const chtype *);
+int     PDC_wait_input(int);
 const char *PDC_sysname(void);
 
 /* Internal cross-module functions */
 
+void   *PDC_calloc(size_t, size_t);
+void    PDC_check_watches(int, int, int);
+void    PDC_count_bytes(unsigned long);
+void    PDC_count_update(int);
+bool    PDC_click_wanted(int);
+void    PDC_drain_mouse(void);
+void    PDC_flush_mouse(void);
+void    PDC_free(void *);
 void    PDC_init_atrtab(void);
 WINDOW *PDC_makelines(WINDOW *);
 WINDOW *PDC_makenew(int, int, int, int);
+void   *PDC_malloc(size_t);
+void    PDC_mark_changed(WINDOW *, int, int, int);
+void    PDC_mark_unchanged(WINDOW *, int);
 int     PDC_mouse_in_slk(int, int);
+bool    PDC_mouse_unseen(void);
+bool    PDC_queue_mouse(bool);
+void   *PDC_realloc(void *, size_t);
 void    PDC_slk_free(void);
 void    PDC_slk_initialize(void);
 void    PDC_sync(WINDOW *);
@@ -92,12 +131,22 @@ size_t  PDC_mbstowcs(wchar_t *, const char *, size_t);
 size_t  PDC_wcstombs(char *, const wchar_t *, size_t);
 #endif
 
-#ifdef PDCDEBUG
+#if defined(PDCDEBUG) || defined(PDC_TRACE)
 # define PDC_LOG(x) if (SP && SP->dbfp) PDC_debug x
 #else
 # define PDC_LOG(x)
 #endif
 
+/* Reports a span that began at start to the trace hook, if one is set;
+   PDC_TRACE_START() reads the clock only when it is */
+
+#define PDC_TRACE_START() ((SP && SP->trace_hook) ? PDC_get_ticks() : 0)
+#define PDC_TRACE_SPAN(span, start, arg1, arg2) \
+    do { \
+        if (SP && SP->trace_hook) \
+            SP->trace_hook(span, start, PDC_get_ticks(), arg1, arg2); \
+    } while (0)
+
 /* Internal macros for attributes */
 
 #define PDC_COLOR_PAIRS 256
@@ -61,7 +61,7 @@ int PDC_getclipboard(char **contents, long *length)
         return PDC_CLIP_EMPTY;
 
     len = strlen(pdc_DOS_clipboard);
-    *contents = malloc(len + 1);
+    *contents = PDC_malloc(len + 1);
     if (!*contents)
         return PDC_CLIP_MEMORY_ERROR;
 
@@ -77,13 +77,13 @@ int PDC_setclipboard(const char *contents, long length)
 
     if (pdc_DOS_clipboard)
     {
-        free(pdc_DOS_clipboard);
+        PDC_free(pdc_DOS_clipboard);
         pdc_DOS_clipboard = NULL;
     }
 
     if (contents)
     {
-        pdc_DOS_clipboard = malloc(length + 1);
+        pdc_DOS_clipboard = PDC_malloc(length + 1);
         if (!pdc_DOS_clipboard)
             return PDC_CLIP_MEMORY_ERROR;
 
@@ -112,7 +112,7 @@ int PDC_freeclipboard(char *contents)
         if (strlen(contents) >= strlen("PDCURSES"))
             strcpy(contents, "PDCURSES");
 
-        free(contents);
+        PDC_free(contents);
     }
 
     return PDC_CLIP_SUCCESS;
@@ -124,7 +124,7 @@ int PDC_clearclipboard(void)
 
     if (pdc_DOS_clipboard)
     {
-        free(pdc_DOS_clipboard);
+        PDC_free(pdc_DOS_clipboard);
         pdc_DOS_clipboard = NULL;
     }
 
@@ -269,7 +269,7 @@ static int _process_mouse_events(void)
 
                 if (!button[i].released)
                 {
-                    if (SP->mouse_wait)
+                    if (PDC_click_wanted(i))
                     {
                         PDCREGS regs;
 
@@ -305,6 +305,21 @@ static int _process_mouse_events(void)
     return KEY_MOUSE;
 }
 
+/* no way to sleep on input here, so nap in short steps and let
+   wgetch() check again */
+
+int PDC_wait_input(int ms)
+{
+    PDC_LOG(("PDC_wait_input() - called: ms=%d\n", ms));
+
+    if (ms < 0 || ms > 50)
+        ms = 50;
+
+    napms(ms);
+
+    return ms;
+}
+
 /* return the next available key or mouse event */
 
 int PDC_get_key(void)
@@ -313,6 +328,7 @@ int PDC_get_key(void)
     int key, scan;
 
     SP->key_modifiers = 0;
+    SP->key_time = PDC_get_ticks();
 
     if (mouse_vis && (mouse_scroll || mouse_button || mouse_moved))
         return _process_mouse_events();
@@ -467,7 +467,7 @@ void PDC_scr_close(void)
         (void *)saved_screen, (saved_lines * saved_cols * 2));
 # endif
 #endif
-        free(saved_screen);
+        PDC_free(saved_screen);
         saved_screen = NULL;
     }
 
@@ -484,7 +484,7 @@ void PDC_scr_close(void)
 void PDC_scr_free(void)
 {
     if (SP)
-        free(SP);
+        PDC_free(SP);
 }
 
 /* open the physical screen -- allocate SP, miscellaneous intialization,
@@ -500,7 +500,7 @@ int PDC_scr_open(int argc, char **argv)
 
     PDC_LOG(("PDC_scr_open() - called\n"));
 
-    SP = calloc(1, sizeof(SCREEN));
+    SP = PDC_calloc(1, sizeof(SCREEN));
 
     if (!SP)
         return ERR;
@@ -539,7 +539,7 @@ int PDC_scr_open(int argc, char **argv)
         saved_lines = SP->lines;
         saved_cols = SP->cols;
 
-        saved_screen = malloc(saved_lines * saved_cols * 2);
+        saved_screen = PDC_malloc(saved_lines * saved_cols * 2);
 
         if (!saved_screen)
         {
@@ -39,6 +39,13 @@ void PDC_napms(int ms)
     }
 }
 
+unsigned long PDC_get_ticks(void)
+{
+    /* the BIOS tick count, at about 18.2 Hz */
+
+    return getdosmemdword(0x46c) * 54925UL;
+}
+
 const char *PDC_sysname(void)
 {
     return "DOS";
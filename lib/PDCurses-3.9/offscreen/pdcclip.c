@@ -0,0 +1,112 @@
+/* PDCurses */
+
+#include "pdcoff.h"
+
+#include <string.h>
+
+/*man-start**************************************************************
+
+clipboard
+---------
+
+### Synopsis
+
+    int PDC_getclipboard(char **contents, long *length);
+    int PDC_setclipboard(const char *contents, long length);
+    int PDC_freeclipboard(char *contents);
+    int PDC_clearclipboard(void);
+
+### Description
+
+   PDC_getclipboard() gets the textual contents of the system's
+   clipboard. This function returns the contents of the clipboard in the
+   contents argument. It is the responsibility of the caller to free the
+   memory returned, via PDC_freeclipboard(). The length of the clipboard
+   contents is returned in the length argument.
+
+   PDC_setclipboard copies the supplied text into the system's
+   clipboard, emptying the clipboard prior to the copy.
+
+   PDC_clearclipboard() clears the internal clipboard.
+
+### Return Values
+
+   indicator of success/failure of call.
+   PDC_CLIP_SUCCESS        the call was successful
+   PDC_CLIP_MEMORY_ERROR   unable to allocate sufficient memory for
+                           the clipboard contents
+   PDC_CLIP_EMPTY          the clipboard contains no text
+   PDC_CLIP_ACCESS_ERROR   no clipboard support
+
+### Portability
+                             X/Open  ncurses  NetBSD
+    PDC_getclipboard            -       -       -
+    PDC_setclipboard            -       -       -
+    PDC_freeclipboard           -       -       -
+    PDC_clearclipboard          -       -       -
+
+**man-end****************************************************************/
+
+/* the screen's own clipboard, as there is no system one to use */
+
+int PDC_getclipboard(char **contents, long *length)
+{
+    int len;
+
+    PDC_LOG(("PDC_getclipboard() - called\n"));
+
+    if (!PDC_OFF->clipboard)
+        return PDC_CLIP_EMPTY;
+
+    len = strlen(PDC_OFF->clipboard);
+    *contents = PDC_malloc(len + 1);
+    if (!*contents)
+        return PDC_CLIP_MEMORY_ERROR;
+
+    strcpy(*contents, PDC_OFF->clipboard);
+    *length = len;
+
+    return PDC_CLIP_SUCCESS;
+}
+
+int PDC_setclipboard(const char *contents, long length)
+{
+    PDC_LOG(("PDC_setclipboard() - called\n"));
+
+    PDC_clearclipboard();
+
+    if (contents)
+    {
+        PDC_OFF->clipboard = PDC_malloc(length + 1);
+        if (!PDC_OFF->clipboard)
+            return PDC_CLIP_MEMORY_ERROR;
+
+        memcpy(PDC_OFF->clipboard, contents, length);
+        PDC_OFF->clipboard[length] = '\0';
+    }
+
+    return PDC_CLIP_SUCCESS;
+}
+
+int PDC_freeclipboard(char *contents)
+{
+    PDC_LOG(("PDC_freeclipboard() - called\n"));
+
+    if (contents)
+        PDC_free(contents);
+
+    return PDC_CLIP_SUCCESS;
+}
+
+int PDC_clearclipboard(void)
+{
+    PDC_LOG(("PDC_clearclipboard() - called\n"));
+
+    if (PDC_OFF->clipboard)
+    {
+        PDC_free(PDC_OFF->clipboard);
+        PDC_OFF->clipboard = NULL;
+    }
+
+    return PDC_CLIP_SUCCESS;
+}
@@ -0,0 +1,51 @@
+/* PDCurses */
+
+#include "pdcoff.h"
+
+#ifdef PDC_WIDE
+# include "../common/acsuni.h"
+#else
+# include "../common/acs437.h"
+#endif
+
+/* there is no cursor to move; doupdate() keeps SP->cursrow and
+   SP->curscol */
+
+void PDC_gotoyx(int row, int col)
+{
+    PDC_LOG(("PDC_gotoyx() - called: row %d col %d\n", row, col));
+}
+
+/* update the given physical line to look like the corresponding line in
+   curscr -- here, the screen's cells, with the alternate character set
+   already looked up */
+
+void PDC_transform_line(int lineno, int x, int len, const chtype *srcp)
+{
+    chtype *dest = PDC_OFF->cells + lineno * PDC_OFF->cols + x;
+    int i;
+
+    PDC_LOG(("PDC_transform_line() - called: lineno=%d\n", lineno));
+
+    for (i = 0; i < len; i++)
+    {
+        chtype ch = srcp[i];
+
+        if ((ch & A_ALTCHARSET) && !(ch & 0xff80))
+            ch = (ch & (A_ATTRIBUTES ^ A_ALTCHARSET)) | acs_map[ch & 0x7f];
+
+        dest[i] = ch;
+    }
+
+    PDC_count_bytes(sizeof(chtype) * len);
+}
+
+/* the cell drawn at (y, x), or ERR if there is no such cell */
+
+chtype PDC_offscreen_cell(int y, int x)
+{
+    if (!SP || y < 0 || y >= PDC_OFF->lines || x < 0 || x >= PDC_OFF->cols)
+        return (chtype)ERR;
+
+    return PDC_OFF->cells[y * PDC_OFF->cols + x];
+}
@@ -0,0 +1,92 @@
+/* PDCurses */
+
+#include "pdcoff.h"
+
+/*man-start**************************************************************
+
+pdckbd
+------
+
+### Synopsis
+
+    unsigned long PDC_get_input_fd(void);
+
+### Description
+
+   PDC_get_input_fd() returns the file descriptor that PDCurses reads
+   its input from. It can be used for select().
+
+### Portability
+                             X/Open  ncurses  NetBSD
+    PDC_get_input_fd            -       -       -
+
+**man-end****************************************************************/
+
+/* The offscreen port has no keyboard or mouse. The only input is what
+   ungetch() and ungetmouse() push back, which the core handles. */
+
+unsigned long PDC_get_input_fd(void)
+{
+    PDC_LOG(("PDC_get_input_fd() - called\n"));
+
+    return 0L;  /* there is no input file descriptor */
+}
+
+void PDC_set_keyboard_binary(bool on)
+{
+    PDC_LOG(("PDC_set_keyboard_binary() - called\n"));
+}
+
+/* check if a key or mouse event is waiting */
+
+bool PDC_check_key(void)
+{
+    return FALSE;
+}
+
+/* return the next available key or mouse event */
+
+int PDC_get_key(void)
+{
+    SP->key_code = FALSE;
+
+    return -1;
+}
+
+/* discard any pending keyboard or mouse input -- this is the core
+   routine for flushinp() */
+
+void PDC_flushinp(void)
+{
+    PDC_LOG(("PDC_flushinp() - called\n"));
+}
+
+/* nothing can arrive, so just let up to 50ms pass -- a blocking read
+   with nothing pushed back never returns */
+
+int PDC_wait_input(int ms)
+{
+    PDC_LOG(("PDC_wait_input() - called: ms=%d\n", ms));
+
+    if (ms < 0 || ms > 50)
+        ms = 50;
+
+    PDC_napms(ms);
+
+    return ms;
+}
+
+bool PDC_has_mouse(void)
+{
+    return FALSE;
+}
+
+int PDC_mouse_set(void)
+{
+    return OK;
+}
+
+int PDC_modifiers_set(void)
+{
+    return OK;
+}
@@ -0,0 +1,28 @@
+/* PDCurses */
+
+#include <curspriv.h>
+
+/* A screen of the offscreen port: the SCREEN that SP points to, followed
+   by the port's own state. Each newterm() makes a new one, so screens
+   share nothing -- with PDC_THREADS, each thread can draw its own. */
+
+typedef struct
+{
+    short r, g, b;
+    bool mapped;
+} PDCCOLOR;
+
+typedef struct
+{
+    SCREEN screen;                    /* must come first */
+    chtype *cells;                    /* what has been drawn, by row */
+    int lines, cols;                  /* the size of cells */
+    short pair_fore[PDC_COLOR_PAIRS];
+    short pair_back[PDC_COLOR_PAIRS];
+    PDCCOLOR color[PDC_MAXCOL];       /* colors set by init_color() */
+    char *clipboard;                  /* NULL if none set */
+} PDC_OFFSCREEN;
+
+#define PDC_OFF ((PDC_OFFSCREEN *)SP)
+
+PDCEX  chtype PDC_offscreen_cell(int y, int x);
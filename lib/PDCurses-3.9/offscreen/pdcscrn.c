@@ -0,0 +1,194 @@
+/* PDCurses */
+
+#include "pdcoff.h"
+
+#include <stdlib.h>
+
+/* (re)allocate the screen's cells, blank; returns ERR, leaving the old
+   cells in place, if there's no memory for them */
+
+static int _alloc_cells(int nlines, int ncols)
+{
+    chtype *cells = PDC_malloc(nlines * ncols * sizeof(chtype));
+    int i;
+
+    if (!cells)
+        return ERR;
+
+    for (i = 0; i < nlines * ncols; i++)
+        cells[i] = ' ';
+
+    if (PDC_OFF->cells)
+        PDC_free(PDC_OFF->cells);
+
+    PDC_OFF->cells = cells;
+    PDC_OFF->lines = nlines;
+    PDC_OFF->cols = ncols;
+
+    return OK;
+}
+
+void PDC_scr_close(void)
+{
+    PDC_LOG(("PDC_scr_close() - called\n"));
+}
+
+void PDC_scr_free(void)
+{
+    if (!SP)
+        return;
+
+    if (PDC_OFF->cells)
+        PDC_free(PDC_OFF->cells);
+
+    if (PDC_OFF->clipboard)
+        PDC_free(PDC_OFF->clipboard);
+
+    PDC_free(SP);
+}
+
+/* open the screen -- allocate SP and its cells. The size is taken from
+   the environment variables PDC_LINES and PDC_COLS, or is 80x25. */
+
+int PDC_scr_open(int argc, char **argv)
+{
+    PDC_OFFSCREEN *off;
+    const char *str;
+    int lines, cols;
+
+    PDC_LOG(("PDC_scr_open() - called\n"));
+
+    lines = (str = getenv("PDC_LINES")) ? atoi(str) : 25;
+    cols = (str = getenv("PDC_COLS")) ? atoi(str) : 80;
+
+    if (lines < 2 || cols < 2)
+    {
+        fprintf(stderr, "PDC_LINES and PDC_COLS must be >= 2: got %d, %d\n",
+                lines, cols);
+
+        return ERR;
+    }
+
+    off = PDC_calloc(1, sizeof(PDC_OFFSCREEN));
+    if (!off)
+        return ERR;
+
+    SP = &off->screen;
+
+    if (_alloc_cells(lines, cols) == ERR)
+        return ERR;
+
+    SP->lines = PDC_get_rows();
+    SP->cols = PDC_get_columns();
+
+    SP->mouse_wait = PDC_CLICK_PERIOD;
+    SP->audible = FALSE;
+    SP->mono = FALSE;
+    SP->orig_attr = FALSE;
+
+    SP->termattrs = A_COLOR | A_REVERSE | A_UNDERLINE | A_ITALIC;
+
+    return OK;
+}
+
+/* the new size replaces the cells, blank; a size of 0 keeps the current
+   one */
+
+int PDC_resize_screen(int nlines, int ncols)
+{
+    PDC_LOG(("PDC_resize_screen() - called. Lines: %d Cols: %d\n",
+             nlines, ncols));
+
+    if (!nlines)
+        nlines = PDC_OFF->lines;
+
+    if (!ncols)
+        ncols = PDC_OFF->cols;
+
+    if (nlines < 2 || ncols < 2)
+        return ERR;
+
+    return _alloc_cells(nlines, ncols);
+}
+
+void PDC_reset_prog_mode(void)
+{
+    PDC_LOG(("PDC_reset_prog_mode() - called.\n"));
+}
+
+void PDC_reset_shell_mode(void)
+{
+    PDC_LOG(("PDC_reset_shell_mode() - called.\n"));
+}
+
+void PDC_restore_screen_mode(int i)
+{
+}
+
+void PDC_save_screen_mode(int i)
+{
+}
+
+void PDC_init_pair(short pair, short fg, short bg)
+{
+    PDC_OFF->pair_fore[pair] = fg;
+    PDC_OFF->pair_back[pair] = bg;
+}
+
+int PDC_pair_content(short pair, short *fg, short *bg)
+{
+    *fg = PDC_OFF->pair_fore[pair];
+    *bg = PDC_OFF->pair_back[pair];
+
+    return OK;
+}
+
+bool PDC_can_change_color(void)
+{
+    return TRUE;
+}
+
+/* colors not set by init_color() are the usual eight, and their bright
+   versions; others are unset */
+
+int PDC_color_content(short color, short *red, short *green, short *blue)
+{
+    if (PDC_OFF->color[color].mapped)
+    {
+        *red = PDC_OFF->color[color].r;
+        *green = PDC_OFF->color[color].g;
+        *blue = PDC_OFF->color[color].b;
+    }
+    else if (color < 16)
+    {
+        short on = (color & 8) ? 1000 : 680;
+        short off = (color & 8) ? 333 : 0;
+
+        *red = (color & COLOR_RED) ? on : off;
+        *green = (color & COLOR_GREEN) ? on : off;
+        *blue = (color & COLOR_BLUE) ? on : off;
+    }
+    else
+    {
+        *red = *green = *blue = -1;
+        return ERR;
+    }
+
+    return OK;
+}
+
+int PDC_init_color(short color, short red, short green, short blue)
+{
+    if (red == -1 && green == -1 && blue == -1)
+    {
+        PDC_OFF->color[color].mapped = FALSE;
+        return OK;
+    }
+
+    PDC_OFF->color[color].r = red;
+    PDC_OFF->color[color].g = green;
+    PDC_OFF->color[color].b = blue;
+    PDC_OFF->color[color].mapped = TRUE;
+
+    return OK;
+}
@@ -0,0 +1,59 @@
+/* PDCurses */
+
+#include "pdcoff.h"
+
+#ifdef _WIN32
+# define WIN32_LEAN_AND_MEAN
+# include <windows.h>
+#else
+# include <time.h>
+#endif
+
+void PDC_beep(void)
+{
+    PDC_LOG(("PDC_beep() - called\n"));
+}
+
+void PDC_napms(int ms)
+{
+    PDC_LOG(("PDC_napms() - called: ms=%d\n", ms));
+
+#ifdef _WIN32
+    Sleep(ms);
+#else
+    {
+        struct timespec nap;
+
+        nap.tv_sec = ms / 1000;
+        nap.tv_nsec = (ms % 1000) * 1000000L;
+        nanosleep(&nap, NULL);
+    }
+#endif
+}
+
+unsigned long PDC_get_ticks(void)
+{
+#ifdef _WIN32
+    LARGE_INTEGER freq, now;
+
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+
+    /* scale the whole seconds and the remainder separately, so that
+       the product can't overflow */
+
+    return (unsigned long)((now.QuadPart / freq.QuadPart) * 1000000 +
+        (now.QuadPart % freq.QuadPart) * 1000000 / freq.QuadPart);
+#else
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1000000UL + now.tv_nsec / 1000;
+#endif
+}
+
+const char *PDC_sysname(void)
+{
+    return "Offscreen";
+}
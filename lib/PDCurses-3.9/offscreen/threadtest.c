@@ -0,0 +1,202 @@
+/* Checks that, built with PDC_THREADS, threads can each open a screen
+   of their own with newterm() and draw on it at the same time as the
+   others, without seeing each other's cells, sizes or colors.
+
+   Each thread sizes its screen differently, fills it with its own
+   letter in its own color pair, and reads every cell back after each
+   refresh. Exits with 1 if any cell or any of the thread's curses
+   variables is wrong.
+
+   Built with TRACE=Y as well, each thread then turns on traceon()'s
+   ring and makes the same calls, which PDC_LOG() records at the same
+   time as the other threads'. Each thread's trace must hold the same
+   number of events, which it wouldn't if the rings were shared.
+
+   Build with "make THREADS=Y [TRACE=Y] threadtest"; it needs POSIX
+   threads.
+*/
+
+#include <curses.h>
+#include <pthread.h>
+#include <stdio.h>
+
+#ifndef PDC_THREADS
+# error threadtest needs PDC_THREADS; build with "make THREADS=Y"
+#endif
+
+#define THREADS 4
+#define ROUNDS  200
+#define TRACED  50      /* refreshes made with tracing on */
+
+/* You could #include pdcoff.h, or just add the relevant declaration
+   here: */
+
+PDCEX chtype PDC_offscreen_cell(int y, int x);
+
+typedef struct
+{
+    int id;
+    int failures;
+    unsigned long traced;   /* events in the thread's trace */
+} TESTER;
+
+#ifdef PDC_TRACE
+
+/* the threads share the file that traceoff() writes, so only one at a
+   time traces to it and reads it back */
+
+static pthread_mutex_t trace_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* the number of events recorded in trace.bin, which is the sixth word
+   of its header; see debug.c */
+
+static unsigned long _events_recorded(void)
+{
+    unsigned char header[24];
+    FILE *fp = fopen("trace.bin", "rb");
+    size_t got = fp ? fread(header, 1, sizeof(header), fp) : 0;
+
+    if (fp)
+        fclose(fp);
+
+    if (got != sizeof(header))
+        return 0;
+
+    return header[20] | ((unsigned long)header[21] << 8) |
+           ((unsigned long)header[22] << 16) |
+           ((unsigned long)header[23] << 24);
+}
+
+static void _trace(TESTER *t)
+{
+    int round;
+
+    /* the same size everywhere, as doupdate() logs by the line */
+
+    resize_term(10, 40);
+
+    pthread_mutex_lock(&trace_lock);
+    traceon();
+    pthread_mutex_unlock(&trace_lock);
+
+    /* these calls are logged while the other threads log theirs */
+
+    for (round = 0; round < TRACED; round++)
+    {
+        mvaddch(0, 0, (chtype)('0' + round % 10));
+        refresh();
+    }
+
+    pthread_mutex_lock(&trace_lock);
+    traceoff();
+    t->traced = _events_recorded();
+    pthread_mutex_unlock(&trace_lock);
+}
+
+#endif
+
+static int _check(TESTER *t, bool ok, const char *what, int round)
+{
+    if (!ok)
+    {
+        if (!t->failures)
+            fprintf(stderr, "thread %d, round %d: %s\n", t->id, round, what);
+
+        t->failures++;
+    }
+
+    return ok;
+}
+
+static void *_draw(void *arg)
+{
+    TESTER *t = arg;
+    SCREEN *screen;
+    int nlines = 10 + t->id, ncols = 40 + t->id * 3;
+    int round, y, x;
+
+    screen = newterm(NULL, stdout, stdin);
+
+    if (!_check(t, screen != NULL, "newterm() failed", 0))
+        return NULL;
+
+    _check(t, set_term(screen) == screen,
+           "set_term() refused the thread's own screen", 0);
+
+    resize_term(nlines, ncols);
+    start_color();
+    init_pair(1, (short)(1 + t->id % 7), COLOR_BLACK);
+
+    for (round = 0; round < ROUNDS && !t->failures; round++)
+    {
+        chtype ch = ('a' + t->id + round % 2 * ('A' - 'a')) | COLOR_PAIR(1);
+
+        for (y = 0; y < LINES; y++)
+            for (x = 0; x < COLS; x++)
+                mvaddch(y, x, ch);
+
+        refresh();
+
+        _check(t, SP == screen && LINES == nlines && COLS == ncols,
+               "the thread's screen or its size changed", round);
+
+        for (y = 0; y < nlines && !t->failures; y++)
+            for (x = 0; x < ncols; x++)
+                if (!_check(t, PDC_offscreen_cell(y, x) == ch,
+                            "a cell doesn't hold the thread's letter", round))
+                    break;
+    }
+
+#ifdef PDC_TRACE
+    if (!t->failures)
+        _trace(t);
+#endif
+
+    endwin();
+    delscreen(screen);
+
+    return NULL;
+}
+
+int main(void)
+{
+    pthread_t threads[THREADS];
+    TESTER testers[THREADS];
+    int i, failures = 0;
+
+    for (i = 0; i < THREADS; i++)
+    {
+        testers[i].id = i;
+        testers[i].failures = 0;
+        testers[i].traced = 0;
+
+        if (pthread_create(threads + i, NULL, _draw, testers + i))
+        {
+            fprintf(stderr, "can't start thread %d\n", i);
+            return 1;
+        }
+    }
+
+    for (i = 0; i < THREADS; i++)
+    {
+        pthread_join(threads[i], NULL);
+        failures += testers[i].failures;
+    }
+
+#ifdef PDC_TRACE
+    for (i = 0; i < THREADS; i++)
+        if (!testers[i].traced || testers[i].traced != testers[0].traced)
+        {
+            fprintf(stderr, "thread %d traced %lu events, thread 0 %lu\n",
+                    i, testers[i].traced, testers[0].traced);
+            failures++;
+        }
+
+    remove("trace.bin");
+#endif
+
+    printf("%d threads, %d rounds each: %s\n", THREADS, ROUNDS,
+           failures ? "FAILED" : "OK");
+
+    return failures ? 1 : 0;
+}
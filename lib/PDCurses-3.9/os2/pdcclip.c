@@ -76,7 +76,7 @@ int PDC_getclipboard(char **contents, long *length)
     if (ulRet)
     {
         len = strlen((char *)ulRet);
-        *contents = malloc(len + 1);
+        *contents = PDC_malloc(len + 1);
 
         if (!*contents)
             rc = PDC_CLIP_MEMORY_ERROR;
@@ -146,7 +146,7 @@ int PDC_freeclipboard(char *contents)
     PDC_LOG(("PDC_freeclipboard() - called\n"));
 
     if (contents)
-        free(contents);
+        PDC_free(contents);
 
     return PDC_CLIP_SUCCESS;
 }
@@ -188,7 +188,8 @@ static int _process_mouse_events(void)
             SP->mouse_status.button[i] = BUTTON_PRESSED;
         }
 
-        if (SP->mouse_status.button[i] == BUTTON_PRESSED && SP->mouse_wait)
+        if (SP->mouse_status.button[i] == BUTTON_PRESSED &&
+            PDC_click_wanted(i))
         {
             /* Check for a click -- a PRESS followed immediately by a
                release */
@@ -276,6 +277,21 @@ static int _process_mouse_events(void)
     return KEY_MOUSE;
 }
 
+/* no way to sleep on input here, so nap in short steps and let
+   wgetch() check again */
+
+int PDC_wait_input(int ms)
+{
+    PDC_LOG(("PDC_wait_input() - called: ms=%d\n", ms));
+
+    if (ms < 0 || ms > 50)
+        ms = 50;
+
+    napms(ms);
+
+    return ms;
+}
+
 /* return the next available key or mouse event */
 
 int PDC_get_key(void)
@@ -284,6 +300,7 @@ int PDC_get_key(void)
     KBDKEYINFO keyInfo = {0};
 
     SP->key_modifiers = 0L;
+    SP->key_time = PDC_get_ticks();
 
     if (mouse_handle && mouse_events)
         return _process_mouse_events();
@@ -67,7 +67,7 @@ void PDC_scr_close(void)
         VioWrtCellStr(saved_screen, saved_lines * saved_cols * 2,
             0, 0, (HVIO)NULL);
 
-        free(saved_screen);
+        PDC_free(saved_screen);
         saved_screen = NULL;
     }
 
@@ -84,7 +84,7 @@ void PDC_scr_close(void)
 void PDC_scr_free(void)
 {
     if (SP)
-        free(SP);
+        PDC_free(SP);
 }
 
 /* open the physical screen -- allocate SP, miscellaneous intialization,
@@ -97,7 +97,7 @@ int PDC_scr_open(int argc, char **argv)
 
     PDC_LOG(("PDC_scr_open() - called\n"));
 
-    SP = calloc(1, sizeof(SCREEN));
+    SP = PDC_calloc(1, sizeof(SCREEN));
 
     if (!SP)
         return ERR;
@@ -126,7 +126,7 @@ int PDC_scr_open(int argc, char **argv)
         saved_lines = SP->lines;
         saved_cols = SP->cols;
 
-        saved_screen = malloc(2 * saved_lines * saved_cols);
+        saved_screen = PDC_malloc(2 * saved_lines * saved_cols);
 
         if (!saved_screen)
         {
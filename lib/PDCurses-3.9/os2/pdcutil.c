@@ -32,6 +32,11 @@ void PDC_napms(int ms)
     DosSleep(ms);
 }
 
+unsigned long PDC_get_ticks(void)
+{
+    return PDC_ms_count() * 1000UL;
+}
+
 const char *PDC_sysname(void)
 {
     return "OS/2";
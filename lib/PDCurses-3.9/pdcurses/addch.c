@@ -228,14 +228,7 @@ int waddch(WINDOW *win, const chtype ch)
 
         if (win->_y[y][x] != text)
         {
-            if (win->_firstch[y] == _NO_CHANGE)
-                win->_firstch[y] = win->_lastch[y] = x;
-            else
-                if (x < win->_firstch[y])
-                    win->_firstch[y] = x;
-                else
-                    if (x > win->_lastch[y])
-                        win->_lastch[y] = x;
+            PDC_mark_changed(win, y, x, x);
 
             win->_y[y][x] = text;
         }
@@ -69,7 +69,7 @@ addchstr
 
 int waddchnstr(WINDOW *win, const chtype *ch, int n)
 {
-    int y, x, maxx, minx;
+    int y, x, minx = _NO_CHANGE, maxx = _NO_CHANGE;
     chtype *ptr;
 
     PDC_LOG(("waddchnstr() - called: win=%p n=%d\n", win, n));
@@ -84,18 +84,14 @@ int waddchnstr(WINDOW *win, const chtype *ch, int n)
     if (n == -1 || n > win->_maxx - x)
         n = win->_maxx - x;
 
-    minx = win->_firstch[y];
-    maxx = win->_lastch[y];
-
     for (; n && *ch; n--, x++, ptr++, ch++)
     {
         if (*ptr != *ch)
         {
-            if (x < minx || minx == _NO_CHANGE)
+            if (minx == _NO_CHANGE)
                 minx = x;
 
-            if (x > maxx)
-                maxx = x;
+            maxx = x;
 
             PDC_LOG(("y %d x %d minx %d maxx %d *ptr %x *ch"
                      " %x firstch: %d lastch: %d\n",
@@ -106,8 +102,8 @@ int waddchnstr(WINDOW *win, const chtype *ch, int n)
         }
     }
 
-    win->_firstch[y] = minx;
-    win->_lastch[y] = maxx;
+    if (minx != _NO_CHANGE)
+        PDC_mark_changed(win, y, minx, maxx);
 
     return OK;
 }
@@ -0,0 +1,330 @@
+/* PDCurses */
+
+#include <curspriv.h>
+
+/*man-start**************************************************************
+
+alloc
+-----
+
+### Synopsis
+
+    int PDC_set_allocator(PDC_ALLOCATOR *allocator);
+    PDC_ALLOCATOR *PDC_get_allocator(void);
+
+    PDC_ALLOCATOR *PDC_arena_init(PDC_ARENA *arena, void *buf,
+                                  size_t size);
+    void PDC_arena_reset(PDC_ARENA *arena);
+
+### Description
+
+   Everything PDCurses allocates -- the SCREEN structure, windows,
+   pads, panels, soft label keys, sprites and, on the ports that copy
+   it, clipboard text -- is obtained from the current allocator. By
+   default that is the C library heap.
+
+   PDC_set_allocator() makes allocator current. Its alloc(), resize()
+   and release() functions are called with its ctx pointer, and (for
+   resize() and release()) the size of the block as it was last
+   allocated. Pass NULL to go back to the heap. The allocator should
+   normally be set before initscr(), but it may be changed at any time:
+   each block remembers the allocator it came from and is always resized
+   and released through it, so the structure must outlive every block
+   allocated from it.
+
+   PDCurses maintains the stats member of each allocator: the number of
+   allocations, releases and failures, and the bytes currently
+   allocated, at their peak and in total. An application can sample the
+   counters of the allocator returned by PDC_get_allocator() around a
+   frame to check that drawing it did not allocate; the counters may be
+   cleared by the application at any time.
+
+   With PDC_THREADS, each thread has its own current allocator, and its
+   own heap allocator with its own counters; a block from the heap must
+   then be released before the thread that allocated it ends.
+
+   PDC_arena_init() sets up a bump allocator in the size bytes at buf,
+   and returns the allocator to pass to PDC_set_allocator(). Allocation
+   is a pointer increment; releasing or growing the most recent block
+   is done in place, and other releases are ignored until
+   PDC_arena_reset() makes the whole buffer available again. This suits
+   short-lived windows, such as overlays and banners, that are all
+   deleted at the same time. Resetting an arena that still has live
+   blocks in it is an error.
+
+### Return Value
+
+   PDC_set_allocator() returns OK, or ERR if the allocator is missing
+   any of its functions. PDC_arena_init() returns NULL if arena is NULL.
+
+### Portability
+                             X/Open  ncurses  NetBSD
+    PDC_set_allocator           -       -       -
+    PDC_get_allocator           -       -       -
+    PDC_arena_init              -       -       -
+    PDC_arena_reset             -       -       -
+
+**man-end****************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+/* Every block is preceded by this header, which records where it came
+   from and how big it is; the union keeps the block that follows
+   suitably aligned for any type */
+
+typedef union
+{
+    struct
+    {
+        PDC_ALLOCATOR *allocator;
+        size_t size;
+    } h;
+    double d;
+    long l;
+    void *p;
+} ALLOCHDR;
+
+static void *_heap_alloc(void *ctx, size_t size)
+{
+    return malloc(size);
+}
+
+static void *_heap_resize(void *ctx, void *ptr, size_t oldsize, size_t size)
+{
+    return realloc(ptr, size);
+}
+
+static void _heap_release(void *ctx, void *ptr, size_t size)
+{
+    free(ptr);
+}
+
+static PDC_TLS PDC_ALLOCATOR _heap = {_heap_alloc, _heap_resize,
+                                      _heap_release};
+
+/* NULL when it's _heap, whose address isn't a constant with
+   PDC_THREADS */
+
+static PDC_TLS PDC_ALLOCATOR *_allocator = NULL;
+
+static void _count(PDC_ALLOCATOR *allocator, size_t oldsize, size_t size)
+{
+    PDC_ALLOC_STATS *stats = &allocator->stats;
+
+    stats->allocs++;
+    stats->bytes += size - oldsize;
+    stats->total += size;
+
+    if (stats->bytes > stats->peak)
+        stats->peak = stats->bytes;
+}
+
+void *PDC_malloc(size_t size)
+{
+    PDC_ALLOCATOR *allocator = _allocator ? _allocator : &_heap;
+    ALLOCHDR *hdr;
+
+    hdr = allocator->alloc(allocator->ctx, sizeof(ALLOCHDR) + size);
+    if (!hdr)
+    {
+        allocator->stats.failures++;
+        return NULL;
+    }
+
+    hdr->h.allocator = allocator;
+    hdr->h.size = size;
+
+    _count(allocator, 0, size);
+
+    return hdr + 1;
+}
+
+void *PDC_calloc(size_t nmemb, size_t size)
+{
+    void *ptr;
+
+    if (size && nmemb > (size_t)-1 / size)
+        return NULL;
+
+    ptr = PDC_malloc(nmemb * size);
+    if (ptr)
+        memset(ptr, 0, nmemb * size);
+
+    return ptr;
+}
+
+void *PDC_realloc(void *ptr, size_t size)
+{
+    PDC_ALLOCATOR *allocator;
+    ALLOCHDR *hdr;
+    size_t oldsize;
+
+    if (!ptr)
+        return PDC_malloc(size);
+
+    hdr = (ALLOCHDR *)ptr - 1;
+    allocator = hdr->h.allocator;
+    oldsize = hdr->h.size;
+
+    hdr = allocator->resize(allocator->ctx, hdr, sizeof(ALLOCHDR) + oldsize,
+                            sizeof(ALLOCHDR) + size);
+    if (!hdr)
+    {
+        allocator->stats.failures++;
+        return NULL;
+    }
+
+    hdr->h.size = size;
+
+    _count(allocator, oldsize, size);
+
+    return hdr + 1;
+}
+
+void PDC_free(void *ptr)
+{
+    PDC_ALLOCATOR *allocator;
+    ALLOCHDR *hdr;
+
+    if (!ptr)
+        return;
+
+    hdr = (ALLOCHDR *)ptr - 1;
+    allocator = hdr->h.allocator;
+
+    allocator->stats.frees++;
+    allocator->stats.bytes -= hdr->h.size;
+
+    allocator->release(allocator->ctx, hdr, sizeof(ALLOCHDR) + hdr->h.size);
+}
+
+int PDC_set_allocator(PDC_ALLOCATOR *allocator)
+{
+    PDC_LOG(("PDC_set_allocator() - called: allocator=%p\n", allocator));
+
+    if (allocator && (!allocator->alloc || !allocator->resize ||
+        !allocator->release))
+        return ERR;
+
+    _allocator = allocator;
+
+    return OK;
+}
+
+PDC_ALLOCATOR *PDC_get_allocator(void)
+{
+    PDC_LOG(("PDC_get_allocator() - called\n"));
+
+    return _allocator ? _allocator : &_heap;
+}
+
+/* Arena blocks are rounded up to the header size, so that every block,
+   and therefore the header in front of it, stays aligned */
+
+static size_t _arena_round(size_t size)
+{
+    return (size + sizeof(ALLOCHDR) - 1) / sizeof(ALLOCHDR) *
+           sizeof(ALLOCHDR);
+}
+
+static bool _arena_is_last(PDC_ARENA *arena, void *ptr, size_t size)
+{
+    return ptr == arena->_base + arena->_last &&
+           arena->_last + _arena_round(size) == arena->_used;
+}
+
+static void *_arena_alloc(void *ctx, size_t size)
+{
+    PDC_ARENA *arena = ctx;
+    void *ptr;
+
+    size = _arena_round(size);
+    if (size > arena->_size - arena->_used)
+        return NULL;
+
+    ptr = arena->_base + arena->_used;
+    arena->_last = arena->_used;
+    arena->_used += size;
+
+    return ptr;
+}
+
+static void *_arena_resize(void *ctx, void *ptr, size_t oldsize, size_t size)
+{
+    PDC_ARENA *arena = ctx;
+    void *newptr;
+
+    /* the most recent block can grow or shrink where it is */
+
+    if (_arena_is_last(arena, ptr, oldsize))
+    {
+        if (_arena_round(size) > arena->_size - arena->_last)
+            return NULL;
+
+        arena->_used = arena->_last + _arena_round(size);
+
+        return ptr;
+    }
+
+    newptr = _arena_alloc(ctx, size);
+    if (newptr)
+        memcpy(newptr, ptr, min(oldsize, size));
+
+    return newptr;
+}
+
+static void _arena_release(void *ctx, void *ptr, size_t size)
+{
+    PDC_ARENA *arena = ctx;
+
+    /* only the most recent block can be given back before a reset */
+
+    if (_arena_is_last(arena, ptr, size))
+    {
+        arena->_used = arena->_last;
+        arena->_last = arena->_size;
+    }
+}
+
+PDC_ALLOCATOR *PDC_arena_init(PDC_ARENA *arena, void *buf, size_t size)
+{
+    size_t skip;
+
+    PDC_LOG(("PDC_arena_init() - called: size=%lu\n", (unsigned long)size));
+
+    if (!arena)
+        return NULL;
+
+    memset(arena, 0, sizeof(PDC_ARENA));
+
+    skip = (sizeof(ALLOCHDR) - (size_t)buf % sizeof(ALLOCHDR)) %
+           sizeof(ALLOCHDR);
+
+    if (buf && size > skip)
+    {
+        arena->_base = (unsigned char *)buf + skip;
+        arena->_size = (size - skip) / sizeof(ALLOCHDR) * sizeof(ALLOCHDR);
+    }
+
+    arena->_last = arena->_size;
+
+    arena->_allocator.alloc = _arena_alloc;
+    arena->_allocator.resize = _arena_resize;
+    arena->_allocator.release = _arena_release;
+    arena->_allocator.ctx = arena;
+
+    return &arena->_allocator;
+}
+
+void PDC_arena_reset(PDC_ARENA *arena)
+{
+    PDC_LOG(("PDC_arena_reset() - called\n"));
+
+    if (!arena)
+        return;
+
+    arena->_used = 0;
+    arena->_last = arena->_size;
+    arena->_allocator.stats.bytes = 0;
+}
@@ -174,10 +174,7 @@ int wborder(WINDOW *win, chtype ls, chtype rs, chtype ts, chtype bs,
     win->_y[ymax][xmax] = br;
 
     for (i = 0; i <= ymax; i++)
-    {
-        win->_firstch[i] = 0;
-        win->_lastch[i] = xmax;
-    }
+        PDC_mark_changed(win, i, 0, xmax);
 
     PDC_sync(win);
 
@@ -217,13 +214,7 @@ int whline(WINDOW *win, chtype ch, int n)
     for (n = startpos; n <= endpos; n++)
         dest[n] = ch;
 
-    n = win->_cury;
-
-    if (startpos < win->_firstch[n] || win->_firstch[n] == _NO_CHANGE)
-        win->_firstch[n] = startpos;
-
-    if (endpos > win->_lastch[n])
-        win->_lastch[n] = endpos;
+    PDC_mark_changed(win, win->_cury, startpos, endpos);
 
     PDC_sync(win);
 
@@ -274,12 +265,7 @@ int wvline(WINDOW *win, chtype ch, int n)
     for (n = win->_cury; n < endpos; n++)
     {
         win->_y[n][x] = ch;
-
-        if (x < win->_firstch[n] || win->_firstch[n] == _NO_CHANGE)
-            win->_firstch[n] = x;
-
-        if (x > win->_lastch[n])
-            win->_lastch[n] = x;
+        PDC_mark_changed(win, n, x, x);
     }
 
     PDC_sync(win);
@@ -98,14 +98,14 @@ color
 #include <stdlib.h>
 #include <string.h>
 
-int COLORS = 0;
-int COLOR_PAIRS = PDC_COLOR_PAIRS;
+PDC_TLS int COLORS = 0;
+PDC_TLS int COLOR_PAIRS = PDC_COLOR_PAIRS;
 
 /* pair_set[] tracks whether a pair has been set via init_pair() */
 
-static bool pair_set[PDC_COLOR_PAIRS];
-static bool default_colors = FALSE;
-static short first_col = 0;
+static PDC_TLS bool pair_set[PDC_COLOR_PAIRS];
+static PDC_TLS bool default_colors = FALSE;
+static PDC_TLS short first_col = 0;
 
 int start_color(void)
 {
@@ -12,6 +12,7 @@ debug
     void traceon(void);
     void traceoff(void);
     void PDC_debug(const char *, ...);
+    int PDC_set_trace_hook(PDC_TRACE_HOOK hook);
 
 ### Description
 
@@ -26,11 +27,57 @@ debug
    file contents are fflushed after each write. The default is not. Set
    it to enable this (may affect performance).
 
+   Formatting every call is slow enough to change how a program behaves.
+   If the environment variable PDC_TRACE_RING is set to a number of
+   events when traceon() is called, the calls are instead recorded in a
+   ring of that many events in memory, each holding the time from
+   PDC_get_ticks(), the format string and the first six numbers passed
+   with it, pointers whole; strings aren't kept. traceoff() writes the
+   ring, oldest event first, to the file "trace.bin", replacing any
+   earlier one. common/tracedump.c is a program that prints such a file
+   the way the text trace would read. It builds on its own, without
+   PDCurses.
+
+   PDCurses only logs its calls in builds with PDCDEBUG defined, or with
+   PDC_TRACE defined ("TRACE=Y" with the GNU makefiles). A PDC_TRACE
+   build is otherwise optimized as usual, and only records to the ring,
+   so that tracing can be left built in and turned on where it's
+   needed; its traceon() uses a ring of 4096 events if PDC_TRACE_RING
+   isn't set.
+
+   With PDC_THREADS, tracing is turned on for the calling thread's
+   screen, and each thread records into a ring of its own. The threads
+   share the file names, so their calls to traceon() and traceoff()
+   shouldn't overlap, and trace.bin should be moved away after each
+   traceoff().
+
+   PDC_set_trace_hook() installs a function that is called at the end
+   of each span of PDCurses' work that is worth timing, for instance to
+   write a trace that can be viewed alongside the program's own. Unlike
+   traceon(), it works in all builds. The hook is passed the kind of
+   span, its start and end times from PDC_get_ticks(), and two figures:
+
+   - PDC_SPAN_WNOUTREFRESH: the lines and cells copied to curscr
+   - PDC_SPAN_DOUPDATE: the runs and cells sent to the port
+   - PDC_SPAN_TRANSFORM_LINE: the line, and the cells sent in one call
+     to PDC_transform_line(); these spans fall within doupdate()
+   - PDC_SPAN_UPDATE_RECTS: the rectangles that the SDL ports present
+     at once; the second figure is 0
+
+   Passing NULL removes the hook. The clock isn't read at all while
+   there's none.
+
+### Return Value
+
+   PDC_set_trace_hook() returns ERR if the screen hasn't been
+   initialized, and OK otherwise.
+
 ### Portability
                              X/Open  ncurses  NetBSD
     traceon                     -       -       -
     traceoff                    -       -       -
     PDC_debug                   -       -       -
+    PDC_set_trace_hook          -       -       -
 
 **man-end****************************************************************/
 
@@ -39,7 +86,181 @@ debug
 #include <sys/types.h>
 #include <time.h>
 
-static bool want_fflush = FALSE;
+/* The binary trace file holds 32-bit little-endian words: a header of
+   "PDCT", the version, TRACE_ARGS, the size in bytes of an argument as
+   recorded, the number of formats, the number of events recorded and
+   the number kept; then each format, as its length and its bytes; then
+   each event kept, as its time, its format (or 0xffffffff if the table
+   was full), the number of arguments and TRACE_ARGS arguments. Each
+   argument takes two words, low word first, so that pointers are kept
+   whole; signed numbers are sign-extended to the size of an argument. */
+
+#define TRACE_VERSION 2
+#define TRACE_ARGS 6        /* numbers kept per event */
+#define TRACE_FORMATS 1024  /* distinct formats; a power of two */
+#define TRACE_DEFAULT 4096  /* events in the ring of a PDC_TRACE build */
+
+typedef struct
+{
+    unsigned long ticks;
+    int format;             /* index into formats, or -1 */
+    int nargs;
+    size_t args[TRACE_ARGS];  /* wide enough for a pointer or a long */
+} TRACE_EVENT;
+
+/* Tracing is turned on for the current screen, so with PDC_THREADS each
+   thread has its own ring and format table. */
+
+static PDC_TLS bool want_fflush = FALSE;
+
+static PDC_TLS TRACE_EVENT *ring = NULL;
+static PDC_TLS unsigned long ringsize = 0;
+static PDC_TLS unsigned long recorded = 0;
+
+/* formats are told apart by address, through a hash of it into
+   format_slot, which holds an index into formats plus one */
+
+static PDC_TLS const char *formats[TRACE_FORMATS];
+static PDC_TLS int nformats = 0;
+static PDC_TLS short format_slot[TRACE_FORMATS];
+
+static int _format_index(const char *fmt)
+{
+    unsigned long slot = ((unsigned long)fmt >> 2) & (TRACE_FORMATS - 1);
+
+    while (format_slot[slot])
+    {
+        if (formats[format_slot[slot] - 1] == fmt)
+            return format_slot[slot] - 1;
+
+        slot = (slot + 1) & (TRACE_FORMATS - 1);
+    }
+
+    /* keep one slot free, so that the search above always ends */
+
+    if (nformats == TRACE_FORMATS - 1)
+        return -1;
+
+    formats[nformats] = fmt;
+    format_slot[slot] = (short)++nformats;
+
+    return nformats - 1;
+}
+
+/* take the numbers for each conversion in fmt from args, in the way
+   vfprintf() would */
+
+static void _record(const char *fmt, va_list args)
+{
+    TRACE_EVENT *ev = ring + recorded++ % ringsize;
+    const char *p = fmt;
+
+    ev->ticks = PDC_get_ticks();
+    ev->format = _format_index(fmt);
+    ev->nargs = 0;
+
+    while (ev->nargs < TRACE_ARGS && (p = strchr(p, '%')) != NULL)
+    {
+        bool islong = FALSE;
+
+        p++;
+
+        if (*p == '%')
+        {
+            p++;
+            continue;
+        }
+
+        while (*p && strchr("-+ #0123456789.", *p))
+            p++;
+
+        while (*p == 'l' || *p == 'h')
+            islong |= (*p++ == 'l');
+
+        switch (*p)
+        {
+        case 'd':
+        case 'i':
+        case 'c':
+            ev->args[ev->nargs++] = islong ? (size_t)va_arg(args, long) :
+                                             (size_t)va_arg(args, int);
+            break;
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X':
+            ev->args[ev->nargs++] = islong ?
+                (size_t)va_arg(args, unsigned long) :
+                (size_t)va_arg(args, unsigned int);
+            break;
+        case 'p':
+            ev->args[ev->nargs++] = (size_t)va_arg(args, void *);
+            break;
+        case 's':
+            (void)va_arg(args, const char *);
+            ev->args[ev->nargs++] = 0;
+            break;
+        default:            /* nothing else is used in PDC_LOG() */
+            return;
+        }
+
+        p++;
+    }
+}
+
+static void _put_word(FILE *fp, unsigned long word)
+{
+    unsigned char bytes[4];
+
+    bytes[0] = (unsigned char)word;
+    bytes[1] = (unsigned char)(word >> 8);
+    bytes[2] = (unsigned char)(word >> 16);
+    bytes[3] = (unsigned char)(word >> 24);
+
+    fwrite(bytes, 4, 1, fp);
+}
+
+static void _write_ring(FILE *fp)
+{
+    unsigned long kept = min(recorded, ringsize);
+    unsigned long i;
+    int j;
+
+    fwrite("PDCT", 4, 1, fp);
+    _put_word(fp, TRACE_VERSION);
+    _put_word(fp, TRACE_ARGS);
+    _put_word(fp, sizeof(size_t));
+    _put_word(fp, nformats);
+    _put_word(fp, recorded);
+    _put_word(fp, kept);
+
+    for (j = 0; j < nformats; j++)
+    {
+        size_t len = strlen(formats[j]);
+
+        _put_word(fp, len);
+        fwrite(formats[j], len, 1, fp);
+    }
+
+    for (i = recorded - kept; i < recorded; i++)
+    {
+        TRACE_EVENT *ev = ring + i % ringsize;
+
+        _put_word(fp, ev->ticks);
+        _put_word(fp, (unsigned long)ev->format);
+        _put_word(fp, ev->nargs);
+
+        for (j = 0; j < TRACE_ARGS; j++)
+        {
+            size_t arg = j < ev->nargs ? ev->args[j] : 0;
+
+            /* shifted in two steps, as size_t may be 32 bits */
+
+            _put_word(fp, (unsigned long)arg);
+            _put_word(fp, (unsigned long)(arg >> 16 >> 16));
+        }
+    }
+}
 
 void PDC_debug(const char *fmt, ...)
 {
@@ -50,6 +271,15 @@ void PDC_debug(const char *fmt, ...)
     if (!SP || !SP->dbfp)
         return;
 
+    if (ring)
+    {
+        va_start(args, fmt);
+        _record(fmt, args);
+        va_end(args);
+
+        return;
+    }
+
     time(&now);
     strftime(hms, 9, "%H:%M:%S", localtime(&now));
     fprintf(SP->dbfp, "At: %8.8ld - %s ", (long) clock(), hms);
@@ -73,17 +303,48 @@ void PDC_debug(const char *fmt, ...)
 
 void traceon(void)
 {
+    char *events;
+    long size;
+
     if (!SP)
         return;
 
     if (SP->dbfp)
-        fclose(SP->dbfp);
+        traceoff();
+
+    events = getenv("PDC_TRACE_RING");
+    size = events ? atol(events) : 0;
+
+#if defined(PDC_TRACE) && !defined(PDCDEBUG)
+    /* PDC_TRACE builds only record to the ring */
+
+    if (size <= 0)
+        size = TRACE_DEFAULT;
+#endif
+
+    if (size > 0)
+    {
+        ringsize = (unsigned long)size;
+        ring = PDC_malloc(ringsize * sizeof(TRACE_EVENT));
+        recorded = 0;
+
+        if (!ring)
+        {
+            fprintf(stderr, "PDC_debug(): Unable to allocate trace ring\n");
+            return;
+        }
+
+        /* open the file now, so that PDC_LOG() sees tracing is on */
+        SP->dbfp = fopen("trace.bin", "wb");
+    }
+    else    /* open debug log file append */
+        SP->dbfp = fopen("trace", "a");
 
-    /* open debug log file append */
-    SP->dbfp = fopen("trace", "a");
     if (!SP->dbfp)
     {
         fprintf(stderr, "PDC_debug(): Unable to open debug log file\n");
+        PDC_free(ring);
+        ring = NULL;
         return;
     }
 
@@ -100,7 +361,27 @@ void traceoff(void)
 
     PDC_LOG(("traceoff() - called\n"));
 
+    if (ring)
+    {
+        _write_ring(SP->dbfp);
+
+        PDC_free(ring);
+        ring = NULL;
+    }
+
     fclose(SP->dbfp);
     SP->dbfp = NULL;
     want_fflush = FALSE;
 }
+
+int PDC_set_trace_hook(PDC_TRACE_HOOK hook)
+{
+    PDC_LOG(("PDC_set_trace_hook() - called\n"));
+
+    if (!SP)
+        return ERR;
+
+    SP->trace_hook = hook;
+
+    return OK;
+}
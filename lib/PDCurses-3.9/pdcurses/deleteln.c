@@ -72,8 +72,7 @@ int wdeleteln(WINDOW *win)
     for (y = win->_cury; y < win->_bmarg; y++)
     {
         win->_y[y] = win->_y[y + 1];
-        win->_firstch[y] = 0;
-        win->_lastch[y] = win->_maxx - 1;
+        PDC_mark_changed(win, y, 0, win->_maxx - 1);
     }
 
     for (ptr = temp; (ptr - temp < win->_maxx); ptr++)
@@ -81,8 +80,7 @@ int wdeleteln(WINDOW *win)
 
     if (win->_cury <= win->_bmarg)
     {
-        win->_firstch[win->_bmarg] = 0;
-        win->_lastch[win->_bmarg] = win->_maxx - 1;
+        PDC_mark_changed(win, win->_bmarg, 0, win->_maxx - 1);
         win->_y[win->_bmarg] = temp;
     }
 
@@ -168,8 +166,7 @@ int winsertln(WINDOW *win)
     for (y = win->_maxy - 1; y > win->_cury; y--)
     {
         win->_y[y] = win->_y[y - 1];
-        win->_firstch[y] = 0;
-        win->_lastch[y] = win->_maxx - 1;
+        PDC_mark_changed(win, y, 0, win->_maxx - 1);
     }
 
     win->_y[win->_cury] = temp;
@@ -177,8 +174,7 @@ int winsertln(WINDOW *win)
     for (end = &temp[win->_maxx - 1]; temp <= end; temp++)
         *temp = blank;
 
-    win->_firstch[win->_cury] = 0;
-    win->_lastch[win->_cury] = win->_maxx - 1;
+    PDC_mark_changed(win, win->_cury, 0, win->_maxx - 1);
 
     return OK;
 }
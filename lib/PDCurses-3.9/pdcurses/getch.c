@@ -96,10 +96,12 @@ getch
 #define _INBUFSIZ   512 /* size of terminal input buffer */
 #define NUNGETCH    256 /* max # chars to ungetch() */
 
-static int c_pindex = 0;    /* putter index */
-static int c_gindex = 1;    /* getter index */
-static int c_ungind = 0;    /* ungetch() push index */
-static int c_ungch[NUNGETCH];   /* array of ungotten chars */
+static PDC_TLS int c_pindex = 0;    /* putter index */
+static PDC_TLS int c_gindex = 1;    /* getter index */
+static PDC_TLS int c_ungind = 0;    /* ungetch() push index */
+static PDC_TLS int c_ungch[NUNGETCH];   /* array of ungotten chars */
+static PDC_TLS int c_heldkey = -1;  /* key read by PDC_drain_mouse() */
+static PDC_TLS bool c_heldcode;     /* its SP->key_code */
 
 static int _get_box(int *y_start, int *y_end, int *x_start, int *x_end)
 {
@@ -165,10 +167,10 @@ static void _copy(void)
         return;
 
 #ifdef PDC_WIDE
-    wtmp = malloc((len + 1) * sizeof(wchar_t));
+    wtmp = PDC_malloc((len + 1) * sizeof(wchar_t));
     len *= 3;
 #endif
-    tmp = malloc(len + 1);
+    tmp = PDC_malloc(len + 1);
 
     for (j = y_start, pos = 0; j <= y_end; j++)
     {
@@ -189,9 +191,9 @@ static void _copy(void)
 #endif
 
     PDC_setclipboard(tmp, pos);
-    free(tmp);
+    PDC_free(tmp);
 #ifdef PDC_WIDE
-    free(wtmp);
+    PDC_free(wtmp);
 #endif
 }
 
@@ -212,14 +214,14 @@ static int _paste(void)
         return -1;
 
 #ifdef PDC_WIDE
-    wpaste = malloc(len * sizeof(wchar_t));
+    wpaste = PDC_malloc(len * sizeof(wchar_t));
     len = PDC_mbstowcs(wpaste, paste, len);
 #endif
     while (len > 1)
         PDC_ungetch(PASTE[--len]);
     key = *PASTE;
 #ifdef PDC_WIDE
-    free(wpaste);
+    PDC_free(wpaste);
 #endif
     PDC_freeclipboard(paste);
     SP->key_modifiers = 0;
@@ -232,6 +234,15 @@ static int _mouse_key(void)
     int i, key = KEY_MOUSE, changes = SP->mouse_status.changes;
     unsigned long mbe = SP->_trap_mbe;
 
+    /* Track the pointer, trapped or not (wheel events have no
+       position) */
+
+    if (SP->mouse_status.y >= 0)
+    {
+        SP->pointer_y = SP->mouse_status.y;
+        SP->pointer_x = SP->mouse_status.x;
+    }
+
     /* Selection highlighting? */
 
     if ((!mbe || SP->mouse_status.button[0] & BUTTON_SHIFT) && changes & 1)
@@ -295,6 +306,12 @@ static int _mouse_key(void)
             SP->mouse_status.changes ^= PDC_MOUSE_MOVED;
     }
 
+    if (changes & PDC_MOUSE_POSITION)
+    {
+        if (!(mbe & REPORT_MOUSE_POSITION))
+            SP->mouse_status.changes ^= PDC_MOUSE_POSITION;
+    }
+
     if (changes & (PDC_MOUSE_WHEEL_UP|PDC_MOUSE_WHEEL_DOWN))
     {
         if (!(mbe & MOUSE_WHEEL_SCROLL))
@@ -302,7 +319,9 @@ static int _mouse_key(void)
                 ~(PDC_MOUSE_WHEEL_UP|PDC_MOUSE_WHEEL_DOWN);
     }
 
-    if (!changes)
+    /* nothing left after filtering? */
+
+    if (!SP->mouse_status.changes)
         return -1;
 
     /* Check for click in slk area */
@@ -322,30 +341,22 @@ static int _mouse_key(void)
 
 int wgetch(WINDOW *win)
 {
-    static int buffer[_INBUFSIZ];   /* character buffer */
-    int key, waitcount;
+    static PDC_TLS int buffer[_INBUFSIZ];   /* character buffer */
+    int key, remaining, waited;
 
     PDC_LOG(("wgetch() - called\n"));
 
     if (!win || !SP)
         return ERR;
 
-    waitcount = 0;
-
-    /* set the number of 1/20th second napms() calls */
+    /* how long to wait for input, in milliseconds; -1 is forever */
 
     if (SP->delaytenths)
-        waitcount = 2 * SP->delaytenths;
+        remaining = 100 * SP->delaytenths;
+    else if (win->_delayms)
+        remaining = win->_delayms;
     else
-        if (win->_delayms)
-        {
-            /* Can't really do millisecond intervals, so delay in
-               1/20ths of a second (50ms) */
-
-            waitcount = win->_delayms / 50;
-            if (!waitcount)
-                waitcount = 1;
-        }
+        remaining = win->_nodelay ? 0 : -1;
 
     /* refresh window when wgetch is called if there have been changes
        to it and it is not a pad */
@@ -374,30 +385,42 @@ int wgetch(WINDOW *win)
 
     for (;;)            /* loop for any buffering */
     {
-        /* is there a keystroke ready? */
+        /* a key held back by PDC_drain_mouse() comes first; otherwise,
+           is there a keystroke ready? */
 
-        if (!PDC_check_key())
+        if (c_heldkey != -1)
         {
-            /* if not, handle timeout() and halfdelay() */
+            key = c_heldkey;
+            SP->key_code = c_heldcode;
+            c_heldkey = -1;
+        }
+        else if (!PDC_check_key())
+        {
+            /* a mouse event that was queued while more input was
+               waiting is announced now */
 
-            if (SP->delaytenths || win->_delayms)
+            if (PDC_mouse_unseen())
             {
-                if (!waitcount)
-                    return ERR;
-
-                waitcount--;
+                SP->key_code = TRUE;
+                return KEY_MOUSE;
             }
-            else
-                if (win->_nodelay)
-                    return ERR;
 
-            napms(50);  /* sleep for 1/20th second */
-            continue;   /* then check again */
-        }
+            /* if not, handle nodelay(), timeout() and halfdelay() */
 
-        /* if there is, fetch it */
+            if (!remaining)
+                return ERR;
 
-        key = PDC_get_key();
+            /* block until there may be input, or the time is up */
+
+            waited = PDC_wait_input(remaining);
+
+            if (remaining > 0)
+                remaining = max(0, remaining - waited);
+
+            continue;   /* then check again */
+        }
+        else
+            key = PDC_get_key();    /* if there is, fetch it */
 
         /* copy or paste? */
 
@@ -428,6 +451,14 @@ int wgetch(WINDOW *win)
         if (key == -1)
             continue;
 
+        /* keep the details of a mouse event for nc_getmouse(); a move
+           with more input behind it is announced later, if at all */
+
+        if (SP->key_code && key == KEY_MOUSE &&
+            !PDC_queue_mouse(SP->mouse_status.changes == PDC_MOUSE_POSITION
+                             && PDC_check_key()))
+            continue;
+
         _highlight();
         SP->sel_start = SP->sel_end = -1;
 
@@ -487,6 +518,33 @@ int mvwgetch(WINDOW *win, int y, int x)
     return wgetch(win);
 }
 
+/* read the mouse events that are already waiting into the mouse
+   queue, without blocking. Reading stops at the first other key, which
+   is held back for wgetch(). */
+
+void PDC_drain_mouse(void)
+{
+    int key;
+
+    PDC_LOG(("PDC_drain_mouse() - called\n"));
+
+    while (c_heldkey == -1 && PDC_check_key())
+    {
+        key = PDC_get_key();
+
+        if (SP->key_code && key == KEY_MOUSE)
+            key = _mouse_key();
+
+        if (SP->key_code && key == KEY_MOUSE)
+            PDC_queue_mouse(TRUE);
+        else if (key != -1)
+        {
+            c_heldkey = key;
+            c_heldcode = SP->key_code;
+        }
+    }
+}
+
 int PDC_ungetch(int ch)
 {
     PDC_LOG(("ungetch() - called\n"));
@@ -508,6 +566,9 @@ int flushinp(void)
     c_gindex = 1;           /* set indices to kill buffer */
     c_pindex = 0;
     c_ungind = 0;           /* clear c_ungch array */
+    c_heldkey = -1;
+
+    PDC_flush_mouse();
 
     return OK;
 }
@@ -52,6 +52,19 @@ initscr
    set_term() does nothing meaningful in PDCurses, but is included for
    compatibility with other curses implementations.
 
+   If PDCurses is built with PDC_THREADS, SP, curscr, stdscr, LINES,
+   COLS and the rest of the state of the current screen -- the input
+   and mouse queues, color pairs, soft labels, panels and so on -- are
+   kept separately for each thread. Each thread then calls initscr() or
+   newterm() to get a screen of its own, and can drive it at the same
+   time as the others; set_term() still accepts only the calling
+   thread's screen. The device behind each screen is up to the port:
+   the Windows console port has only the one console, and the SDL ports
+   only one window, so on those just one thread should have a screen
+   open at a time. The offscreen port gives each screen its own cells,
+   so any number can be open and drawn at once. Tracing is not
+   thread-safe.
+
    resize_term() is effectively two functions: When called with nonzero
    values for nlines and ncols, it attempts to resize the screen to the
    given size. When called with (0, 0), it merely adjusts the internal
@@ -99,22 +112,22 @@ initscr
 
 #include <stdlib.h>
 
-char ttytype[128];
+PDC_TLS char ttytype[128];
 
 const char *_curses_notice = "PDCurses " PDC_VERDOT " - " __DATE__;
 
-SCREEN *SP = (SCREEN*)NULL;           /* curses variables */
-WINDOW *curscr = (WINDOW *)NULL;      /* the current screen image */
-WINDOW *stdscr = (WINDOW *)NULL;      /* the default screen window */
+PDC_TLS SCREEN *SP = (SCREEN*)NULL;   /* curses variables */
+PDC_TLS WINDOW *curscr = (WINDOW *)NULL;  /* the current screen image */
+PDC_TLS WINDOW *stdscr = (WINDOW *)NULL;  /* the default screen window */
 
-int LINES = 0;                        /* current terminal height */
-int COLS = 0;                         /* current terminal width */
-int TABSIZE = 8;
+PDC_TLS int LINES = 0;                /* current terminal height */
+PDC_TLS int COLS = 0;                 /* current terminal width */
+PDC_TLS int TABSIZE = 8;
 
-MOUSE_STATUS Mouse_status;
+PDC_TLS MOUSE_STATUS Mouse_status;
 
-extern RIPPEDOFFLINE linesripped[5];
-extern char linesrippedoff;
+extern PDC_TLS RIPPEDOFFLINE linesripped[5];
+extern PDC_TLS char linesrippedoff;
 
 #ifndef XCURSES
 static
@@ -154,6 +167,8 @@ WINDOW *Xinitscr(int argc, char *argv[])
     SP->dirty = FALSE;
     SP->sel_start = -1;
     SP->sel_end = -1;
+    SP->pointer_y = -1;
+    SP->pointer_x = -1;
 
     SP->orig_cursor = PDC_get_cursor_mode();
 
@@ -377,6 +392,9 @@ void PDC_get_version(PDC_VERSION *ver)
 #endif
 #ifdef PDC_RGB
         | PDC_VFLAG_RGB
+#endif
+#ifdef PDC_THREADS
+        | PDC_VFLAG_THREADS
 #endif
         ;
 
@@ -78,10 +78,9 @@ inopts
    if zero, then non-blocking reads are done -- if no input is waiting,
    ERR is returned immediately. If the delay is positive, the read
    blocks for the delay period; if the period expires, ERR is returned.
-   The delay is given in milliseconds, but this is rounded down to 50ms
-   (1/20th sec) intervals, with a minimum of one interval if a postive
-   delay is given; i.e., 1-99 will wait 50ms, 100-149 will wait 100ms,
-   etc.
+   The delay is given in milliseconds. While it waits, getch() sleeps
+   on the platform's input source rather than polling, so the delay is
+   as precise as the platform's timer.
 
    intrflush(), notimeout(), noqiflush(), qiflush() and typeahead() do
    nothing in PDCurses, but are included for compatibility with other
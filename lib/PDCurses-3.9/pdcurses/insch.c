@@ -154,10 +154,7 @@ int winsch(WINDOW *win, chtype ch)
 
         memmove(temp + 1, temp, (maxx - x - 1) * sizeof(chtype));
 
-        win->_lastch[y] = maxx - 1;
-
-        if ((win->_firstch[y] == _NO_CHANGE) || (win->_firstch[y] > x))
-            win->_firstch[y] = x;
+        PDC_mark_changed(win, y, x, maxx - 1);
 
         *temp = ch;
     }
@@ -90,10 +90,10 @@ kernel
 
 #include <string.h>
 
-RIPPEDOFFLINE linesripped[5];
-char linesrippedoff = 0;
+PDC_TLS RIPPEDOFFLINE linesripped[5];
+PDC_TLS char linesrippedoff = 0;
 
-static struct cttyset
+static PDC_TLS struct cttyset
 {
     bool been_set;
     SCREEN saved;
@@ -38,7 +38,7 @@ keyname
 
 char *keyname(int key)
 {
-    static char _keyname[14];
+    static PDC_TLS char _keyname[14];
 
     /* Key names must be in exactly the same order as in curses.h */
 
@@ -0,0 +1,140 @@
+/* PDCurses */
+
+#include <curspriv.h>
+
+/*man-start**************************************************************
+
+latency
+-------
+
+### Synopsis
+
+    unsigned long PDC_get_ticks(void);
+    int PDC_watch_cell(int y, int x);
+    int PDC_cell_drawn(int id, unsigned long *ticks);
+
+### Description
+
+   These functions help to measure how quickly a program responds to
+   input, from the moment the port receives an event to the moment the
+   result reaches the screen.
+
+   PDC_get_ticks() returns the time on a monotonic clock, in
+   microseconds. The count wraps around, so only the difference between
+   two readings is meaningful. Each key and mouse event is stamped with
+   this clock when the port receives it; for a mouse event, the stamp is
+   in the time field of its MEVENT.
+
+   PDC_watch_cell() asks doupdate() to note the time at which the cell
+   at (y, x) of the screen is next sent to the port. Up to 16 watches are
+   kept at once; a new one displaces the oldest. PDC_cell_drawn()
+   collects the result: once the cell has been drawn, it stores the time
+   in ticks, and the watch ends. A cell whose contents don't change is
+   not sent again, so its watch never completes.
+
+### Return Value
+
+   PDC_get_ticks() returns the time in microseconds.
+
+   PDC_watch_cell() returns an id (greater than zero) for the watch, or
+   ERR if (y, x) is outside the screen.
+
+   PDC_cell_drawn() returns OK if the cell has been drawn. It returns ERR
+   if it hasn't been drawn yet, or if the watch has already ended or has
+   been displaced.
+
+### Portability
+                             X/Open  ncurses  NetBSD
+    PDC_get_ticks               -       -       -
+    PDC_watch_cell              -       -       -
+    PDC_cell_drawn              -       -       -
+
+**man-end****************************************************************/
+
+#include <limits.h>
+
+#define NWATCH 16
+
+static PDC_TLS struct
+{
+    int id;                 /* 0 if the slot is free */
+    int y, x;
+    bool drawn;
+    unsigned long ticks;
+} watch[NWATCH];
+
+static PDC_TLS int last_id = 0;
+static PDC_TLS int waiting = 0;     /* watches whose cell hasn't been drawn */
+
+int PDC_watch_cell(int y, int x)
+{
+    int slot;
+
+    PDC_LOG(("PDC_watch_cell() - called: y=%d x=%d\n", y, x));
+
+    if (!SP || y < 0 || y >= SP->lines || x < 0 || x >= SP->cols)
+        return ERR;
+
+    last_id = (last_id == INT_MAX) ? 1 : last_id + 1;
+
+    /* ids are handed out in turn, so the slot they map to is always
+       the oldest one */
+
+    slot = last_id % NWATCH;
+
+    if (watch[slot].id && !watch[slot].drawn)
+        waiting--;
+
+    watch[slot].id = last_id;
+    watch[slot].y = y;
+    watch[slot].x = x;
+    watch[slot].drawn = FALSE;
+
+    waiting++;
+
+    return last_id;
+}
+
+int PDC_cell_drawn(int id, unsigned long *ticks)
+{
+    int slot;
+
+    PDC_LOG(("PDC_cell_drawn() - called: id=%d\n", id));
+
+    if (id <= 0)
+        return ERR;
+
+    slot = id % NWATCH;
+
+    if (watch[slot].id != id || !watch[slot].drawn)
+        return ERR;
+
+    if (ticks)
+        *ticks = watch[slot].ticks;
+
+    watch[slot].id = 0;
+
+    return OK;
+}
+
+/* called by doupdate() after the cells from x to x + len - 1 on line y
+   have been passed to PDC_transform_line() */
+
+void PDC_check_watches(int y, int x, int len)
+{
+    int i;
+
+    if (!waiting)
+        return;
+
+    for (i = 0; i < NWATCH; i++)
+    {
+        if (watch[i].id && !watch[i].drawn && watch[i].y == y &&
+            watch[i].x >= x && watch[i].x < x + len)
+        {
+            watch[i].drawn = TRUE;
+            watch[i].ticks = PDC_get_ticks();
+            waiting--;
+        }
+    }
+}
@@ -22,9 +22,12 @@ mouse
     bool mouse_trafo(int *y, int *x, bool to_screen);
     mmask_t mousemask(mmask_t mask, mmask_t *oldmask);
     int nc_getmouse(MEVENT *event);
+    int nc_getmouse_batch(MEVENT *events, int n);
     int ungetmouse(MEVENT *event);
     bool has_mouse(void);
 
+    int PDC_get_pointer(int *y, int *x);
+
 ### Description
 
    As of PDCurses 3.0, there are two separate mouse interfaces: the
@@ -74,8 +77,11 @@ mouse
    event, and there are no more events waiting, it will wait for the
    timeout interval, then check again for a release. A press followed by
    a release is reported as BUTTON_CLICKED; otherwise it's passed
-   through as BUTTON_PRESSED. The default timeout is 150ms; valid values
-   are 0 (no clicks reported) through 1000ms. In x11, the timeout can
+   through as BUTTON_PRESSED. The wait ends as soon as the next event
+   arrives. It's skipped altogether for a button whose click events
+   aren't trapped (when some events are), so a program that only wants
+   BUTTON1_PRESSED gets each press immediately. The default timeout is
+   150ms; valid values are 0 (no clicks reported) through 1000ms. In x11, the timeout can
    also be set via the clickPeriod resource. The return value from
    mouseinterval() is the old timeout. To check the old value without
    setting a new one, call it with a parameter of -1. Note that although
@@ -102,21 +108,48 @@ mouse
    since the ncurses interface doesn't work with PDCurses' BUTTON_MOVED
    events, mousemask() filters them out.
 
-   nc_getmouse() returns the current mouse status in an MEVENT struct.
-   This is equivalent to ncurses' getmouse(), renamed to avoid conflict
-   with PDCurses' getmouse(). But if you define PDC_NCMOUSE before
-   including curses.h, it defines getmouse() to nc_getmouse(), along
-   with a few other redefintions needed for compatibility with ncurses
-   code. nc_getmouse() calls request_mouse_pos(), which (not getmouse())
-   is the classic equivalent.
-
-   ungetmouse() is the mouse equivalent of ungetch(). However, PDCurses
-   doesn't maintain a queue of mouse events; only one can be pushed
-   back, and it can overwrite or be overwritten by real mouse events.
+   nc_getmouse() returns the oldest mouse event from the mouse queue in
+   an MEVENT struct, or the current mouse status if the queue is empty.
+   Each KEY_MOUSE returned by getch() adds one event to the queue, so
+   events that arrive faster than they are collected are reported in
+   order rather than overwritten; the queue holds the last 32. This is
+   equivalent to ncurses' getmouse(), renamed to avoid conflict with
+   PDCurses' getmouse(). But if you define PDC_NCMOUSE before including
+   curses.h, it defines getmouse() to nc_getmouse(), along with a few
+   other redefintions needed for compatibility with ncurses code.
+   nc_getmouse() calls request_mouse_pos(), which (not getmouse()) is
+   the classic equivalent. As a PDCurses extension, the time member of
+   the MEVENT gives when the port received the event, as a reading of
+   PDC_get_ticks().
+
+   With REPORT_MOUSE_POSITION in the mask, moving the mouse with no
+   button down is reported as an event with that bit set. Moves are
+   coalesced: a move replaces a move at the tail of the queue, and one
+   that has more input waiting behind it is only announced by KEY_MOUSE
+   once getch() has run out of other input. So the queue keeps just the
+   latest position between clicks, and the clicks keep their order.
+
+   nc_getmouse_batch() first reads any mouse input that is already
+   waiting, without blocking and without returning KEY_MOUSE for it,
+   then moves up to n events from the queue into the events array,
+   oldest first. A key other than a mouse event stops the reading, and
+   is returned by the next getch(). This lets a program that calls
+   getch() once per frame handle every mouse event of the frame.
+
+   ungetmouse() is the mouse equivalent of ungetch(). It puts the event
+   at the head of the mouse queue, and pushes back a KEY_MOUSE.
 
    has_mouse() reports whether the mouse is available at all on the
    current platform.
 
+   PDC_get_pointer() reads any mouse input that is already waiting, as
+   nc_getmouse_batch() does, and returns the screen cell that the
+   pointer was last seen over in y and x, whether or not the events are
+   trapped. Nothing is taken from the mouse queue, and a KEY_MOUSE is
+   still returned later for each trapped event read this way. It
+   returns ERR, with y and x set to -1, if the pointer hasn't been seen
+   yet.
+
 ### Portability
                              X/Open  ncurses  NetBSD
     mouse_set                   -       -       -
@@ -131,8 +164,10 @@ mouse
     mouse_trafo                 -       Y       -
     mousemask                   -       Y       -
     nc_getmouse                 -       *       -
+    nc_getmouse_batch           -       -       -
     ungetmouse                  -       Y       -
     has_mouse                   -       Y       -
+    PDC_get_pointer             -       -       -
 
     * See above, under Description
 
@@ -140,7 +175,12 @@ mouse
 
 #include <string.h>
 
-static bool ungot = FALSE;
+#define NMOUSEQ 32  /* max # mouse events kept for nc_getmouse() */
+
+static PDC_TLS MEVENT mouse_queue[NMOUSEQ];
+static PDC_TLS int mq_head = 0;     /* index of the oldest event */
+static PDC_TLS int mq_count = 0;    /* number of events queued */
+static PDC_TLS int mq_unseen = 0;   /* of those, not yet announced by KEY_MOUSE */
 
 int mouse_set(mmask_t mbe)
 {
@@ -302,32 +342,37 @@ mmask_t mousemask(mmask_t mask, mmask_t *oldmask)
     return SP->_trap_mbe;
 }
 
-int nc_getmouse(MEVENT *event)
-{
-    int i;
-    mmask_t bstate = 0;
+/* whether a press of the given button (0-2) should wait to see if it
+   turns into a click: only if it's trapped, or nothing is (the press
+   may start a selection, and the click of button 2 pastes) */
 
-    PDC_LOG(("nc_getmouse() - called\n"));
+bool PDC_click_wanted(int button)
+{
+    mmask_t clicks = (BUTTON1_CLICKED | BUTTON1_DOUBLE_CLICKED |
+                      BUTTON1_TRIPLE_CLICKED) << (button * 5);
 
-    if (!event || !SP)
-        return ERR;
+    return SP->mouse_wait && (!SP->_trap_mbe || (SP->_trap_mbe & clicks));
+}
 
-    ungot = FALSE;
+/* convert a classic mouse status to the ncurses form */
 
-    request_mouse_pos();
+static void _mouse_event(const MOUSE_STATUS *status, MEVENT *event)
+{
+    int i;
+    mmask_t bstate = 0;
 
     event->id = 0;
 
-    event->x = Mouse_status.x;
-    event->y = Mouse_status.y;
+    event->x = status->x;
+    event->y = status->y;
     event->z = 0;
 
     for (i = 0; i < 3; i++)
     {
-        if (Mouse_status.changes & (1 << i))
+        if (status->changes & (1 << i))
         {
             int shf = i * 5;
-            short button = Mouse_status.button[i] & BUTTON_ACTION_MASK;
+            short button = status->button[i] & BUTTON_ACTION_MASK;
 
             if (button == BUTTON_RELEASED)
                 bstate |= (BUTTON1_RELEASED << shf);
@@ -338,7 +383,7 @@ int nc_getmouse(MEVENT *event)
             else if (button == BUTTON_DOUBLE_CLICKED)
                 bstate |= (BUTTON1_DOUBLE_CLICKED << shf);
 
-            button = Mouse_status.button[i] & BUTTON_MODIFIER_MASK;
+            button = status->button[i] & BUTTON_MODIFIER_MASK;
 
             if (button & PDC_BUTTON_SHIFT)
                 bstate |= BUTTON_MODIFIER_SHIFT;
@@ -349,18 +394,128 @@ int nc_getmouse(MEVENT *event)
         }
     }
 
-    if (MOUSE_WHEEL_UP)
+    if (status->changes & PDC_MOUSE_WHEEL_UP)
         bstate |= BUTTON4_PRESSED;
-    else if (MOUSE_WHEEL_DOWN)
+    else if (status->changes & PDC_MOUSE_WHEEL_DOWN)
         bstate |= BUTTON5_PRESSED;
 
+    if (status->changes & PDC_MOUSE_POSITION)
+        bstate |= REPORT_MOUSE_POSITION;
+
+    event->bstate = bstate;
+    event->time = SP->key_time;
+}
+
+/* add the current mouse status to the tail of the queue; when it's
+   full, the oldest event is dropped. A move just updates a move at the
+   tail. Returns TRUE if there's a new event to announce with KEY_MOUSE
+   now; with hold, it's counted as unseen instead. */
+
+bool PDC_queue_mouse(bool hold)
+{
+    MEVENT event, *tail;
+
+    PDC_LOG(("PDC_queue_mouse() - called: hold=%d\n", hold));
+
+    _mouse_event(&SP->mouse_status, &event);
+
+    tail = mouse_queue + (mq_head + mq_count + NMOUSEQ - 1) % NMOUSEQ;
+
+    if (mq_count && event.bstate == REPORT_MOUSE_POSITION &&
+        tail->bstate == REPORT_MOUSE_POSITION)
+    {
+        *tail = event;
+        return FALSE;
+    }
+
+    if (mq_count == NMOUSEQ)
+    {
+        mq_head = (mq_head + 1) % NMOUSEQ;
+        mq_count--;
+
+        if (mq_unseen > mq_count)
+            mq_unseen = mq_count;
+    }
+
+    mouse_queue[(mq_head + mq_count) % NMOUSEQ] = event;
+    mq_count++;
+
+    if (hold)
+        mq_unseen++;
+
+    return !hold;
+}
+
+/* take one unseen event for wgetch() to announce */
+
+bool PDC_mouse_unseen(void)
+{
+    if (!mq_unseen)
+        return FALSE;
+
+    mq_unseen--;
+
+    return TRUE;
+}
+
+void PDC_flush_mouse(void)
+{
+    PDC_LOG(("PDC_flush_mouse() - called\n"));
+
+    mq_head = mq_count = mq_unseen = 0;
+}
+
+/* remove the oldest event; if no announced events are left, it takes
+   the place of an unseen one */
+
+static void _mouse_pop(MEVENT *event)
+{
+    if (mq_unseen == mq_count)
+        mq_unseen--;
+
+    *event = mouse_queue[mq_head];
+    mq_head = (mq_head + 1) % NMOUSEQ;
+    mq_count--;
+}
+
+int nc_getmouse(MEVENT *event)
+{
+    PDC_LOG(("nc_getmouse() - called\n"));
+
+    if (!event || !SP)
+        return ERR;
+
+    request_mouse_pos();
+
+    if (mq_count)
+        _mouse_pop(event);
+    else
+        _mouse_event(&Mouse_status, event);
+
     /* extra filter pass -- mainly for button modifiers */
 
-    event->bstate = bstate & SP->_trap_mbe;
+    event->bstate &= SP->_trap_mbe;
 
     return OK;
 }
 
+int nc_getmouse_batch(MEVENT *events, int n)
+{
+    int i;
+
+    PDC_LOG(("nc_getmouse_batch() - called: n=%d\n", n));
+
+    if (!events || n < 0 || !SP)
+        return ERR;
+
+    PDC_drain_mouse();
+
+    for (i = 0; i < n && mq_count; i++)
+        nc_getmouse(events + i);
+
+    return i;
+}
+
 int ungetmouse(MEVENT *event)
 {
     int i;
@@ -368,11 +523,9 @@ int ungetmouse(MEVENT *event)
 
     PDC_LOG(("ungetmouse() - called\n"));
 
-    if (!event || ungot)
+    if (!event || !SP)
         return ERR;
 
-    ungot = TRUE;
-
     SP->mouse_status.x = event->x;
     SP->mouse_status.y = event->y;
 
@@ -412,6 +565,24 @@ int ungetmouse(MEVENT *event)
     else if (bstate & BUTTON5_PRESSED)
         SP->mouse_status.changes |= PDC_MOUSE_WHEEL_DOWN;
 
+    if (bstate & REPORT_MOUSE_POSITION)
+        SP->mouse_status.changes |= PDC_MOUSE_POSITION;
+
+    /* the pushed-back event goes to the head of the queue */
+
+    if (mq_count == NMOUSEQ)
+    {
+        mq_count--;
+
+        if (mq_unseen > mq_count)
+            mq_unseen = mq_count;
+    }
+
+    mq_head = (mq_head + NMOUSEQ - 1) % NMOUSEQ;
+    mq_count++;
+
+    mouse_queue[mq_head] = *event;
+
     return ungetch(KEY_MOUSE);
 }
 
@@ -419,3 +590,23 @@ bool has_mouse(void)
 {
     return PDC_has_mouse();
 }
+
+int PDC_get_pointer(int *y, int *x)
+{
+    PDC_LOG(("PDC_get_pointer() - called\n"));
+
+    if (!y || !x)
+        return ERR;
+
+    *y = *x = -1;
+
+    if (!SP)
+        return ERR;
+
+    PDC_drain_mouse();
+
+    *y = SP->pointer_y;
+    *x = SP->pointer_x;
+
+    return (*y == -1) ? ERR : OK;
+}
@@ -53,7 +53,7 @@ static int _copy_win(const WINDOW *src_w, WINDOW *dst_w, int src_tr,
                      int src_tc, int src_br, int src_bc, int dst_tr,
                      int dst_tc, bool _overlay)
 {
-    int col, line, y1, fc, *minchng, *maxchng;
+    int col, line, fc;
     chtype *w1ptr, *w2ptr;
 
     int lc = 0;
@@ -63,15 +63,6 @@ static int _copy_win(const WINDOW *src_w, WINDOW *dst_w, int src_tr,
     if (!src_w || !dst_w)
         return ERR;
 
-    minchng = dst_w->_firstch;
-    maxchng = dst_w->_lastch;
-
-    for (y1 = 0; y1 < dst_tr; y1++)
-    {
-        minchng++;
-        maxchng++;
-    }
-
     for (line = 0; line < ydiff; line++)
     {
         w1ptr = src_w->_y[line + src_tr] + src_tc;
@@ -96,21 +87,8 @@ static int _copy_win(const WINDOW *src_w, WINDOW *dst_w, int src_tr,
             w2ptr++;
         }
 
-        if (*minchng == _NO_CHANGE)
-        {
-            *minchng = fc;
-            *maxchng = lc;
-        }
-        else if (fc != _NO_CHANGE)
-        {
-            if (fc < *minchng)
-                *minchng = fc;
-            if (lc > *maxchng)
-                *maxchng = lc;
-        }
-
-        minchng++;
-        maxchng++;
+        if (fc != _NO_CHANGE)
+            PDC_mark_changed(dst_w, line + dst_tr, fc, lc);
     }
 
     return OK;
@@ -77,8 +77,8 @@ pad
 
 /* save values for pechochar() */
 
-static int save_pminrow, save_pmincol;
-static int save_sminrow, save_smincol, save_smaxrow, save_smaxcol;
+static PDC_TLS int save_pminrow, save_pmincol;
+static PDC_TLS int save_sminrow, save_smincol, save_smaxrow, save_smaxcol;
 
 WINDOW *newpad(int nlines, int ncols)
 {
@@ -208,15 +208,8 @@ int pnoutrefresh(WINDOW *w, int py, int px, int sy1, int sx1, int sy2, int sx2)
             memcpy(curscr->_y[sline] + sx1, w->_y[pline] + px,
                    num_cols * sizeof(chtype));
 
-            if ((curscr->_firstch[sline] == _NO_CHANGE)
-                || (curscr->_firstch[sline] > sx1))
-                curscr->_firstch[sline] = sx1;
-
-            if (sx2 > curscr->_lastch[sline])
-                curscr->_lastch[sline] = sx2;
-
-            w->_firstch[pline] = _NO_CHANGE; /* updated now */
-            w->_lastch[pline] = _NO_CHANGE;  /* updated now */
+            PDC_mark_changed(curscr, sline, sx1, sx2);
+            PDC_mark_unchanged(w, pline);   /* updated now */
         }
 
         sline++;
@@ -121,9 +121,9 @@ panel
 #include <panel.h>
 #include <stdlib.h>
 
-PANEL *_bottom_panel = (PANEL *)0;
-PANEL *_top_panel = (PANEL *)0;
-PANEL _stdscr_pseudo_panel = { (WINDOW *)0 };
+PDC_TLS PANEL *_bottom_panel = (PANEL *)0;
+PDC_TLS PANEL *_top_panel = (PANEL *)0;
+PDC_TLS PANEL _stdscr_pseudo_panel = { (WINDOW *)0 };
 
 #ifdef PANEL_DEBUG
 
@@ -207,7 +207,7 @@ static void _free_obscure(PANEL *pan)
     while (tobs)
     {
         nobs = tobs->above;
-        free((char *)tobs);
+        PDC_free((char *)tobs);
         tobs = nobs;
     }
     pan->obscure = (PANELOBS *)0;
@@ -263,7 +263,7 @@ static void _calculate_obscure(void)
         {
             if (_panels_overlapped(pan, pan2))
             {
-                if ((tobs = malloc(sizeof(PANELOBS))) == NULL)
+                if ((tobs = PDC_malloc(sizeof(PANELOBS))) == NULL)
                     return;
 
                 tobs->pan = pan2;
@@ -425,7 +425,7 @@ int del_panel(PANEL *pan)
         if (_panel_is_linked(pan))
             hide_panel(pan);
 
-        free((char *)pan);
+        PDC_free((char *)pan);
         return OK;
     }
 
@@ -483,7 +483,7 @@ PANEL *new_panel(WINDOW *win)
     if (!win)
         return (PANEL *)NULL;
 
-    pan  = malloc(sizeof(PANEL));
+    pan  = PDC_malloc(sizeof(PANEL));
 
     if (!_stdscr_pseudo_panel.win)
     {
@@ -16,6 +16,9 @@ refresh
     int redrawwin(WINDOW *win);
     int wredrawln(WINDOW *win, int beg_line, int num_lines);
 
+    void PDC_get_render_stats(PDC_RENDER_STATS *stats);
+    void PDC_reset_render_stats(void);
+
 ### Description
 
    wrefresh() copies the named window to the physical terminal screen,
@@ -40,9 +43,31 @@ refresh
    is the same as touchline(). In some other curses implementations,
    there's a subtle distinction, but it has no meaning in PDCurses.
 
+   PDC_get_render_stats() copies the counters of the work done to bring
+   the screen up to date:
+
+   - lines: changed lines that doupdate() scanned; when it redraws the
+     whole screen, as after clearok(curscr, TRUE), every line
+   - compared: cells that it compared with the last screen; none are
+     compared when it redraws the whole screen
+   - runs: runs of cells passed to the port's PDC_transform_line()
+   - cells: the cells in those runs
+   - updates: batches of output presented by ports that defer it, such
+     as PDC_update_rects() in the SDL ports; other ports count none
+   - rects: rectangles presented in those batches
+   - bytes: the size of what the port wrote to the screen for the
+     cells, in its own format, e.g. CHAR_INFOs in the Windows console
+     port; ports that don't count it leave it at zero
+
+   Taking the counters before and after a frame shows how much of the
+   screen it redrew, and what that cost. PDC_reset_render_stats() sets
+   the counters to zero.
+
 ### Return Value
 
-   All functions return OK on success and ERR on error.
+   All functions return OK on success and ERR on error, except for
+   PDC_get_render_stats() and PDC_reset_render_stats(), which return
+   nothing.
 
 ### Portability
                              X/Open  ncurses  NetBSD
@@ -52,21 +77,189 @@ refresh
     doupdate                    Y       Y       Y
     redrawwin                   Y       Y       Y
     wredrawln                   Y       Y       Y
+    PDC_get_render_stats        -       -       -
+    PDC_reset_render_stats      -       -       -
 
 **man-end****************************************************************/
 
 #include <string.h>
 
+/* spans of fewer chunks than this are compared in one go */
+
+#define _DIRTY_MIN_SKIP 8
+
+static PDC_TLS PDC_RENDER_STATS render_stats;
+
+void PDC_mark_changed(WINDOW *win, int y, int first, int last)
+{
+#ifdef PDC_DIRTY_CHUNKS
+    unsigned long *map = _DIRTY_MAP(win, y);
+    int word;
+#endif
+    if (first < win->_firstch[y] || win->_firstch[y] == _NO_CHANGE)
+        win->_firstch[y] = first;
+
+    if (last > win->_lastch[y])
+        win->_lastch[y] = last;
+
+#ifdef PDC_DIRTY_CHUNKS
+    /* set the bits a word at a time */
+
+    first >>= _DIRTY_SHIFT;
+    last >>= _DIRTY_SHIFT;
+
+    for (word = first / _DIRTY_BITS; word <= last / _DIRTY_BITS; word++)
+    {
+        unsigned long bits = ~0UL;
+
+        if (word == first / _DIRTY_BITS)
+            bits &= ~((1UL << (first % _DIRTY_BITS)) - 1);
+
+        if (word == last / _DIRTY_BITS)
+            bits &= (2UL << (last % _DIRTY_BITS)) - 1;
+
+        map[word] |= bits;
+    }
+#endif
+}
+
+void PDC_mark_unchanged(WINDOW *win, int y)
+{
+    unsigned long *map = _DIRTY_MAP(win, y);
+    int i;
+
+    win->_firstch[y] = _NO_CHANGE;
+    win->_lastch[y] = _NO_CHANGE;
+
+    for (i = _DIRTY_WORDS(win->_maxx); i; i--)
+        *map++ = 0;
+}
+
+static bool _chunk_changed(const unsigned long *map, int chunk)
+{
+    return !!(map[chunk / _DIRTY_BITS] & (1UL << (chunk % _DIRTY_BITS)));
+}
+
+/* TRUE if line y of win spans enough chunks for skipping the unmarked
+   ones to pay, and its bitmap covers the span -- it may not, if
+   something set _firstch and _lastch directly. Always FALSE without
+   PDC_DIRTY_CHUNKS, as there are no bitmaps. */
+
+static bool _sparse(WINDOW *win, int y)
+{
+#ifdef PDC_DIRTY_CHUNKS
+    const unsigned long *map = _DIRTY_MAP(win, y);
+    int first = win->_firstch[y] >> _DIRTY_SHIFT;
+    int last = win->_lastch[y] >> _DIRTY_SHIFT;
+
+    return last - first >= _DIRTY_MIN_SKIP &&
+           _chunk_changed(map, first) && _chunk_changed(map, last);
+#else
+    return FALSE;
+#endif
+}
+
+/* Find the next run of marked chunks on line y of win, searching from
+   chunk *next, and return it as cells clipped to the line's span.
+   Returns FALSE when there are no more runs. Testing the chunks one by
+   one is cheap, and unlike a bit scan, keeps the branches predictable
+   when the changes are scattered. */
+
+static bool _next_run(WINDOW *win, int y, int *next, int *first, int *last)
+{
+    const unsigned long *map = _DIRTY_MAP(win, y);
+    int end = win->_lastch[y] >> _DIRTY_SHIFT;
+    int chunk = *next;
+
+    while (chunk <= end && !_chunk_changed(map, chunk))
+    {
+        /* step over empty words whole */
+
+        if (!(chunk % _DIRTY_BITS) && !map[chunk / _DIRTY_BITS])
+            chunk += _DIRTY_BITS;
+        else
+            chunk++;
+    }
+
+    if (chunk > end)
+        return FALSE;
+
+    *first = max(chunk << _DIRTY_SHIFT, win->_firstch[y]);
+
+    while (chunk <= end && _chunk_changed(map, chunk))
+        chunk++;
+
+    *last = min((chunk << _DIRTY_SHIFT) - 1, win->_lastch[y]);
+    *next = chunk;
+
+    return TRUE;
+}
+
+/* OR bits into map at bit position at, spilling into the next of its
+   words if there is one */
+
+static void _or_bits(unsigned long *map, int words, int at,
+                     unsigned long bits)
+{
+    int word = at / _DIRTY_BITS;
+    int shift = at % _DIRTY_BITS;
+
+    map[word] |= bits << shift;
+
+    if (shift && word + 1 < words)
+        map[word + 1] |= bits >> (_DIRTY_BITS - shift);
+}
+
+/* Mark the chunks of curscr that hold the chunks marked between cells
+   first and last on line y of win. A window that does not start on a
+   chunk boundary spreads each of its chunks over two of curscr's. */
+
+static void _merge_map(WINDOW *win, int y, int first, int last)
+{
+    const unsigned long *src = _DIRTY_MAP(win, y);
+    unsigned long *dest = _DIRTY_MAP(curscr, y + win->_begy);
+    int words = _DIRTY_WORDS(curscr->_maxx);
+    int at = win->_begx >> _DIRTY_SHIFT;
+    bool spread = (win->_begx & ((1 << _DIRTY_SHIFT) - 1)) != 0;
+    int word;
+
+    first >>= _DIRTY_SHIFT;
+    last >>= _DIRTY_SHIFT;
+
+    for (word = first / _DIRTY_BITS; word <= last / _DIRTY_BITS; word++)
+    {
+        unsigned long bits = src[word];
+
+        if (word == first / _DIRTY_BITS)
+            bits &= ~((1UL << (first % _DIRTY_BITS)) - 1);
+
+        if (word == last / _DIRTY_BITS)
+            bits &= (2UL << (last % _DIRTY_BITS)) - 1;
+
+        if (bits)
+        {
+            _or_bits(dest, words, at + word * _DIRTY_BITS, bits);
+
+            if (spread)
+                _or_bits(dest, words, at + word * _DIRTY_BITS + 1, bits);
+        }
+    }
+}
+
 int wnoutrefresh(WINDOW *win)
 {
     int begy, begx;     /* window's place on screen   */
     int i, j;
+    long lines = 0, cells = 0;
+    unsigned long start;
 
     PDC_LOG(("wnoutrefresh() - called: win=%p\n", win));
 
     if ( !win || (win->_flags & (_PAD|_SUBPAD)) )
         return ERR;
 
+    start = PDC_TRACE_START();
+
     begy = win->_begy;
     begx = win->_begx;
 
@@ -93,24 +286,49 @@ int wnoutrefresh(WINDOW *win)
 
             if (first <= last)
             {
-                memcpy(dest + first, src + first,
-                       (last - first + 1) * sizeof(chtype));
+                /* in a wide span, only the runs of chunks marked as
+                   changed are copied and passed on to curscr, so that
+                   doupdate() need compare no more than they hold */
 
-                first += begx;
-                last += begx;
+                if (_sparse(win, i))
+                {
+                    int next = first >> _DIRTY_SHIFT;
+                    int from, to;
+
+                    while (_next_run(win, i, &next, &from, &to))
+                    {
+                        from = max(from, first);
+                        to = min(to, last);
+
+                        if (from <= to)
+                        {
+                            memcpy(dest + from, src + from,
+                                   (to - from + 1) * sizeof(chtype));
+                            cells += to - from + 1;
+                        }
+                    }
+
+                    _merge_map(win, i, first, last);
+
+                    PDC_mark_changed(curscr, j, first + begx, first + begx);
+                    PDC_mark_changed(curscr, j, last + begx, last + begx);
+                }
+                else
+                {
+                    memcpy(dest + first, src + first,
+                           (last - first + 1) * sizeof(chtype));
+                    cells += last - first + 1;
 
-                if (first < curscr->_firstch[j] ||
-                    curscr->_firstch[j] == _NO_CHANGE)
-                    curscr->_firstch[j] = first;
+                    PDC_mark_changed(curscr, j, first + begx, last + begx);
+                }
 
-                if (last > curscr->_lastch[j])
-                    curscr->_lastch[j] = last;
+                lines++;
             }
 
-            win->_firstch[i] = _NO_CHANGE;  /* updated now */
+            PDC_mark_unchanged(win, i);     /* updated now */
         }
-
-        win->_lastch[i] = _NO_CHANGE;       /* updated now */
+        else
+            win->_lastch[i] = _NO_CHANGE;   /* updated now */
     }
 
     if (win->_clear)
@@ -122,19 +340,81 @@ int wnoutrefresh(WINDOW *win)
         curscr->_curx = win->_curx + begx;
     }
 
+    PDC_TRACE_SPAN(PDC_SPAN_WNOUTREFRESH, start, lines, cells);
+
     return OK;
 }
 
+/* Pass len cells from src to the port, at (y, x) */
+
+static void _transform(int y, int x, int len, const chtype *src)
+{
+    unsigned long start = PDC_TRACE_START();
+
+    PDC_transform_line(y, x, len, src);
+
+    PDC_TRACE_SPAN(PDC_SPAN_TRANSFORM_LINE, start, y, len);
+
+    PDC_check_watches(y, x, len);
+    render_stats.runs++;
+    render_stats.cells += len;
+}
+
+/* Send the changed cells between first and last on line y to the
+   screen, and SP->lastscr */
+
+static void _transform_span(int y, int first, int last)
+{
+    chtype *src = curscr->_y[y];
+    chtype *dest = SP->lastscr->_y[y];
+
+    render_stats.compared += last - first + 1;
+
+    while (first <= last)
+    {
+        int len = 0;
+
+        /* build up a run of changed cells; if two runs are separated by a
+           single unchanged cell, ignore the break */
+
+        while (first + len <= last &&
+               (src[first + len] != dest[first + len] ||
+                (len && first + len < last &&
+                 src[first + len + 1] != dest[first + len + 1])
+               )
+              )
+            len++;
+
+        /* update the screen, and SP->lastscr */
+
+        if (len)
+        {
+            _transform(y, first, len, src + first);
+            memcpy(dest + first, src + first, len * sizeof(chtype));
+            first += len;
+        }
+
+        /* skip over runs of unchanged cells */
+
+        while (first <= last && src[first] == dest[first])
+            first++;
+    }
+}
+
 int doupdate(void)
 {
-    int y;
+    int y, next, first, last;
     bool clearall;
+    PDC_RENDER_STATS before = render_stats;
+    unsigned long start;
 
     PDC_LOG(("doupdate() - called\n"));
 
     if (!SP || !curscr)
         return ERR;
 
+    start = PDC_TRACE_START();
+
     if (isendwin())         /* coming back after endwin() called */
     {
         reset_prog_mode();
@@ -150,60 +430,35 @@ int doupdate(void)
                  y, SP->lines, (curscr->_firstch[y] != _NO_CHANGE) ?
                  "Yes" : "No"));
 
-        if (clearall || curscr->_firstch[y] != _NO_CHANGE)
+        if (clearall)
         {
-            int first, last;
-
             chtype *src = curscr->_y[y];
-            chtype *dest = SP->lastscr->_y[y];
 
-            if (clearall)
-            {
-                first = 0;
-                last = COLS - 1;
-            }
-            else
-            {
-                first = curscr->_firstch[y];
-                last = curscr->_lastch[y];
-            }
-
-            while (first <= last)
-            {
-                int len = 0;
-
-                /* build up a run of changed cells; if two runs are
-                   separated by a single unchanged cell, ignore the
-                   break */
+            render_stats.lines++;
 
-                if (clearall)
-                    len = last - first + 1;
-                else
-                    while (first + len <= last &&
-                           (src[first + len] != dest[first + len] ||
-                            (len && first + len < last &&
-                             src[first + len + 1] != dest[first + len + 1])
-                           )
-                          )
-                        len++;
+            _transform(y, 0, COLS, src);
+            memcpy(SP->lastscr->_y[y], src, COLS * sizeof(chtype));
 
-                /* update the screen, and SP->lastscr */
+            PDC_mark_unchanged(curscr, y);
+        }
+        else if (curscr->_firstch[y] != _NO_CHANGE)
+        {
+            render_stats.lines++;
 
-                if (len)
-                {
-                    PDC_transform_line(y, first, len, src + first);
-                    memcpy(dest + first, src + first, len * sizeof(chtype));
-                    first += len;
-                }
+            /* in wide spans, only the runs of chunks marked as changed
+               are compared */
 
-                /* skip over runs of unchanged cells */
+            if (_sparse(curscr, y))
+            {
+                next = curscr->_firstch[y] >> _DIRTY_SHIFT;
 
-                while (first <= last && src[first] == dest[first])
-                    first++;
+                while (_next_run(curscr, y, &next, &first, &last))
+                    _transform_span(y, first, last);
             }
+            else
+                _transform_span(y, curscr->_firstch[y], curscr->_lastch[y]);
 
-            curscr->_firstch[y] = _NO_CHANGE;
-            curscr->_lastch[y] = _NO_CHANGE;
+            PDC_mark_unchanged(curscr, y);
         }
     }
 
@@ -215,6 +470,10 @@ int doupdate(void)
     SP->cursrow = curscr->_cury;
     SP->curscol = curscr->_curx;
 
+    PDC_TRACE_SPAN(PDC_SPAN_DOUPDATE, start,
+                   (long)(render_stats.runs - before.runs),
+                   (long)(render_stats.cells - before.cells));
+
     return OK;
 }
 
@@ -258,10 +517,7 @@ int wredrawln(WINDOW *win, int start, int num)
         return ERR;
 
     for (i = start; i < start + num; i++)
-    {
-        win->_firstch[i] = 0;
-        win->_lastch[i] = win->_maxx - 1;
-    }
+        PDC_mark_changed(win, i, 0, win->_maxx - 1);
 
     return OK;
 }
@@ -275,3 +531,34 @@ int redrawwin(WINDOW *win)
 
     return wredrawln(win, 0, win->_maxy);
 }
+
+/* called by ports that defer their output, when they present a batch
+   of it in rects rectangles */
+
+/* called by ports that count the bytes they write for the cells */
+
+void PDC_count_bytes(unsigned long bytes)
+{
+    render_stats.bytes += bytes;
+}
+
+void PDC_count_update(int rects)
+{
+    render_stats.updates++;
+    render_stats.rects += rects;
+}
+
+void PDC_get_render_stats(PDC_RENDER_STATS *stats)
+{
+    PDC_LOG(("PDC_get_render_stats() - called\n"));
+
+    if (stats)
+        *stats = render_stats;
+}
+
+void PDC_reset_render_stats(void)
+{
+    PDC_LOG(("PDC_reset_render_stats() - called\n"));
+
+    memset(&render_stats, 0, sizeof(render_stats));
+}
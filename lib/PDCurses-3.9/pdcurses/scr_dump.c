@@ -60,7 +60,7 @@ scr_dump
 #include <stdlib.h>
 #include <string.h>
 
-#define DUMPVER 1   /* Should be updated whenever the WINDOW struct is
+#define DUMPVER 2   /* Should be updated whenever the WINDOW struct is
                        changed */
 
 int putwin(WINDOW *win, FILE *filep)
@@ -92,61 +92,38 @@ int putwin(WINDOW *win, FILE *filep)
 
 WINDOW *getwin(FILE *filep)
 {
-    WINDOW *win;
+    WINDOW *win, tmp;
     char marker[4];
     int i, nlines, ncols;
 
     PDC_LOG(("getwin() - called\n"));
 
-    win = malloc(sizeof(WINDOW));
-    if (!win)
-        return (WINDOW *)NULL;
-
     /* check for the marker, and load the WINDOW struct */
 
     if (!filep || !fread(marker, 4, 1, filep) || strncmp(marker, "PDC", 3)
-        || marker[3] != DUMPVER || !fread(win, sizeof(WINDOW), 1, filep))
-    {
-        free(win);
+        || marker[3] != DUMPVER || !fread(&tmp, sizeof(WINDOW), 1, filep))
         return (WINDOW *)NULL;
-    }
 
-    nlines = win->_maxy;
-    ncols = win->_maxx;
+    nlines = tmp._maxy;
+    ncols = tmp._maxx;
 
-    /* allocate the line pointer array */
-
-    win->_y = malloc(nlines * sizeof(chtype *));
-    if (!win->_y)
-    {
-        free(win);
-        return (WINDOW *)NULL;
-    }
+    /* allocate the window and its lines */
 
-    /* allocate the minchng and maxchng arrays */
+    win = PDC_makenew(nlines, ncols, tmp._begy, tmp._begx);
+    if (win)
+        win = PDC_makelines(win);
 
-    win->_firstch = malloc(nlines * sizeof(int));
-    if (!win->_firstch)
-    {
-        free(win->_y);
-        free(win);
+    if (!win)
         return (WINDOW *)NULL;
-    }
 
-    win->_lastch = malloc(nlines * sizeof(int));
-    if (!win->_lastch)
-    {
-        free(win->_firstch);
-        free(win->_y);
-        free(win);
-        return (WINDOW *)NULL;
-    }
+    /* keep the stored settings, but with the new storage */
 
-    /* allocate the lines */
+    tmp._y = win->_y;
+    tmp._firstch = win->_firstch;
+    tmp._lastch = win->_lastch;
+    tmp._dirty = win->_dirty;
 
-    win = PDC_makelines(win);
-    if (!win)
-        return (WINDOW *)NULL;
+    *win = tmp;
 
     /* read them */
 
@@ -88,11 +88,11 @@ slk
 
 enum { LABEL_NORMAL = 8, LABEL_EXTENDED = 10, LABEL_NCURSES_EXTENDED = 12 };
 
-static int label_length = 0;
-static int labels = 0;
-static int label_fmt = 0;
-static int label_line = 0;
-static bool hidden = FALSE;
+static PDC_TLS int label_length = 0;
+static PDC_TLS int labels = 0;
+static PDC_TLS int label_fmt = 0;
+static PDC_TLS int label_line = 0;
+static PDC_TLS bool hidden = FALSE;
 
 static struct SLK {
     chtype label[32];
@@ -147,7 +147,7 @@ int slk_init(int fmt)
 
     label_fmt = fmt;
 
-    slk = calloc(labels, sizeof(struct SLK));
+    slk = PDC_calloc(labels, sizeof(struct SLK));
 
     if (!slk)
         labels = 0;
@@ -285,7 +285,7 @@ int slk_noutrefresh(void)
 
 char *slk_label(int labnum)
 {
-    static char temp[33];
+    static PDC_TLS char temp[33];
 #ifdef PDC_WIDE
     wchar_t *wtemp = slk_wlabel(labnum);
 
@@ -566,7 +566,7 @@ void PDC_slk_free(void)
             SP->slk_winptr = (WINDOW *)NULL;
         }
 
-        free(slk);
+        PDC_free(slk);
         slk = (struct SLK *)NULL;
 
         label_length = 0;
@@ -652,7 +652,7 @@ int slk_wset(int labnum, const wchar_t *label, int justify)
 
 wchar_t *slk_wlabel(int labnum)
 {
-    static wchar_t temp[33];
+    static PDC_TLS wchar_t temp[33];
     chtype *p;
     int i;
 
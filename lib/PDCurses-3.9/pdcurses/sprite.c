@@ -0,0 +1,228 @@
+/* PDCurses */
+
+#include <curspriv.h>
+
+/*man-start**************************************************************
+
+sprite
+------
+
+### Synopsis
+
+    PDC_SPRITE *new_sprite(const char *const *rows, int nlines,
+                           chtype attrs, char transparent);
+    int del_sprite(PDC_SPRITE *sprite);
+    int blit_sprite(int y, int x, const PDC_SPRITE *sprite);
+    int wblit_sprite(WINDOW *win, int y, int x, const PDC_SPRITE *sprite);
+
+### Description
+
+   A sprite is a block of multi-line text art that has been converted
+   once into chtypes, so that it can be drawn repeatedly without going
+   through the formatting and per-character processing of printw() or
+   addch().
+
+   new_sprite() builds a sprite from nlines strings. Each character is
+   combined with attrs (attributes and a color pair); every occurrence
+   of the transparent character becomes a hole, as do the cells past the
+   end of rows that are shorter than the widest one. Pass 0 for
+   transparent to make every character in the art opaque (e.g. when
+   spaces are meant to erase what is underneath).
+
+   del_sprite() frees the memory allocated by new_sprite().
+
+   wblit_sprite() copies the opaque cells of the sprite into the window,
+   with the upper left corner of the sprite at (y, x). The cursor is not
+   moved, and no control character translation, background merging or
+   scrolling is done. Parts of the sprite that fall outside the window
+   are clipped, so y and x may be negative. Each row that is touched has
+   its change markers updated once. blit_sprite() does the same for
+   stdscr.
+
+### Return Value
+
+   new_sprite() returns a pointer to the new sprite, or NULL on failure.
+   The other functions return OK, or ERR if an argument is invalid.
+   Blitting a sprite that lies wholly outside the window is not an
+   error.
+
+### Portability
+                             X/Open  ncurses  NetBSD
+    new_sprite                  -       -       -
+    del_sprite                  -       -       -
+    blit_sprite                 -       -       -
+    wblit_sprite                -       -       -
+
+**man-end****************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+
+PDC_SPRITE *new_sprite(const char *const *rows, int nlines,
+                       chtype attrs, char transparent)
+{
+    PDC_SPRITE *sprite;
+    chtype *cells;
+    unsigned char *mask;
+    int *first, *last;
+    int i, j, len, ncols;
+
+    PDC_LOG(("new_sprite() - called: nlines=%d\n", nlines));
+
+    if (!rows || nlines < 1)
+        return (PDC_SPRITE *)NULL;
+
+    for (i = 0, ncols = 0; i < nlines; i++)
+    {
+        if (!rows[i])
+            return (PDC_SPRITE *)NULL;
+
+        len = strlen(rows[i]);
+        if (len > ncols)
+            ncols = len;
+    }
+
+    if (!ncols)
+        return (PDC_SPRITE *)NULL;
+
+    /* one block: the header, the cells, the per-row extents, then the
+       mask (which has the weakest alignment) */
+
+    sprite = PDC_malloc(sizeof(PDC_SPRITE) + nlines * ncols * sizeof(chtype) +
+                    2 * nlines * sizeof(int) + nlines * ncols);
+    if (!sprite)
+        return sprite;
+
+    cells = (chtype *)(sprite + 1);
+    first = (int *)(cells + nlines * ncols);
+    last = first + nlines;
+    mask = (unsigned char *)(last + nlines);
+
+    attrs &= A_ATTRIBUTES;
+
+    for (i = 0; i < nlines; i++)
+    {
+        const char *src = rows[i];
+
+        first[i] = _NO_CHANGE;
+        last[i] = _NO_CHANGE;
+
+        for (j = 0; j < ncols; j++)
+        {
+            int opaque = *src && *src != transparent;
+
+            cells[i * ncols + j] = opaque ?
+                ((unsigned char)*src | attrs) : (' ' | attrs);
+            mask[i * ncols + j] = (unsigned char)opaque;
+
+            if (opaque)
+            {
+                if (first[i] == _NO_CHANGE)
+                    first[i] = j;
+
+                last[i] = j;
+            }
+
+            if (*src)
+                src++;
+        }
+    }
+
+    sprite->_maxy = nlines;
+    sprite->_maxx = ncols;
+    sprite->_cells = cells;
+    sprite->_mask = mask;
+    sprite->_first = first;
+    sprite->_last = last;
+
+    return sprite;
+}
+
+int del_sprite(PDC_SPRITE *sprite)
+{
+    PDC_LOG(("del_sprite() - called\n"));
+
+    if (!sprite)
+        return ERR;
+
+    PDC_free(sprite);
+
+    return OK;
+}
+
+int wblit_sprite(WINDOW *win, int y, int x, const PDC_SPRITE *sprite)
+{
+    int i, top, bottom;
+
+    PDC_LOG(("wblit_sprite() - called: win=%p y=%d x=%d\n", win, y, x));
+
+    if (!win || !sprite)
+        return ERR;
+
+    /* clip vertically once, then each row only against its own opaque
+       extent and the window edges */
+
+    top = max(0, -y);
+    bottom = min(sprite->_maxy, win->_maxy - y);
+
+    for (i = top; i < bottom; i++)
+    {
+        const chtype *src = sprite->_cells + i * sprite->_maxx;
+        const unsigned char *mask = sprite->_mask + i * sprite->_maxx;
+        chtype *dest;
+        int j, first, last, minx, maxx;
+
+        if (sprite->_first[i] == _NO_CHANGE)
+            continue;
+
+        first = max(sprite->_first[i], -x);
+        last = min(sprite->_last[i], win->_maxx - 1 - x);
+
+        if (first > last)
+            continue;
+
+        dest = win->_y[y + i] + x;
+        minx = maxx = _NO_CHANGE;
+
+        /* rows without holes in the visible span are a straight copy */
+
+        if (!memchr(mask + first, 0, last - first + 1))
+        {
+            if (memcmp(dest + first, src + first,
+                       (last - first + 1) * sizeof(chtype)))
+            {
+                memcpy(dest + first, src + first,
+                       (last - first + 1) * sizeof(chtype));
+                minx = first;
+                maxx = last;
+            }
+        }
+        else
+            for (j = first; j <= last; j++)
+                if (mask[j] && dest[j] != src[j])
+                {
+                    dest[j] = src[j];
+
+                    if (minx == _NO_CHANGE)
+                        minx = j;
+
+                    maxx = j;
+                }
+
+        if (minx == _NO_CHANGE)
+            continue;
+
+        PDC_mark_changed(win, y + i, minx + x, maxx + x);
+    }
+
+    PDC_sync(win);
+
+    return OK;
+}
+
+int blit_sprite(int y, int x, const PDC_SPRITE *sprite)
+{
+    PDC_LOG(("blit_sprite() - called: y=%d x=%d\n", y, x));
+
+    return wblit_sprite(stdscr, y, x, sprite);
+}
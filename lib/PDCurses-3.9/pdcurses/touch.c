@@ -70,10 +70,7 @@ int touchwin(WINDOW *win)
         return ERR;
 
     for (i = 0; i < win->_maxy; i++)
-    {
-        win->_firstch[i] = 0;
-        win->_lastch[i] = win->_maxx - 1;
-    }
+        PDC_mark_changed(win, i, 0, win->_maxx - 1);
 
     return OK;
 }
@@ -89,10 +86,7 @@ int touchline(WINDOW *win, int start, int count)
         return ERR;
 
     for (i = start; i < start + count; i++)
-    {
-        win->_firstch[i] = 0;
-        win->_lastch[i] = win->_maxx - 1;
-    }
+        PDC_mark_changed(win, i, 0, win->_maxx - 1);
 
     return OK;
 }
@@ -107,10 +101,7 @@ int untouchwin(WINDOW *win)
         return ERR;
 
     for (i = 0; i < win->_maxy; i++)
-    {
-        win->_firstch[i] = _NO_CHANGE;
-        win->_lastch[i] = _NO_CHANGE;
-    }
+        PDC_mark_unchanged(win, i);
 
     return OK;
 }
@@ -128,15 +119,9 @@ int wtouchln(WINDOW *win, int y, int n, int changed)
     for (i = y; i < y + n; i++)
     {
         if (changed)
-        {
-            win->_firstch[i] = 0;
-            win->_lastch[i] = win->_maxx - 1;
-        }
+            PDC_mark_changed(win, i, 0, win->_maxx - 1);
         else
-        {
-            win->_firstch[i] = _NO_CHANGE;
-            win->_lastch[i] = _NO_CHANGE;
-        }
+            PDC_mark_unchanged(win, i);
     }
 
     return OK;
@@ -190,10 +175,7 @@ int touchoverlap(const WINDOW *win1, WINDOW *win2)
     endx -= 1;
 
     for (y = starty; y < endy; y++)
-    {
-        win2->_firstch[y] = startx;
-        win2->_lastch[y] = endx;
-    }
+        PDC_mark_changed(win2, y, startx, endx);
 
     return OK;
 }
@@ -80,7 +80,7 @@ util
 
 char *unctrl(chtype c)
 {
-    static char strbuf[3] = {0, 0, 0};
+    static PDC_TLS char strbuf[3] = {0, 0, 0};
 
     chtype ic;
 
@@ -160,7 +160,7 @@ int setcchar(cchar_t *wcval, const wchar_t *wch, const attr_t attrs,
 
 wchar_t *wunctrl(cchar_t *wc)
 {
-    static wchar_t strbuf[3] = {0, 0, 0};
+    static PDC_TLS wchar_t strbuf[3] = {0, 0, 0};
 
     cchar_t ic;
 
@@ -89,7 +89,11 @@ window
    structure, it will free all allocated memory and return a NULL
    pointer.
 
-   PDC_makelines() allocates the memory for the lines.
+   PDC_makelines() allocates the memory for the lines. They are kept in
+   the same block as the line pointer and change marker arrays, one
+   line after another, so a window other than a subwindow costs two
+   allocations: the WINDOW structure and its storage. Resizing a window
+   replaces only the storage.
 
    PDC_sync() handles wrefresh() and wsyncup() calls when a window is
    changed.
@@ -132,50 +136,62 @@ window
 **man-end****************************************************************/
 
 #include <stdlib.h>
+#include <string.h>
 
-WINDOW *PDC_makenew(int nlines, int ncols, int begy, int begx)
-{
-    WINDOW *win;
+/* the cells of a window start on a boundary of this many bytes */
 
-    PDC_LOG(("PDC_makenew() - called: lines %d cols %d begy %d begx %d\n",
-             nlines, ncols, begy, begx));
+#define _CELL_ALIGN 64
 
-    /* allocate the window structure itself */
+/* Allocate, or reallocate, a window's storage as a single block: the
+   line pointer array, followed by the change bitmaps and the firstch and
+   lastch arrays, then (if cells is TRUE) all the lines' cells,
+   contiguously. Returns FALSE on failure, leaving the old block (if any)
+   unchanged. */
 
-    win = calloc(1, sizeof(WINDOW));
-    if (!win)
-        return win;
+static bool _makestorage(WINDOW *win, int nlines, int ncols, bool cells)
+{
+    size_t words = nlines * _DIRTY_WORDS(ncols);
+    size_t index = nlines * (sizeof(chtype *) + 2 * sizeof(int)) +
+                   words * sizeof(unsigned long);
+    size_t size = index;
+    chtype **block, *line;
+    bool fresh = !win->_y;
+    int i;
 
-    /* allocate the line pointer array */
+    if (cells)
+        size += _CELL_ALIGN + nlines * ncols * sizeof(chtype);
 
-    win->_y = malloc(nlines * sizeof(chtype *));
-    if (!win->_y)
-    {
-        free(win);
-        return (WINDOW *)NULL;
-    }
+    block = PDC_realloc(win->_y, size);
+    if (!block)
+        return FALSE;
 
-    /* allocate the minchng and maxchng arrays */
+    win->_y = block;
+    win->_dirty = (unsigned long *)(block + nlines);
+    win->_firstch = (int *)(win->_dirty + words);
+    win->_lastch = win->_firstch + nlines;
 
-    win->_firstch = malloc(nlines * sizeof(int));
-    if (!win->_firstch)
+    if (fresh)
     {
-        free(win->_y);
-        free(win);
-        return (WINDOW *)NULL;
+        memset(win->_dirty, 0, words * sizeof(unsigned long));
+
+        for (i = 0; i < nlines; i++)
+            win->_firstch[i] = win->_lastch[i] = _NO_CHANGE;
     }
 
-    win->_lastch = malloc(nlines * sizeof(int));
-    if (!win->_lastch)
+    if (cells)
     {
-        free(win->_firstch);
-        free(win->_y);
-        free(win);
-        return (WINDOW *)NULL;
+        line = (chtype *)(((size_t)((char *)block + index) +
+                          _CELL_ALIGN - 1) & ~(size_t)(_CELL_ALIGN - 1));
+
+        for (i = 0; i < nlines; i++, line += ncols)
+            win->_y[i] = line;
     }
 
-    /* initialize window variables */
+    return TRUE;
+}
 
+static void _initwin(WINDOW *win, int nlines, int ncols, int begy, int begx)
+{
     win->_maxy = nlines;  /* real max screen size */
     win->_maxx = ncols;   /* real max screen size */
     win->_begy = begy;
@@ -188,39 +204,54 @@ WINDOW *PDC_makenew(int nlines, int ncols, int begy, int begx)
     /* init to say window all changed */
 
     touchwin(win);
+}
+
+WINDOW *PDC_makenew(int nlines, int ncols, int begy, int begx)
+{
+    WINDOW *win;
+
+    PDC_LOG(("PDC_makenew() - called: lines %d cols %d begy %d begx %d\n",
+             nlines, ncols, begy, begx));
+
+    /* allocate the window structure itself */
+
+    win = PDC_calloc(1, sizeof(WINDOW));
+    if (!win)
+        return win;
+
+    /* allocate the line pointer, minchng and maxchng arrays */
+
+    if (!_makestorage(win, nlines, ncols, FALSE))
+    {
+        PDC_free(win);
+        return (WINDOW *)NULL;
+    }
+
+    /* initialize window variables */
+
+    _initwin(win, nlines, ncols, begy, begx);
 
     return win;
 }
 
 WINDOW *PDC_makelines(WINDOW *win)
 {
-    int i, j, nlines, ncols;
-
     PDC_LOG(("PDC_makelines() - called\n"));
 
     if (!win)
         return (WINDOW *)NULL;
 
-    nlines = win->_maxy;
-    ncols = win->_maxx;
+    /* grow the block from PDC_makenew() to hold the lines as well; the
+       change markers survive, as they sit ahead of the cells */
 
-    for (i = 0; i < nlines; i++)
+    if (!_makestorage(win, win->_maxy, win->_maxx, TRUE))
     {
-        win->_y[i] = malloc(ncols * sizeof(chtype));
-        if (!win->_y[i])
-        {
-            /* if error, free all the data */
+        /* if error, free all the data */
 
-            for (j = 0; j < i; j++)
-                free(win->_y[j]);
+        PDC_free(win->_y);
+        PDC_free(win);
 
-            free(win->_firstch);
-            free(win->_lastch);
-            free(win->_y);
-            free(win);
-
-            return (WINDOW *)NULL;
-        }
+        return (WINDOW *)NULL;
     }
 
     return win;
@@ -263,24 +294,16 @@ WINDOW *newwin(int nlines, int ncols, int begy, int begx)
 
 int delwin(WINDOW *win)
 {
-    int i;
-
     PDC_LOG(("delwin() - called\n"));
 
     if (!win)
         return ERR;
 
-    /* subwindows use parents' lines */
+    /* the lines, if the window has its own (subwindows use their
+       parents'), are in the same block as the line pointers */
 
-    if (!(win->_flags & (_SUBWIN|_SUBPAD)))
-        for (i = 0; i < win->_maxy && win->_y[i]; i++)
-            if (win->_y[i])
-                free(win->_y[i]);
-
-    free(win->_firstch);
-    free(win->_lastch);
-    free(win->_y);
-    free(win);
+    PDC_free(win->_y);
+    PDC_free(win);
 
     return OK;
 }
@@ -409,8 +432,7 @@ WINDOW *dupwin(WINDOW *win)
              ptr < new->_y[i] + ncols; ptr++, ptr1++)
             *ptr = *ptr1;
 
-        new->_firstch[i] = 0;
-        new->_lastch[i] = ncols - 1;
+        PDC_mark_changed(new, i, 0, ncols - 1);
     }
 
     new->_curx = win->_curx;
@@ -440,8 +462,8 @@ WINDOW *dupwin(WINDOW *win)
 
 WINDOW *resize_window(WINDOW *win, int nlines, int ncols)
 {
-    WINDOW *new;
-    int i, save_cury, save_curx, new_begy, new_begx;
+    WINDOW *new, tmp;
+    int save_cury, save_curx, new_begy, new_begx;
 
     PDC_LOG(("resize_window() - called: nlines %d ncols %d\n",
              nlines, ncols));
@@ -474,9 +496,16 @@ WINDOW *resize_window(WINDOW *win, int nlines, int ncols)
             new_begx = win->_begx;
         }
 
-        new = PDC_makenew(nlines, ncols, new_begy, new_begx);
-        if (!new)
+        /* the resized window keeps its WINDOW structure, so only its
+           storage needs allocating */
+
+        memset(&tmp, 0, sizeof(WINDOW));
+
+        if (!_makestorage(&tmp, nlines, ncols, TRUE))
             return (WINDOW *)NULL;
+
+        new = &tmp;
+        _initwin(new, nlines, ncols, new_begy, new_begx);
     }
 
     save_curx = min(win->_curx, (new->_maxx - 1));
@@ -484,18 +513,10 @@ WINDOW *resize_window(WINDOW *win, int nlines, int ncols)
 
     if (!(win->_flags & (_SUBPAD|_SUBWIN)))
     {
-        new = PDC_makelines(new);
-        if (!new)
-            return (WINDOW *)NULL;
-
         werase(new);
 
         copywin(win, new, 0, 0, 0, 0, min(win->_maxy, new->_maxy) - 1,
                 min(win->_maxx, new->_maxx) - 1, FALSE);
-
-        for (i = 0; i < win->_maxy && win->_y[i]; i++)
-            if (win->_y[i])
-                free(win->_y[i]);
     }
 
     new->_flags = win->_flags;
@@ -517,12 +538,12 @@ WINDOW *resize_window(WINDOW *win, int nlines, int ncols)
     new->_curx = save_curx;
     new->_cury = save_cury;
 
-    free(win->_firstch);
-    free(win->_lastch);
-    free(win->_y);
+    PDC_free(win->_y);
 
     *win = *new;
-    free(new);
+
+    if (new != &tmp)
+        PDC_free(new);
 
     return win;
 }
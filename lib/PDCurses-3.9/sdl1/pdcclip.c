@@ -62,7 +62,7 @@ int PDC_getclipboard(char **contents, long *length)
         return PDC_CLIP_EMPTY;
 
     len = strlen(pdc_SDL_clipboard);
-    if ((*contents = malloc(len + 1)) == NULL)
+    if ((*contents = PDC_malloc(len + 1)) == NULL)
         return PDC_CLIP_MEMORY_ERROR;
 
     strcpy(*contents, pdc_SDL_clipboard);
@@ -77,13 +77,13 @@ int PDC_setclipboard(const char *contents, long length)
 
     if (pdc_SDL_clipboard)
     {
-        free(pdc_SDL_clipboard);
+        PDC_free(pdc_SDL_clipboard);
         pdc_SDL_clipboard = NULL;
     }
 
     if (contents)
     {
-        if ((pdc_SDL_clipboard = malloc(length + 1)) == NULL)
+        if ((pdc_SDL_clipboard = PDC_malloc(length + 1)) == NULL)
             return PDC_CLIP_MEMORY_ERROR;
 
         strcpy(pdc_SDL_clipboard, contents);
@@ -111,7 +111,7 @@ int PDC_freeclipboard(char *contents)
         if (strlen(contents) >= strlen("PDCURSES"))
             strcpy(contents, "PDCURSES");
 
-        free(contents);
+        PDC_free(contents);
     }
 
     return PDC_CLIP_SUCCESS;
@@ -123,7 +123,7 @@ int PDC_clearclipboard(void)
 
     if (pdc_SDL_clipboard)
     {
-        free(pdc_SDL_clipboard);
+        PDC_free(pdc_SDL_clipboard);
         pdc_SDL_clipboard = NULL;
     }
 
@@ -29,6 +29,8 @@ void PDC_update_rects(void)
 {
     if (rectcount)
     {
+        unsigned long start = PDC_TRACE_START();
+
         /* if the maximum number of rects has been reached, we're
            probably better off doing a full screen update */
 
@@ -37,6 +39,9 @@ void PDC_update_rects(void)
         else
             SDL_UpdateRects(pdc_screen, rectcount, uprect);
 
+        PDC_TRACE_SPAN(PDC_SPAN_UPDATE_RECTS, start, rectcount, 0);
+        PDC_count_update(rectcount);
+
         pdc_lastupdate = SDL_GetTicks();
         rectcount = 0;
     }
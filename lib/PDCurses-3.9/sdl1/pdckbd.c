@@ -121,6 +121,21 @@ bool PDC_check_key(void)
     return haveevent;
 }
 
+/* no way to sleep on input here, so nap in short steps and let
+   wgetch() check again */
+
+int PDC_wait_input(int ms)
+{
+    PDC_LOG(("PDC_wait_input() - called: ms=%d\n", ms));
+
+    if (ms < 0 || ms > 50)
+        ms = 50;
+
+    napms(ms);
+
+    return ms;
+}
+
 static int _process_key_event(void)
 {
     int i, key = 0;
@@ -311,7 +326,7 @@ static int _process_mouse_event(void)
 
         /* check for a click -- a press followed immediately by a release */
 
-        if (action == BUTTON_PRESSED && SP->mouse_wait)
+        if (action == BUTTON_PRESSED && PDC_click_wanted(btn - 1))
         {
             SDL_Event rel;
 
@@ -345,6 +360,8 @@ static int _process_mouse_event(void)
 
 int PDC_get_key(void)
 {
+    SP->key_time = PDC_get_ticks();
+
     switch (event.type)
     {
     case SDL_QUIT:
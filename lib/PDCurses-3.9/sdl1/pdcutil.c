@@ -16,6 +16,11 @@ void PDC_napms(int ms)
     SDL_Delay(ms);
 }
 
+unsigned long PDC_get_ticks(void)
+{
+    return SDL_GetTicks() * 1000UL;
+}
+
 const char *PDC_sysname(void)
 {
     return "SDL";
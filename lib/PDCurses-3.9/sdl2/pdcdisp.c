@@ -11,17 +11,151 @@
 # include "../common/acs437.h"
 #endif
 
-Uint32 pdc_lastupdate = 0;
+PDC_TLS Uint32 pdc_lastupdate = 0;
 
 #define MAXRECT 200     /* maximum number of rects to queue up before
-                           an update is forced; the number was chosen
-                           arbitrarily */
+                           they are merged bin by bin; the number was
+                           chosen arbitrarily */
+
+/* The screen is divided into a grid of bins, and each rect belongs to
+   the bin that its upper left corner falls in. A new rect is merged
+   with the last one queued in its bin if the pixels that the merged
+   rect adds, beyond those of the two, are no more than RECTWASTE
+   percent of it. */
+
+#define RECTBINX 16     /* bins across the screen */
+#define RECTBINY 8      /* bins down the screen */
+#define RECTWASTE 25    /* percentage of a merged rect that may be
+                           undamaged */
+
+/* The pending rects and the drawing state belong to the screen being
+   drawn, so with PDC_THREADS each thread has its own */
+
+static PDC_TLS SDL_Rect uprect[MAXRECT];    /* table of rects to update */
+static PDC_TLS int binrect[RECTBINY][RECTBINX];
+                                    /* 1 + index into uprect of the last
+                                       rect in each bin, or 0 */
+static PDC_TLS chtype oldch = (chtype)(-1); /* current attribute */
+static PDC_TLS int rectcount = 0;           /* index into uprect */
+static PDC_TLS short foregr = -2, backgr = -2;
+                                    /* current foreground, background */
+#ifndef PDC_WIDE
+static PDC_TLS short palfg = -2, palbg = -2;
+                                    /* colors in the font palette */
+#endif
+static PDC_TLS bool blinked_off = FALSE;
+
+/* Glyphs are drawn from a cache of pre-colored tiles, keyed by the glyph
+   (with its font style) and its colors, so that each cell is a single
+   blit with no palette changes. The tiles are rendered into an atlas
+   surface, in the format of pdc_screen, the first time they're needed.
+   The cache is direct-mapped: a glyph that collides with another one
+   replaces its tile. */
+
+#define GLYPHCACHE 1024 /* tiles in the atlas; a multiple of GLYPHROW */
+#define GLYPHROW 32     /* tiles in each row of the atlas */
+
+static PDC_TLS SDL_Surface *glyphatlas = NULL;
+static PDC_TLS struct {chtype ch; short fg, bg;} glyphkey[GLYPHCACHE];
+
+static int *_rect_bin(const SDL_Rect *rect)
+{
+    int x = rect->x * RECTBINX / max(pdc_screen->w, 1);
+    int y = rect->y * RECTBINY / max(pdc_screen->h, 1);
+
+    return &binrect[max(0, min(y, RECTBINY - 1))]
+                   [max(0, min(x, RECTBINX - 1))];
+}
+
+static long _rect_area(const SDL_Rect *rect)
+{
+    return (long)rect->w * rect->h;
+}
+
+static void _rect_union(SDL_Rect *dest, const SDL_Rect *rect)
+{
+    int x2 = max(dest->x + dest->w, rect->x + rect->w);
+    int y2 = max(dest->y + dest->h, rect->y + rect->h);
+
+    dest->x = min(dest->x, rect->x);
+    dest->y = min(dest->y, rect->y);
+    dest->w = x2 - dest->x;
+    dest->h = y2 - dest->y;
+}
+
+/* merge rect into dest if little enough would be wasted by it */
+
+static bool _rect_merge(SDL_Rect *dest, const SDL_Rect *rect)
+{
+    SDL_Rect merged = *dest;
+    long area, overlap = 0;
+    int w, h;
+
+    _rect_union(&merged, rect);
+
+    w = min(dest->x + dest->w, rect->x + rect->w) - max(dest->x, rect->x);
+    h = min(dest->y + dest->h, rect->y + rect->h) - max(dest->y, rect->y);
+
+    if (w > 0 && h > 0)
+        overlap = (long)w * h;
 
-static SDL_Rect uprect[MAXRECT];       /* table of rects to update */
-static chtype oldch = (chtype)(-1);    /* current attribute */
-static int rectcount = 0;              /* index into uprect */
-static short foregr = -2, backgr = -2; /* current foreground, background */
-static bool blinked_off = FALSE;
+    area = _rect_area(&merged);
+
+    if ((area - _rect_area(dest) - _rect_area(rect) + overlap) * 100 >
+        area * RECTWASTE)
+        return FALSE;
+
+    *dest = merged;
+
+    return TRUE;
+}
+
+/* when the table is full, merge everything in each bin into one rect,
+   however much that wastes */
+
+static void _coalesce_rects(void)
+{
+    int i, count = 0;
+
+    memset(binrect, 0, sizeof(binrect));
+
+    for (i = 0; i < rectcount; i++)
+    {
+        int *bin = _rect_bin(uprect + i);
+
+        if (*bin)
+            _rect_union(uprect + *bin - 1, uprect + i);
+        else
+        {
+            uprect[count] = uprect[i];
+            *bin = ++count;
+        }
+    }
+
+    rectcount = count;
+}
+
+static void _add_rect(const SDL_Rect *rect)
+{
+    int *bin = _rect_bin(rect);
+
+    if (*bin && _rect_merge(uprect + *bin - 1, rect))
+        return;
+
+    if (rectcount == MAXRECT)
+    {
+        _coalesce_rects();
+
+        if (*bin)
+        {
+            _rect_union(uprect + *bin - 1, rect);
+            return;
+        }
+    }
+
+    uprect[rectcount++] = *rect;
+    *bin = rectcount;
+}
 
 /* do the real updates on a delay */
 
@@ -31,49 +165,46 @@ void PDC_update_rects(void)
 
     if (rectcount)
     {
-        /* if the maximum number of rects has been reached, we're
-           probably better off doing a full screen update */
+        int w = pdc_screen->w;
+        int h = pdc_screen->h;
+        unsigned long start = PDC_TRACE_START();
 
-        if (rectcount == MAXRECT)
-            SDL_UpdateWindowSurface(pdc_window);
-        else
+        for (i = 0; i < rectcount; i++)
         {
-            int w = pdc_screen->w;
-            int h = pdc_screen->h;
-
-            for (i = 0; i < rectcount; i++)
+            if (uprect[i].x > w ||
+                uprect[i].y > h ||
+                !uprect[i].w || !uprect[i].h)
             {
-                if (uprect[i].x > w ||
-                    uprect[i].y > h ||
-                    !uprect[i].w || !uprect[i].h)
+                if (i + 1 < rectcount)
                 {
-                    if (i + 1 < rectcount)
-                    {
-                        memmove(uprect + i, uprect + i + 1,
-                                (rectcount - i + 1) * sizeof(*uprect));
-                        --i;
-                    }
-                    rectcount--;
-                    continue;
+                    memmove(uprect + i, uprect + i + 1,
+                            (rectcount - i - 1) * sizeof(*uprect));
+                    --i;
                 }
-
-                if (uprect[i].x + uprect[i].w > w)
-                    uprect[i].w = min(w, w - uprect[i].x);
-
-                if (uprect[i].y + uprect[i].h > h)
-                    uprect[i].h = min(h, h - uprect[i].y);
+                rectcount--;
+                continue;
             }
 
-            if (rectcount > 0)
-                SDL_UpdateWindowSurfaceRects(pdc_window, uprect, rectcount);
+            if (uprect[i].x + uprect[i].w > w)
+                uprect[i].w = min(w, w - uprect[i].x);
+
+            if (uprect[i].y + uprect[i].h > h)
+                uprect[i].h = min(h, h - uprect[i].y);
         }
 
+        if (rectcount > 0)
+            SDL_UpdateWindowSurfaceRects(pdc_window, uprect, rectcount);
+
+        PDC_TRACE_SPAN(PDC_SPAN_UPDATE_RECTS, start, rectcount, 0);
+        PDC_count_update(rectcount);
+
         pdc_lastupdate = SDL_GetTicks();
         rectcount = 0;
+        memset(binrect, 0, sizeof(binrect));
     }
 }
 
-/* set the font colors to match the chtype's attribute */
+/* set the current colors to match the chtype's attribute */
 
 static void _set_attr(chtype ch)
 {
@@ -110,34 +241,180 @@ static void _set_attr(chtype ch)
             newbg = tmp;
         }
 
-        if (newfg != foregr)
-        {
+        foregr = newfg;
+        backgr = newbg;
+
+        oldch = ch;
+    }
+}
+
 #ifndef PDC_WIDE
+
+/* set the font palette to the current colors, for drawing straight
+   from the font */
+
+static void _set_palette(void)
+{
+    if (SP->mono)
+        return;
+
+    if (foregr != palfg)
+    {
+        SDL_SetPaletteColors(pdc_font->format->palette,
+                             pdc_color + foregr, pdc_flastc, 1);
+        palfg = foregr;
+    }
+
+    if (backgr != palbg)
+    {
+        if (backgr == -1)
+            SDL_SetColorKey(pdc_font, SDL_TRUE, 0);
+        else
+        {
+            if (palbg == -1)
+                SDL_SetColorKey(pdc_font, SDL_FALSE, 0);
+
             SDL_SetPaletteColors(pdc_font->format->palette,
-                                 pdc_color + newfg, pdc_flastc, 1);
-#endif
-            foregr = newfg;
+                                 pdc_color + backgr, 0, 1);
         }
 
-        if (newbg != backgr)
-        {
-#ifndef PDC_WIDE
-            if (newbg == -1)
-                SDL_SetColorKey(pdc_font, SDL_TRUE, 0);
-            else
-            {
-                if (backgr == -1)
-                    SDL_SetColorKey(pdc_font, SDL_FALSE, 0);
+        palbg = backgr;
+    }
+}
 
-                SDL_SetPaletteColors(pdc_font->format->palette,
-                                     pdc_color + newbg, 0, 1);
-            }
 #endif
-            backgr = newbg;
-        }
 
-        oldch = ch;
+/* discard the glyph cache, e.g. when a color has been changed */
+
+void PDC_flush_glyphs(void)
+{
+    if (glyphatlas)
+    {
+        SDL_FreeSurface(glyphatlas);
+        glyphatlas = NULL;
+    }
+}
+
+/* render ch in the current colors into tile in the atlas */
+
+static void _render_glyph(chtype ch, SDL_Rect *tile)
+{
+#ifdef PDC_WIDE
+    Uint16 chstr[2] = {0, 0};
+    SDL_Surface *glyph;
+    int oldstyle;
+
+    SDL_FillRect(glyphatlas, tile, pdc_mapped[backgr]);
+
+    chstr[0] = ch & A_CHARTEXT;
+
+    if (chstr[0] == ' ')
+        return;
+
+    /* the font's style is shared with _set_attr(), so put it back */
+
+    oldstyle = TTF_GetFontStyle(pdc_ttffont);
+
+    TTF_SetFontStyle(pdc_ttffont, ((ch & A_BOLD) ? TTF_STYLE_BOLD : 0) |
+                                  ((ch & A_ITALIC) ? TTF_STYLE_ITALIC : 0));
+
+    glyph = TTF_RenderUNICODE_Blended(pdc_ttffont, chstr,
+                                      pdc_color[foregr]);
+
+    TTF_SetFontStyle(pdc_ttffont, oldstyle);
+
+    if (glyph)
+    {
+        /* SDL_BlitSurface() clips its destination rect, and the caller
+           still needs the whole tile, so blit to a copy */
+
+        SDL_Rect src = *tile, dest = *tile;
+        int center = pdc_fwidth > glyph->w ?
+            (pdc_fwidth - glyph->w) >> 1 : 0;
+
+        src.x = src.y = 0;
+        src.w -= center;
+        dest.x += center;
+        SDL_BlitSurface(glyph, &src, glyphatlas, &dest);
+        SDL_FreeSurface(glyph);
+    }
+#else
+    SDL_Rect src, dest = *tile;
+
+    src.x = (ch & 0xff) % 32 * pdc_fwidth;
+    src.y = (ch & 0xff) / 32 * pdc_fheight;
+    src.w = pdc_fwidth;
+    src.h = pdc_fheight;
+
+    _set_palette();
+    SDL_BlitSurface(pdc_font, &src, glyphatlas, &dest);
+#endif
+}
+
+/* Draw ch at dest from the glyph cache. Returns FALSE if it can't be
+   used, i.e. for "transparent" cells, which are drawn over the
+   background instead, and in monochrome. */
+
+static bool _blit_glyph(chtype ch, attr_t attr, SDL_Rect *dest)
+{
+    SDL_PixelFormat *fmt = pdc_screen->format;
+    SDL_Rect tile;
+    unsigned long slot;
+
+    if (SP->mono || backgr == -1)
+        return FALSE;
+
+    if (!glyphatlas || glyphatlas->format->format != fmt->format ||
+        glyphatlas->w != GLYPHROW * pdc_fwidth)
+    {
+        int i;
+
+        PDC_flush_glyphs();
+
+        glyphatlas = SDL_CreateRGBSurface(0, GLYPHROW * pdc_fwidth,
+            GLYPHCACHE / GLYPHROW * pdc_fheight, fmt->BitsPerPixel,
+            fmt->Rmask, fmt->Gmask, fmt->Bmask, fmt->Amask);
+
+        if (!glyphatlas)
+            return FALSE;
+
+        SDL_SetSurfaceBlendMode(glyphatlas, SDL_BLENDMODE_NONE);
+
+        for (i = 0; i < GLYPHCACHE; i++)
+            glyphkey[i].bg = -1;
     }
+
+#ifdef PDC_WIDE
+    ch &= A_CHARTEXT;
+
+    if ((attr & A_BOLD) && (SP->termattrs & A_BOLD))
+        ch |= A_BOLD;
+    if ((attr & A_ITALIC) && (SP->termattrs & A_ITALIC))
+        ch |= A_ITALIC;
+#else
+    ch &= 0xff;
+#endif
+
+    slot = (((unsigned long)ch * 31 + foregr) * 31 + backgr) % GLYPHCACHE;
+
+    tile.x = slot % GLYPHROW * pdc_fwidth;
+    tile.y = slot / GLYPHROW * pdc_fheight;
+    tile.w = pdc_fwidth;
+    tile.h = pdc_fheight;
+
+    if (glyphkey[slot].ch != ch || glyphkey[slot].fg != foregr ||
+        glyphkey[slot].bg != backgr)
+    {
+        _render_glyph(ch, &tile);
+
+        glyphkey[slot].ch = ch;
+        glyphkey[slot].fg = foregr;
+        glyphkey[slot].bg = backgr;
+    }
+
+    SDL_BlitSurface(glyphatlas, &tile, pdc_screen, dest);
+
+    return TRUE;
 }
 
 #ifdef PDC_WIDE
@@ -323,21 +600,17 @@ void PDC_gotoyx(int row, int col)
     src.x = (ch & 0xff) % 32 * pdc_fwidth;
     src.y = (ch & 0xff) / 32 * pdc_fheight + (pdc_fheight - src.h);
 
+    _set_palette();
     SDL_BlitSurface(pdc_font, &src, pdc_screen, &dest);
 #endif
 
     if (oldrow != row || oldcol != col)
-    {
-        if (rectcount == MAXRECT)
-            PDC_update_rects();
-
-        uprect[rectcount++] = dest;
-    }
+        _add_rect(&dest);
 }
 
 void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
 {
-    SDL_Rect src, dest, lastrect;
+    SDL_Rect src, dest;
     int j;
 #ifdef PDC_WIDE
     Uint16 chstr[2] = {0, 0};
@@ -346,9 +619,6 @@ void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
     short hcol = SP->line_color;
     bool blink = blinked_off && (attr & A_BLINK) && (sysattrs & A_BLINK);
 
-    if (rectcount == MAXRECT)
-        PDC_update_rects();
-
 #ifdef PDC_WIDE
     src.x = 0;
     src.y = 0;
@@ -361,23 +631,10 @@ void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
     dest.h = pdc_fheight;
     dest.w = pdc_fwidth * len;
 
-    /* if the previous rect was just above this one, with the same width
-       and horizontal position, then merge the new one with it instead
-       of adding a new entry */
+    /* merge the new rect with what is already queued near it, if
+       that wastes little enough */
 
-    if (rectcount)
-        lastrect = uprect[rectcount - 1];
-
-    if (rectcount && lastrect.x == dest.x && lastrect.w == dest.w)
-    {
-        if (lastrect.y + lastrect.h == dest.y)
-            uprect[rectcount - 1].h = lastrect.h + pdc_fheight;
-        else
-            if (lastrect.y != dest.y)
-                uprect[rectcount++] = dest;
-    }
-    else
-        uprect[rectcount++] = dest;
+    _add_rect(&dest);
 
     _set_attr(attr);
 
@@ -412,37 +669,44 @@ void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
             ch = acs_map[ch & 0x7f];
         }
 
-#ifdef PDC_WIDE
-        ch &= A_CHARTEXT;
+        /* draw from the glyph cache if possible, or else straight from
+           the font */
 
-        if (ch != ' ')
+        if (!_blit_glyph(ch, attr, &dest))
         {
-            if (chstr[0] != ch)
+#ifdef PDC_WIDE
+            ch &= A_CHARTEXT;
+
+            if (ch != ' ')
             {
-                chstr[0] = ch;
+                if (chstr[0] != ch)
+                {
+                    chstr[0] = ch;
 
-                if (pdc_font)
-                    SDL_FreeSurface(pdc_font);
+                    if (pdc_font)
+                        SDL_FreeSurface(pdc_font);
 
-                pdc_font = TTF_RenderUNICODE_Blended(pdc_ttffont, chstr,
-                                                     pdc_color[foregr]);
-            }
+                    pdc_font = TTF_RenderUNICODE_Blended(pdc_ttffont, chstr,
+                                                         pdc_color[foregr]);
+                }
 
-            if (pdc_font)
-            {
-                int center = pdc_fwidth > pdc_font->w ?
-                    (pdc_fwidth - pdc_font->w) >> 1 : 0;
-                dest.x += center;
-                SDL_BlitSurface(pdc_font, &src, pdc_screen, &dest);
-                dest.x -= center;
+                if (pdc_font)
+                {
+                    int center = pdc_fwidth > pdc_font->w ?
+                        (pdc_fwidth - pdc_font->w) >> 1 : 0;
+                    dest.x += center;
+                    SDL_BlitSurface(pdc_font, &src, pdc_screen, &dest);
+                    dest.x -= center;
+                }
             }
-        }
 #else
-        src.x = (ch & 0xff) % 32 * pdc_fwidth;
-        src.y = (ch & 0xff) / 32 * pdc_fheight;
+            src.x = (ch & 0xff) % 32 * pdc_fwidth;
+            src.y = (ch & 0xff) / 32 * pdc_fheight;
 
-        SDL_BlitSurface(pdc_font, &src, pdc_screen, &dest);
+            _set_palette();
+            SDL_BlitSurface(pdc_font, &src, pdc_screen, &dest);
 #endif
+        }
 
         if (!blink && (attr & (A_LEFT | A_RIGHT)))
         {
@@ -521,7 +785,7 @@ static Uint32 _blink_timer(Uint32 interval, void *param)
 
 void PDC_blink_text(void)
 {
-    static SDL_TimerID blinker_id = 0;
+    static PDC_TLS SDL_TimerID blinker_id = 0;
     int i, j, k;
 
     oldch = (chtype)(-1);
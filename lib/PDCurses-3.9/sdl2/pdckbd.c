@@ -25,9 +25,12 @@ pdckbd
 #include <ctype.h>
 #include <string.h>
 
-static SDL_Event event;
-static SDL_Keycode oldkey;
-static MOUSE_STATUS old_mouse_status;
+/* the event being read, and what the last one left, belong to the
+   screen's window, so with PDC_THREADS each thread has its own */
+
+static PDC_TLS SDL_Event event;
+static PDC_TLS SDL_Keycode oldkey;
+static PDC_TLS MOUSE_STATUS old_mouse_status;
 
 static struct
 {
@@ -130,6 +133,21 @@ bool PDC_check_key(void)
     return haveevent;
 }
 
+/* wait for an SDL event, for at most ms milliseconds; the event is
+   left in the queue for PDC_check_key() */
+
+int PDC_wait_input(int ms)
+{
+    Uint32 start = SDL_GetTicks();
+
+    PDC_LOG(("PDC_wait_input() - called: ms=%d\n", ms));
+
+    PDC_update_rects();
+    SDL_WaitEventTimeout(NULL, ms);
+
+    return SDL_GetTicks() - start;
+}
+
 #ifdef PDC_WIDE
 static int _utf8_to_unicode(char *chstr, size_t *b)
 {
@@ -360,12 +378,14 @@ static int _process_mouse_event(void)
         SP->mouse_status.x = (event.motion.x - pdc_xoffset) / pdc_fwidth;
         SP->mouse_status.y = (event.motion.y - pdc_yoffset) / pdc_fheight;
 
-        if (!event.motion.state ||
-           (SP->mouse_status.x == old_mouse_status.x &&
-            SP->mouse_status.y == old_mouse_status.y))
+        if (SP->mouse_status.x == old_mouse_status.x &&
+            SP->mouse_status.y == old_mouse_status.y)
             return -1;
 
-        SP->mouse_status.changes = PDC_MOUSE_MOVED;
+        /* a move with no button down is a position report */
+
+        SP->mouse_status.changes = event.motion.state ?
+            PDC_MOUSE_MOVED : PDC_MOUSE_POSITION;
 
         for (i = 0; i < 3; i++)
         {
@@ -405,13 +425,13 @@ static int _process_mouse_event(void)
 
         /* check for a click -- a press followed immediately by a release */
 
-        if (action == BUTTON_PRESSED && SP->mouse_wait)
+        if (action == BUTTON_PRESSED && PDC_click_wanted(btn - 1))
         {
             SDL_Event rel;
 
-            napms(SP->mouse_wait);
+            PDC_update_rects();
 
-            if (SDL_PollEvent(&rel))
+            if (SDL_WaitEventTimeout(&rel, SP->mouse_wait))
             {
                 if (rel.type == SDL_MOUSEBUTTONUP && rel.button.button == btn)
                     action = BUTTON_CLICKED;
@@ -439,6 +459,8 @@ static int _process_mouse_event(void)
 
 int PDC_get_key(void)
 {
+    SP->key_time = PDC_get_ticks();
+
     switch (event.type)
     {
     case SDL_QUIT:
@@ -18,8 +18,8 @@
 #   define PDC_FONT_PATH "/usr/share/fonts/truetype/dejavu/DejaVuSansMono.ttf"
 #  endif
 # endif
-TTF_Font *pdc_ttffont = NULL;
-int pdc_font_size =
+PDC_TLS TTF_Font *pdc_ttffont = NULL;
+PDC_TLS int pdc_font_size =
 # ifdef _WIN32
  16;
 # else
@@ -27,19 +27,20 @@ int pdc_font_size =
 # endif
 #endif
 
-SDL_Window *pdc_window = NULL;
-SDL_Surface *pdc_screen = NULL, *pdc_font = NULL, *pdc_icon = NULL,
-            *pdc_back = NULL, *pdc_tileback = NULL;
-int pdc_sheight = 0, pdc_swidth = 0, pdc_yoffset = 0, pdc_xoffset = 0;
+PDC_TLS SDL_Window *pdc_window = NULL;
+PDC_TLS SDL_Surface *pdc_screen = NULL, *pdc_font = NULL, *pdc_icon = NULL,
+                    *pdc_back = NULL, *pdc_tileback = NULL;
+PDC_TLS int pdc_sheight = 0, pdc_swidth = 0, pdc_yoffset = 0,
+            pdc_xoffset = 0;
 
-SDL_Color pdc_color[PDC_MAXCOL];
-Uint32 pdc_mapped[PDC_MAXCOL];
-int pdc_fheight, pdc_fwidth, pdc_fthick, pdc_flastc;
-bool pdc_own_window;
+PDC_TLS SDL_Color pdc_color[PDC_MAXCOL];
+PDC_TLS Uint32 pdc_mapped[PDC_MAXCOL];
+PDC_TLS int pdc_fheight, pdc_fwidth, pdc_fthick, pdc_flastc;
+PDC_TLS bool pdc_own_window;
 
 /* COLOR_PAIR to attribute encoding table. */
 
-static struct {short f, b;} atrtab[PDC_COLOR_PAIRS];
+static PDC_TLS struct {short f, b;} atrtab[PDC_COLOR_PAIRS];
 
 static void _clean(void)
 {
@@ -50,6 +51,7 @@ static void _clean(void)
         TTF_Quit();
     }
 #endif
+    PDC_flush_glyphs();
     SDL_FreeSurface(pdc_tileback);
     SDL_FreeSurface(pdc_back);
     SDL_FreeSurface(pdc_icon);
@@ -98,7 +100,7 @@ void PDC_scr_close(void)
 void PDC_scr_free(void)
 {
     if (SP)
-        free(SP);
+        PDC_free(SP);
 }
 
 static void _initialize_colors(void)
@@ -142,7 +144,7 @@ int PDC_scr_open(int argc, char **argv)
 {
     PDC_LOG(("PDC_scr_open() - called\n"));
 
-    SP = calloc(1, sizeof(SCREEN));
+    SP = PDC_calloc(1, sizeof(SCREEN));
 
     if (!SP)
         return ERR;
@@ -425,5 +427,7 @@ int PDC_init_color(short color, short red, short green, short blue)
     pdc_mapped[color] = SDL_MapRGB(pdc_screen->format, pdc_color[color].r,
                                    pdc_color[color].g, pdc_color[color].b);
 
+    PDC_flush_glyphs();
+
     return OK;
 }
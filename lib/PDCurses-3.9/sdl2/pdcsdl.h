@@ -7,30 +7,36 @@
 
 #include <curspriv.h>
 
+/* The window, its surfaces and font belong to the screen, so with
+   PDC_THREADS each thread has its own, like the glyph atlas drawn from
+   them */
+
 #ifdef PDC_WIDE
-PDCEX  TTF_Font *pdc_ttffont;
-PDCEX  int pdc_font_size;
+PDCEX  PDC_TLS TTF_Font *pdc_ttffont;
+PDCEX  PDC_TLS int pdc_font_size;
 #endif
-PDCEX  SDL_Window *pdc_window;
-PDCEX  SDL_Surface *pdc_screen, *pdc_font, *pdc_icon, *pdc_back;
-PDCEX  int pdc_sheight, pdc_swidth, pdc_yoffset, pdc_xoffset;
-
-extern SDL_Surface *pdc_tileback;    /* used to regenerate the background
-                                        of "transparent" cells */
-extern SDL_Color pdc_color[PDC_MAXCOL];  /* colors for font palette */
-extern Uint32 pdc_mapped[PDC_MAXCOL];    /* colors for FillRect(), as
-                                            used in _highlight() */
-extern int pdc_fheight, pdc_fwidth;  /* font height and width */
-extern int pdc_fthick;               /* thickness for highlights and
-                                        rendered ACS glyphs */
-extern int pdc_flastc;               /* font palette's last color
-                                        (treated as the foreground) */
-extern bool pdc_own_window;          /* if pdc_window was not set
-                                        before initscr(), PDCurses is
-                                        responsible for (owns) it */
-extern Uint32 pdc_lastupdate;        /* time of last update, in ticks */
+PDCEX  PDC_TLS SDL_Window *pdc_window;
+PDCEX  PDC_TLS SDL_Surface *pdc_screen, *pdc_font, *pdc_icon, *pdc_back;
+PDCEX  PDC_TLS int pdc_sheight, pdc_swidth, pdc_yoffset, pdc_xoffset;
+
+/* used to regenerate the background of "transparent" cells */
+extern PDC_TLS SDL_Surface *pdc_tileback;
+
+extern PDC_TLS SDL_Color pdc_color[PDC_MAXCOL]; /* colors for font palette */
+extern PDC_TLS Uint32 pdc_mapped[PDC_MAXCOL];   /* colors for FillRect(), as
+                                                   used in _highlight() */
+extern PDC_TLS int pdc_fheight, pdc_fwidth; /* font height and width */
+extern PDC_TLS int pdc_fthick;      /* thickness for highlights and
+                                       rendered ACS glyphs */
+extern PDC_TLS int pdc_flastc;      /* font palette's last color
+                                       (treated as the foreground) */
+extern PDC_TLS bool pdc_own_window; /* if pdc_window was not set
+                                       before initscr(), PDCurses is
+                                       responsible for (owns) it */
+extern PDC_TLS Uint32 pdc_lastupdate;   /* time of last update, in ticks */
 
 PDCEX  void PDC_update_rects(void);
 PDCEX  void PDC_retile(void);
 
 extern void PDC_blink_text(void);
+extern void PDC_flush_glyphs(void);
@@ -16,6 +16,20 @@ void PDC_napms(int ms)
     SDL_Delay(ms);
 }
 
+unsigned long PDC_get_ticks(void)
+{
+    static Uint64 freq = 0;
+    Uint64 now;
+
+    if (!freq)
+        freq = SDL_GetPerformanceFrequency();
+
+    now = SDL_GetPerformanceCounter();
+
+    return (unsigned long)((now / freq) * 1000000 +
+        (now % freq) * 1000000 / freq);
+}
+
 const char *PDC_sysname(void)
 {
     return "SDL2";
@@ -13,9 +13,9 @@
 /* You could #include pdcsdl.h, or just add the relevant declarations
    here: */
 
-PDCEX SDL_Window *pdc_window;
-PDCEX SDL_Surface *pdc_screen;
-PDCEX int pdc_yoffset;
+PDCEX PDC_TLS SDL_Window *pdc_window;
+PDCEX PDC_TLS SDL_Surface *pdc_screen;
+PDCEX PDC_TLS int pdc_yoffset;
 
 int main(int argc, char **argv)
 {
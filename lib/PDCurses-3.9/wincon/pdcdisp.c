@@ -196,6 +196,7 @@ void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
 #else
         WriteConsoleA(pdc_con_out, buffer, len, NULL, NULL);
 #endif
+        PDC_count_bytes(sizeof(buffer[0]) * len);
     }
     else
     {
@@ -242,6 +243,7 @@ void _new_packet(attr_t attr, int lineno, int x, int len, const chtype *srcp)
         sr.Right = x + len - 1;
 
         WriteConsoleOutput(pdc_con_out, buffer, bufSize, bufPos, &sr);
+        PDC_count_bytes(sizeof(CHAR_INFO) * len);
     }
 }
 
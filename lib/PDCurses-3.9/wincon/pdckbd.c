@@ -257,6 +257,32 @@ bool PDC_check_key(void)
     return (event_count != 0);
 }
 
+/* wait for console input, for at most ms milliseconds */
+
+int PDC_wait_input(int ms)
+{
+    DWORD start = GetTickCount();
+    DWORD timeout = (ms < 0) ? INFINITE : (DWORD)ms;
+
+    PDC_LOG(("PDC_wait_input() - called: ms=%d\n", ms));
+
+    /* wake in time to keep blinking text on schedule */
+
+    if (SP->termattrs & A_BLINK)
+    {
+        if (start >= pdc_last_blink + 500)
+            PDC_blink_text();
+
+        if (pdc_last_blink + 500 - start < timeout)
+            timeout = pdc_last_blink + 500 - start;
+    }
+
+    if (!key_count)
+        WaitForSingleObject(pdc_con_in, timeout);
+
+    return GetTickCount() - start;
+}
+
 /* _get_key_count returns 0 if save_ip doesn't contain an event which
    should be passed back to the user. This function filters "useless"
    events.
@@ -455,6 +481,21 @@ static int _process_key_event(void)
     return key;
 }
 
+/* whether any of the buttons pressed in state should wait for a
+   click */
+
+static bool _click_wanted(DWORD state)
+{
+    static const DWORD button_mask[] = {1, 4, 2};
+    int i;
+
+    for (i = 0; i < 3; i++)
+        if ((state & button_mask[i]) && PDC_click_wanted(i))
+            return TRUE;
+
+    return FALSE;
+}
+
 static int _process_mouse_event(void)
 {
     static const DWORD button_mask[] = {1, 4, 2};
@@ -501,13 +542,13 @@ static int _process_mouse_event(void)
         SP->mouse_status.button[i] =
             (MEV.dwButtonState & button_mask[i]) ? action : 0;
 
-    if (action == BUTTON_PRESSED && MEV.dwButtonState & 7 && SP->mouse_wait)
+    if (action == BUTTON_PRESSED && _click_wanted(MEV.dwButtonState))
     {
         /* Check for a click -- a PRESS followed immediately by a release */
 
         if (!event_count)
         {
-            napms(SP->mouse_wait);
+            PDC_wait_input(SP->mouse_wait);
 
             GetNumberOfConsoleInputEvents(pdc_con_in, &event_count);
         }
@@ -563,6 +604,17 @@ static int _process_mouse_event(void)
         }
     }
 
+    /* A move with no button down is a position report */
+
+    if (MEV.dwEventFlags == 1 && !SP->mouse_status.changes)
+    {
+        if (SP->mouse_status.x == old_mouse_status.x &&
+            SP->mouse_status.y == old_mouse_status.y)
+            return -1;
+
+        SP->mouse_status.changes = PDC_MOUSE_POSITION;
+    }
+
     old_mouse_status = SP->mouse_status;
 
     /* Treat click events as release events for comparison purposes */
@@ -602,6 +654,7 @@ static int _process_mouse_event(void)
 int PDC_get_key(void)
 {
     SP->key_modifiers = 0L;
+    SP->key_time = PDC_get_ticks();
 
     if (!key_count)
     {
@@ -364,7 +364,7 @@ void PDC_scr_close(void)
 void PDC_scr_free(void)
 {
     if (SP)
-        free(SP);
+        PDC_free(SP);
 
     if (pdc_con_out != std_con_out)
     {
@@ -389,7 +389,7 @@ int PDC_scr_open(int argc, char **argv)
 
     PDC_LOG(("PDC_scr_open() - called\n"));
 
-    SP = calloc(1, sizeof(SCREEN));
+    SP = PDC_calloc(1, sizeof(SCREEN));
 
     if (!SP)
         return ERR;
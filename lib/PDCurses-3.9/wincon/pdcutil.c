@@ -20,6 +20,23 @@ void PDC_napms(int ms)
     Sleep(ms);
 }
 
+unsigned long PDC_get_ticks(void)
+{
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER now;
+
+    if (!freq.QuadPart)
+        QueryPerformanceFrequency(&freq);
+
+    QueryPerformanceCounter(&now);
+
+    /* scale the whole seconds and the remainder separately, so that
+       the product can't overflow */
+
+    return (unsigned long)((now.QuadPart / freq.QuadPart) * 1000000 +
+        (now.QuadPart % freq.QuadPart) * 1000000 / freq.QuadPart);
+}
+
 const char *PDC_sysname(void)
 {
     return "Windows";
@@ -21,6 +21,16 @@ mh_x11_xaw_dir=""
 
 mh_inc_dirs="$ac_x_header_dirs"
 
+dnl Autoconf 2.70 and later only set ac_x_header_dirs when AC_PATH_X had
+dnl to look for the headers itself, so fall back on the usual places
+
+if test "x$mh_inc_dirs" = "x" ; then
+	mh_inc_dirs="/usr/X11/include /usr/X11R7/include /usr/X11R6/include \
+		/usr/include/X11 /usr/local/X11/include /usr/local/include/X11 \
+		/usr/X386/include /usr/XFree86/include/X11 /usr/include \
+		/usr/local/include /usr/openwin/include /usr/openwin/share/include"
+fi
+
 dnl Provide for user supplying directory
 
 if test "x$x_includes" != xNONE ; then
@@ -139,7 +149,7 @@ else
     multiarch_libdir=""
 fi
 
-mh_lib_dirs="$multiarch_libdir /usr/lib64 /usr/lib/x86_64-linux-gnu /usr/lib/i386-linux-gnu $x_libraries `echo "$ac_x_includes $ac_x_header_dirs" | sed s/include/lib/g`"
+mh_lib_dirs="$multiarch_libdir /usr/lib64 /usr/lib/x86_64-linux-gnu /usr/lib/i386-linux-gnu $x_libraries `echo "$ac_x_includes $mh_inc_dirs" | sed s/include/lib/g`"
 
 dnl try to find libSM.[a,sl,so,dylib]. If we find it we are using X11R6
 for ac_dir in $mh_lib_dirs ; do
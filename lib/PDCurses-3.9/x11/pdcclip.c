@@ -133,7 +133,7 @@ static void _lose_ownership(Widget w, Atom *type)
     PDC_LOG(("_lose_ownership() - called\n"));
 
     if (tmpsel)
-        free(tmpsel);
+        PDC_free(tmpsel);
 
     tmpsel = NULL;
     tmpsel_length = 0;
@@ -179,7 +179,7 @@ int PDC_getclipboard(char **contents, long *length)
 
     if (xc_selection && xc_selection_len)
     {
-        *contents = malloc(xc_selection_len + 1);
+        *contents = PDC_malloc(xc_selection_len + 1);
 
         if (!*contents)
             return PDC_CLIP_MEMORY_ERROR;
@@ -205,9 +205,9 @@ int PDC_setclipboard(const char *contents, long length)
     if (length > (long)tmpsel_length)
     {
         if (!tmpsel_length)
-            tmpsel = malloc(length + 1);
+            tmpsel = PDC_malloc(length + 1);
         else
-            tmpsel = realloc(tmpsel, length + 1);
+            tmpsel = PDC_realloc(tmpsel, length + 1);
     }
 
     for (pos = 0; pos < length; pos++)
@@ -220,7 +220,7 @@ int PDC_setclipboard(const char *contents, long length)
                        _convert_proc, _lose_ownership, NULL) == False)
     {
         status = PDC_CLIP_ACCESS_ERROR;
-        free(tmpsel);
+        PDC_free(tmpsel);
         tmpsel = NULL;
         tmpsel_length = 0;
     }
@@ -234,7 +234,7 @@ int PDC_freeclipboard(char *contents)
 {
     PDC_LOG(("PDC_freeclipboard() - called\n"));
 
-    free(contents);
+    PDC_free(contents);
     return PDC_CLIP_SUCCESS;
 }
 
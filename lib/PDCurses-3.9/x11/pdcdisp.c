@@ -4,6 +4,12 @@
 
 #include <string.h>
 
+#ifdef USE_XSHM
+# include <sys/ipc.h>
+# include <sys/shm.h>
+# include <X11/extensions/XShm.h>
+#endif
+
 #ifdef PDC_WIDE
 # include "../common/acsuni.h"
 #else
@@ -108,6 +114,7 @@ static void _display_cursor(int old_row, int old_x, int new_row, int new_x)
              old_row, old_x));
 
     PDC_transform_line(old_row, old_x, 1, curscr->_y[old_row] + old_x);
+    PDC_update_image();
 
     /* display the cursor at the new cursor position */
 
@@ -261,6 +268,419 @@ void PDC_gotoyx(int row, int col)
     PDC_display_cursor(SP->cursrow, SP->curscol, row, col, SP->visibility);
 }
 
+#ifdef USE_XSHM
+
+/* The MIT-SHM path: instead of a clip, two colors and a string request
+   for every run, cells are rasterized on the client side into an XImage
+   in shared memory, from tiles that are drawn once per (glyph, colors,
+   font) and read back from the server. The damaged span of each row
+   goes out with XShmPutImage() in PDC_update_image(). If the server
+   lacks the extension, or the segment can't be attached (e.g. on a
+   remote display), the core protocol path is used instead. */
+
+#define GLYPHCACHE 1024     /* tiles in the cache; a power of two */
+#define GLYPHROW 32         /* tiles per row of the cache image */
+
+static XImage *shmimage, *glyphimage;
+static XShmSegmentInfo shminfo;
+static Pixmap glyphpixmap;
+static int shmstate;        /* 0 untried, 1 in use, -1 unavailable */
+static bool shmerror, shmbusy;
+static int *dmgfirst, *dmglast, dmgrows;
+
+static struct
+{
+    chtype ch;      /* glyph, with the font in bits 16 and up */
+    short fg, bg;   /* fg is -1 in an empty slot */
+} glyphkey[GLYPHCACHE];
+
+static int _shm_error_handler(Display *display, XErrorEvent *event)
+{
+    shmerror = TRUE;
+
+    return 0;
+}
+
+static void _shm_free_image(void)
+{
+    if (shmimage)
+    {
+        XShmDetach(XCURSESDISPLAY, &shminfo);
+        XDestroyImage(shmimage);
+        shmdt(shminfo.shmaddr);
+        shmimage = NULL;
+    }
+
+    PDC_free(dmgfirst);
+    dmgfirst = dmglast = NULL;
+    dmgrows = 0;
+    shmbusy = FALSE;
+}
+
+/* create the cache image and the scratch pixmap that tiles are drawn
+   in; these depend only on the font, so they survive a resize */
+
+static bool _shm_init_glyphs(Display *display, int screen)
+{
+    int width = GLYPHROW * pdc_fwidth;
+    int height = (GLYPHCACHE / GLYPHROW) * pdc_fheight;
+    char *data;
+
+    glyphimage = XCreateImage(display, DefaultVisual(display, screen),
+                              DefaultDepth(display, screen), ZPixmap, 0,
+                              NULL, width, height, 32, 0);
+    if (!glyphimage)
+        return FALSE;
+
+    data = PDC_malloc(glyphimage->bytes_per_line * height);
+    if (!data)
+    {
+        XDestroyImage(glyphimage);
+        glyphimage = NULL;
+        return FALSE;
+    }
+
+    glyphimage->data = data;
+
+    glyphpixmap = XCreatePixmap(display, XCURSESWIN, pdc_fwidth,
+                                pdc_fheight, DefaultDepth(display, screen));
+
+    PDC_flush_glyphs();
+
+    return TRUE;
+}
+
+/* (re)create the shared image at the current window size; on any
+   failure, give up on MIT-SHM for good */
+
+static bool _shm_ready(void)
+{
+    Display *display = XCURSESDISPLAY;
+    int (*handler)(Display *, XErrorEvent *);
+    int screen = DefaultScreen(display);
+    int i;
+
+    if (shmstate < 0)
+        return FALSE;
+
+    if (shmimage && shmimage->width == pdc_wwidth &&
+        shmimage->height == pdc_wheight)
+        return TRUE;
+
+    _shm_free_image();
+
+    if (!shmstate && (!XShmQueryExtension(display) ||
+        !_shm_init_glyphs(display, screen)))
+        goto fail;
+
+    dmgrows = (pdc_wheight + pdc_fheight - 1) / pdc_fheight;
+    dmgfirst = PDC_malloc(2 * dmgrows * sizeof(int));
+    if (!dmgfirst)
+        goto fail;
+
+    dmglast = dmgfirst + dmgrows;
+
+    for (i = 0; i < dmgrows; i++)
+        dmgfirst[i] = dmglast[i] = _NO_CHANGE;
+
+    shmimage = XShmCreateImage(display, DefaultVisual(display, screen),
+                               DefaultDepth(display, screen), ZPixmap,
+                               NULL, &shminfo, pdc_wwidth, pdc_wheight);
+
+    /* tiles are copied a row at a time, so pixels must be whole bytes */
+
+    if (!shmimage || shmimage->bits_per_pixel % 8 ||
+        shmimage->bits_per_pixel != glyphimage->bits_per_pixel)
+        goto fail;
+
+    shminfo.shmid = shmget(IPC_PRIVATE,
+                           shmimage->bytes_per_line * shmimage->height,
+                           IPC_CREAT | 0600);
+    if (shminfo.shmid < 0)
+        goto fail;
+
+    shminfo.shmaddr = shmimage->data = shmat(shminfo.shmid, NULL, 0);
+    shminfo.readOnly = False;
+
+    if (shminfo.shmaddr == (char *)-1)
+    {
+        shmctl(shminfo.shmid, IPC_RMID, NULL);
+        goto fail;
+    }
+
+    /* a remote server fails the attach asynchronously */
+
+    shmerror = FALSE;
+    handler = XSetErrorHandler(_shm_error_handler);
+    XShmAttach(display, &shminfo);
+    XSync(display, False);
+    XSetErrorHandler(handler);
+
+    /* the segment goes away once both sides have detached */
+
+    shmctl(shminfo.shmid, IPC_RMID, NULL);
+
+    if (shmerror)
+    {
+        shmdt(shminfo.shmaddr);
+        XDestroyImage(shmimage);
+        shmimage = NULL;
+        goto fail;
+    }
+
+    XSetClipMask(display, pdc_normal_gc, None);
+
+    shmstate = 1;
+
+    return TRUE;
+
+fail:
+    PDC_LOG(("_shm_ready() - MIT-SHM unavailable\n"));
+
+    if (shmimage)
+    {
+        XDestroyImage(shmimage);
+        shmimage = NULL;
+    }
+
+    PDC_free_image();
+    shmstate = -1;
+
+    return FALSE;
+}
+
+/* find the tile for a glyph in the cache, drawing it on a miss */
+
+static int _shm_tile(GC gc, chtype ch, short fg, short bg)
+{
+    unsigned int hash = ((unsigned int)ch * 31 + fg) * 31 + bg;
+    int slot = (hash * 2654435761u >> 16) & (GLYPHCACHE - 1);
+
+    if (glyphkey[slot].ch != ch || glyphkey[slot].fg != fg ||
+        glyphkey[slot].bg != bg)
+    {
+        Display *display = XCURSESDISPLAY;
+#ifdef PDC_WIDE
+        XChar2b c;
+
+        c.byte1 = (ch & 0xff00) >> 8;
+        c.byte2 = ch & 0x00ff;
+#else
+        char c = ch & 0xff;
+#endif
+        XSetClipMask(display, gc, None);
+        XSetForeground(display, gc, pdc_color[fg]);
+        XSetBackground(display, gc, pdc_color[bg]);
+#ifdef PDC_WIDE
+        XDrawImageString16(
+#else
+        XDrawImageString(
+#endif
+            display, glyphpixmap, gc, 0, pdc_fascent, &c, 1);
+
+        XGetSubImage(display, glyphpixmap, 0, 0, pdc_fwidth, pdc_fheight,
+                     AllPlanes, ZPixmap, glyphimage,
+                     (slot % GLYPHROW) * pdc_fwidth,
+                     (slot / GLYPHROW) * pdc_fheight);
+
+        glyphkey[slot].ch = ch;
+        glyphkey[slot].fg = fg;
+        glyphkey[slot].bg = bg;
+    }
+
+    return slot;
+}
+
+static void _shm_copy_tile(int slot, int x, int y)
+{
+    int bpp = shmimage->bits_per_pixel / 8;
+    int width = pdc_fwidth * bpp;
+    char *src = glyphimage->data +
+                (slot / GLYPHROW) * pdc_fheight * glyphimage->bytes_per_line +
+                (slot % GLYPHROW) * width;
+    char *dest = shmimage->data + y * shmimage->bytes_per_line + x * bpp;
+    int i;
+
+    for (i = 0; i < pdc_fheight; i++)
+    {
+        memcpy(dest, src, width);
+        src += glyphimage->bytes_per_line;
+        dest += shmimage->bytes_per_line;
+    }
+}
+
+/* fill a rectangle of the image: the first row pixel by pixel, the
+   rest by copying it */
+
+static void _shm_fill(int x, int y, int width, int height, Pixel color)
+{
+    int bpp = shmimage->bits_per_pixel / 8;
+    char *src = shmimage->data + y * shmimage->bytes_per_line + x * bpp;
+    char *dest = src;
+    int i;
+
+    for (i = 0; i < width; i++)
+        XPutPixel(shmimage, x + i, y, color);
+
+    for (i = 1; i < height; i++)
+    {
+        dest += shmimage->bytes_per_line;
+        memcpy(dest, src, width * bpp);
+    }
+}
+
+static void _shm_packet(chtype attr, GC gc, int font, short fore,
+                        short back, int len, int col, int row,
+#ifdef PDC_WIDE
+                        XChar2b *text)
+#else
+                        char *text)
+#endif
+{
+    int xpos = col * pdc_fwidth;
+    int ypos = row * pdc_fheight;
+    int k;
+
+    /* clip to the image; a resize may be in flight */
+
+    if (ypos + pdc_fheight > shmimage->height)
+        return;
+
+    len = min(len, shmimage->width / pdc_fwidth - col);
+    if (len <= 0)
+        return;
+
+    /* don't scribble on what the server may still be reading */
+
+    if (shmbusy)
+    {
+        XSync(XCURSESDISPLAY, False);
+        shmbusy = FALSE;
+    }
+
+    if (pdc_blinked_off && (SP->termattrs & A_BLINK) && (attr & A_BLINK))
+        _shm_fill(xpos, ypos, pdc_fwidth * len, pdc_fheight,
+                  pdc_color[back]);
+    else
+    {
+        for (k = 0; k < len; k++)
+        {
+#ifdef PDC_WIDE
+            chtype ch = (text[k].byte1 << 8) | text[k].byte2;
+#else
+            chtype ch = (unsigned char)text[k];
+#endif
+            _shm_copy_tile(_shm_tile(gc, ch | ((chtype)font << 16),
+                                     fore, back),
+                           xpos + pdc_fwidth * k, ypos);
+        }
+
+        if (attr & (A_LEFT | A_RIGHT | A_UNDERLINE))
+        {
+            Pixel color = pdc_color[SP->line_color != -1 ?
+                                    SP->line_color : fore];
+
+            if ((attr & A_UNDERLINE) && pdc_fascent + 1 < pdc_fheight)
+                _shm_fill(xpos, ypos + pdc_fascent + 1, pdc_fwidth * len, 1,
+                          color);
+
+            for (k = 0; k < len; k++)
+            {
+                if (attr & A_LEFT)
+                    _shm_fill(xpos + pdc_fwidth * k, ypos, 1, pdc_fheight,
+                              color);
+
+                if (attr & A_RIGHT)
+                    _shm_fill(xpos + pdc_fwidth * (k + 1) - 1, ypos, 1,
+                              pdc_fheight, color);
+            }
+        }
+    }
+
+    if (dmgfirst[row] == _NO_CHANGE || col < dmgfirst[row])
+        dmgfirst[row] = col;
+    if (col + len - 1 > dmglast[row])
+        dmglast[row] = col + len - 1;
+}
+
+#endif /* USE_XSHM */
+
+/* push the damaged parts of the shared image to the window */
+
+void PDC_update_image(void)
+{
+#ifdef USE_XSHM
+    int row, height, rects = 0;
+
+    if (!shmimage)
+        return;
+
+    for (row = 0; row < dmgrows; row += height)
+    {
+        int first = dmgfirst[row], last = dmglast[row];
+
+        height = 1;
+
+        if (first == _NO_CHANGE)
+            continue;
+
+        /* rows damaged over the same span go out as one request */
+
+        while (row + height < dmgrows && dmgfirst[row + height] == first &&
+               dmglast[row + height] == last)
+            height++;
+
+        XShmPutImage(XCURSESDISPLAY, XCURSESWIN, pdc_normal_gc, shmimage,
+                     first * pdc_fwidth, row * pdc_fheight,
+                     first * pdc_fwidth, row * pdc_fheight,
+                     (last - first + 1) * pdc_fwidth, height * pdc_fheight,
+                     False);
+
+        for (last = row; last < row + height; last++)
+            dmgfirst[last] = dmglast[last] = _NO_CHANGE;
+
+        shmbusy = TRUE;
+        rects++;
+    }
+
+    if (rects)
+        PDC_count_update(rects);
+#endif
+}
+
+/* forget the cached tiles, e.g. after a color has been changed */
+
+void PDC_flush_glyphs(void)
+{
+#ifdef USE_XSHM
+    int i;
+
+    for (i = 0; i < GLYPHCACHE; i++)
+        glyphkey[i].fg = -1;
+#endif
+}
+
+void PDC_free_image(void)
+{
+#ifdef USE_XSHM
+    _shm_free_image();
+
+    if (glyphimage)
+    {
+        PDC_free(glyphimage->data);
+        glyphimage->data = NULL;
+        XDestroyImage(glyphimage);
+        glyphimage = NULL;
+    }
+
+    if (glyphpixmap)
+    {
+        XFreePixmap(XCURSESDISPLAY, glyphpixmap);
+        glyphpixmap = None;
+    }
+#endif
+}
+
 /* update the given physical line to look like the corresponding line in
    curscr */
 
@@ -302,6 +722,16 @@ static int _new_packet(chtype attr, int len, int col, int row,
     else
         gc = pdc_normal_gc;
 
+#ifdef USE_XSHM
+    if (_shm_ready())
+    {
+        _shm_packet(attr, gc, gc == pdc_italic_gc ? 1 :
+                    (gc == pdc_bold_gc ? 2 : 0), rev ? back : fore,
+                    rev ? fore : back, len, col, row, text);
+        return OK;
+    }
+#endif
+
     _make_xy(col, row, &xpos, &ypos);
 
     bounds.x = xpos;
@@ -4,6 +4,9 @@
 
 #include <keysym.h>
 
+#include <sys/select.h>
+#include <sys/time.h>
+
 #ifdef HAVE_DECKEYSYM_H
 # include <DECkeysym.h>
 #endif
@@ -395,7 +398,10 @@ static unsigned long _process_mouse_event(XEvent *event)
 
         SP->mouse_status.button[button_no - 1] = BUTTON_PRESSED;
 
-        napms(SP->mouse_wait);
+        if (!PDC_click_wanted(button_no - 1))
+            break;
+
+        PDC_wait_input(SP->mouse_wait);
         while (XtAppPending(pdc_app_context))
         {
             XEvent rel;
@@ -465,13 +471,63 @@ static unsigned long _process_mouse_event(XEvent *event)
 
 bool PDC_check_key(void)
 {
-    XtInputMask s = XtAppPending(pdc_app_context);
+    XtInputMask s;
+
+    PDC_update_image();
+
+    s = XtAppPending(pdc_app_context);
 
     PDC_LOG(("PDC_check_key() - returning %s\n", s ? "TRUE" : "FALSE"));
 
     return pdc_resize_now || !!s;
 }
 
+/* wait on the X connection for at most ms milliseconds */
+
+int PDC_wait_input(int ms)
+{
+    Display *display = XCURSESDISPLAY;
+    struct timeval start, now, tv;
+    fd_set fds;
+    int slice = ms;
+
+    PDC_LOG(("PDC_wait_input() - called: ms=%d\n", ms));
+
+    PDC_update_image();
+
+    if (pdc_resize_now || XtAppPending(pdc_app_context))
+        return 0;
+
+    /* Xt's timers only fire from its own event loop, so wake in time
+       for a blinking cursor or blinking text */
+
+    if (pdc_app_data.cursorBlinkRate &&
+        (slice < 0 || slice > pdc_app_data.cursorBlinkRate))
+        slice = pdc_app_data.cursorBlinkRate;
+
+    if ((SP->termattrs & A_BLINK) &&
+        (slice < 0 || slice > pdc_app_data.textBlinkRate))
+        slice = pdc_app_data.textBlinkRate;
+
+    gettimeofday(&start, NULL);
+
+    XFlush(display);
+
+    FD_ZERO(&fds);
+    FD_SET(ConnectionNumber(display), &fds);
+
+    tv.tv_sec = slice / 1000;
+    tv.tv_usec = (slice % 1000) * 1000;
+
+    select(ConnectionNumber(display) + 1, &fds, NULL, NULL,
+           (slice < 0) ? NULL : &tv);
+
+    gettimeofday(&now, NULL);
+
+    return (now.tv_sec - start.tv_sec) * 1000 +
+           (now.tv_usec - start.tv_usec) / 1000;
+}
+
 /* return the next available key or mouse event */
 
 int PDC_get_key(void)
@@ -488,6 +544,7 @@ int PDC_get_key(void)
     }
 
     XtAppNextEvent(pdc_app_context, &event);
+    SP->key_time = PDC_get_ticks();
 
     switch (event.type)
     {
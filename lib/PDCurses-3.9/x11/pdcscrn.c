@@ -177,7 +177,7 @@ void PDC_scr_free(void)
     if (!SP)
         return;
 
-    free(SP);
+    PDC_free(SP);
     SP = NULL;
 
     if (icon_pixmap)
@@ -185,6 +185,8 @@ void PDC_scr_free(void)
     if (icon_pixmap_mask)
         XFreePixmap(XCURSESDISPLAY, icon_pixmap_mask);
 
+    PDC_free_image();
+
     XFreeGC(XCURSESDISPLAY, pdc_normal_gc);
     XFreeGC(XCURSESDISPLAY, pdc_italic_gc);
     XFreeGC(XCURSESDISPLAY, pdc_bold_gc);
@@ -566,7 +568,7 @@ int PDC_scr_open(int argc, char **argv)
     if (!strcmp(pdc_app_data.textCursor, "vertical"))
         pdc_vertical_cursor = TRUE;
 
-    SP = calloc(1, sizeof(SCREEN));
+    SP = PDC_calloc(1, sizeof(SCREEN));
 
     SP->lines = LINES;
     SP->cols = COLS;
@@ -745,7 +747,10 @@ int PDC_init_color(short color, short red, short green, short blue)
                                     DefaultScreen(XCURSESDISPLAY));
 
     if (XAllocColor(XCURSESDISPLAY, cmap, &tmp))
+    {
         pdc_color[color] = tmp.pixel;
+        PDC_flush_glyphs();
+    }
 
     return OK;
 }
@@ -2,6 +2,9 @@
 
 #include "pdcx11.h"
 
+#include <sys/time.h>
+#include <time.h>
+
 #if defined(HAVE_POLL) && !defined(HAVE_USLEEP)
 # include <poll.h>
 #endif
@@ -17,6 +20,7 @@ void PDC_napms(int ms)
 {
     PDC_LOG(("PDC_napms() - called: ms=%d\n", ms));
 
+    PDC_update_image();
     XSync(XtDisplay(pdc_toplevel), False);
 
 #if defined(HAVE_USLEEP)
@@ -33,6 +37,23 @@ void PDC_napms(int ms)
 #endif
 }
 
+unsigned long PDC_get_ticks(void)
+{
+#ifdef CLOCK_MONOTONIC
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1000000UL + now.tv_nsec / 1000;
+#else
+    struct timeval now;
+
+    gettimeofday(&now, NULL);
+
+    return now.tv_sec * 1000000UL + now.tv_usec;
+#endif
+}
+
 const char *PDC_sysname(void)
 {
     return "X11";
@@ -77,6 +77,9 @@ int PDC_display_cursor(int, int, int, int, int);
 
 void PDC_blink_cursor(XtPointer, XtIntervalId *);
 void PDC_blink_text(XtPointer, XtIntervalId *);
+void PDC_flush_glyphs(void);
+void PDC_free_image(void);
 int PDC_kb_setup(void);
 void PDC_redraw_cursor(void);
+void PDC_update_image(void);
 bool PDC_scrollbar_init(const char *);
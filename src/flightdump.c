@@ -0,0 +1,82 @@
+/**
+ * Description: Prints the frames in the flight recordings that the game writes when a frame exceeds its budget.
+ *
+ * Usage: flightdump FILE...
+ * Frames over the budget are marked with an asterisk.
+ */
+#include <stdio.h>
+#include <string.h>
+#include "flightrecord.h"
+
+/**
+ * dumpRecording
+ * Description: Prints the header and every frame of a flight recording.
+ * Params:
+ * path - the path of the recording
+ * Returns: 0 if the recording was printed, else 1
+ */
+int dumpRecording(const char* path)
+{
+  struct FlightRecorderHeader header;
+  struct FlightRecord record;
+  FILE* file = fopen(path, "rb");
+
+  if(!file)
+  {
+    fprintf(stderr, "%s: cannot open\n", path);
+    return 1;
+  }
+
+  if(fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, FLIGHT_RECORDER_MAGIC, sizeof(header.magic)))
+  {
+    fprintf(stderr, "%s: not a flight recording\n", path);
+    fclose(file);
+    return 1;
+  }
+
+  if(header.version != FLIGHT_RECORDER_VERSION || header.recordSize != sizeof(record))
+  {
+    fprintf(stderr, "%s: version %u with %u byte records is not supported\n", path, (unsigned)header.version, (unsigned)header.recordSize);
+    fclose(file);
+    return 1;
+  }
+
+  printf("%s: %u frames, budget %u us\n", path, (unsigned)header.records, (unsigned)header.budgetMicros);
+  printf("%10s %12s %9s %6s %6s %6s %6s %7s %8s\n", "frame", "start", "us", "spawn", "hits", "timers", "runs", "cells", "bytes");
+
+  for(uint32_t i = 0; i < header.records; i++)
+  {
+    if(fread(&record, sizeof(record), 1, file) != 1)
+    {
+      fprintf(stderr, "%s: truncated after %u frames\n", path, (unsigned)i);
+      fclose(file);
+      return 1;
+    }
+
+    printf("%10u %12u %9u%c%6u %6u %6u %6u %7u %8u\n", (unsigned)record.frame, (unsigned)record.startTicks, (unsigned)record.micros,
+      record.micros > header.budgetMicros ? '*' : ' ', (unsigned)record.spawns, (unsigned)record.interceptions,
+      (unsigned)record.timersFired, (unsigned)record.runs, (unsigned)record.cellsDrawn, (unsigned)record.bytesSent);
+  }
+
+  fclose(file);
+
+  return 0;
+}
+
+int main(int argc, char* argv[])
+{
+  int failures = 0;
+
+  if(argc < 2)
+  {
+    fprintf(stderr, "Usage: %s FILE...\n", argv[0]);
+    return 2;
+  }
+
+  for(int i = 1; i < argc; i++)
+  {
+    failures += dumpRecording(argv[i]);
+  }
+
+  return failures ? 1 : 0;
+}
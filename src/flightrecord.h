@@ -0,0 +1,60 @@
+/**
+ * Description: The file format of the flight recorder, shared by the game and the flightdump decoder.
+ *
+ * A flight recording is a FlightRecorderHeader followed by its records, oldest first.
+ * Fields are written in the byte order of the machine that recorded them.
+ */
+#ifndef FLIGHTRECORD_H
+#define FLIGHTRECORD_H
+
+#include <stdint.h>
+
+// Identifies a flight recording, and the layout of its records.
+#define FLIGHT_RECORDER_MAGIC "MCFR"
+#define FLIGHT_RECORDER_VERSION 3
+
+/**
+ * FlightRecorderHeader
+ * Description: The start of a flight recording.
+ * Fields:
+ * magic - FLIGHT_RECORDER_MAGIC, without a terminator
+ * version - FLIGHT_RECORDER_VERSION
+ * recordSize - the size of each record in bytes
+ * records - the number of records that follow
+ * budgetMicros - the frame budget that was exceeded, in microseconds
+ */
+struct FlightRecorderHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t recordSize;
+  uint32_t records;
+  uint32_t budgetMicros;
+};
+
+/**
+ * FlightRecord
+ * Description: The events of a single frame.
+ * Fields:
+ * frame - the number of the frame, counting from the start of the game
+ * startTicks - when the frame began, from PDC_get_ticks()
+ * micros - how long the frame took, in microseconds
+ * spawns - the number of missiles launched by either side
+ * interceptions - the number of enemy missiles intercepted
+ * timersFired - the number of movement, spawn and explosion timers that expired
+ * runs - the number of runs of cells sent to PDCurses' backend
+ * cellsDrawn - the number of cells in those runs
+ * bytesSent - the bytes that the backend wrote to the console for those cells, as PDCurses' render stats count them
+ */
+struct FlightRecord {
+  uint32_t frame;
+  uint32_t startTicks;
+  uint32_t micros;
+  uint16_t spawns;
+  uint16_t interceptions;
+  uint16_t timersFired;
+  uint16_t runs;
+  uint32_t cellsDrawn;
+  uint32_t bytesSent;
+};
+
+#endif
@@ -0,0 +1,111 @@
+/**
+ * Description: Checks that every press of the left mouse button reaches the simulation thread as a click, by feeding mouse events to the game's input code on the offscreen port.
+ *
+ * Usage: inputcheck
+ * Pushes back presses of the left button across the viewport, each between a move of the pointer and the button's release, and reads them with readInput()
+ * as the input thread does. Fails if the input ring does not then hold exactly one click for each press, at its cell and in order.
+ * Builds like the game, which it includes, but against the offscreen port; see the Makefile, or e.g.:
+ * make -C ../lib/PDCurses-3.9/offscreen && gcc -std=gnu99 -O2 -I../lib/PDCurses-3.9 -o inputcheck inputcheck.c ../lib/PDCurses-3.9/offscreen/pdcurses.a
+ */
+#include <curses.h>
+#include <limits.h>
+#include <math.h>
+#include <time.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+
+// The game is included with its own main() renamed.
+#define main gameMain
+
+#include "main.c"
+
+#undef main
+
+// The number of presses to push back. Each comes with a move and a release, and PDCurses keeps 32 mouse events.
+#define CHECK_PRESSES 8
+#define CHECK_EVENTS (CHECK_PRESSES * 3)
+
+int main(int argc, char* argv[])
+{
+  MEVENT events[CHECK_EVENTS];
+  struct Vector presses[CHECK_PRESSES];
+  struct Click clicks[INPUT_RING_SIZE];
+  int failures = 0;
+
+  if(argc > 1)
+  {
+    fprintf(stderr, "Usage: %s\n", argv[0]);
+    return 2;
+  }
+
+  initscr();
+
+  if(resize_term(VIEWPORT_HEIGHT, VIEWPORT_WIDTH) == ERR)
+  {
+    endwin();
+    fprintf(stderr, "%s: cannot make a %d by %d screen\n", argv[0], VIEWPORT_WIDTH, VIEWPORT_HEIGHT);
+    return 1;
+  }
+
+  initInput();
+
+  // Pushing a click signals the simulation thread, as in the game.
+  clicksReady = CreateEvent(NULL, FALSE, FALSE, NULL);
+
+  // The events in the order they are read: the pointer moves onto a cell of the clickable area, and the button is pressed and released there.
+  for(int i = 0; i < CHECK_PRESSES; i++)
+  {
+    presses[i].x = 4 + i * (VIEWPORT_WIDTH - 9) / (CHECK_PRESSES - 1);
+    presses[i].y = 3 + i * (VIEWPORT_HEIGHT - 13) / (CHECK_PRESSES - 1);
+
+    for(int e = 0; e < 3; e++)
+    {
+      MEVENT* event = &events[i * 3 + e];
+
+      memset(event, 0, sizeof(*event));
+      event->x = presses[i].x;
+      event->y = presses[i].y;
+      event->bstate = (e == 0) ? REPORT_MOUSE_POSITION : (e == 1) ? BUTTON1_PRESSED : BUTTON1_RELEASED;
+    }
+  }
+
+  // ungetmouse() puts each event at the head of the queue, so they are pushed back last first.
+  for(int e = CHECK_EVENTS - 1; e >= 0; e--)
+  {
+    ungetmouse(&events[e]);
+  }
+
+  if(!readInput())
+  {
+    printf("FAIL: readInput() took a mouse event for Escape\n");
+    failures++;
+  }
+
+  int count = takeClicks(clicks);
+
+  printf("%d presses among %d mouse events, %d clicks\n", CHECK_PRESSES, CHECK_EVENTS, count);
+
+  if(count != CHECK_PRESSES)
+  {
+    printf("FAIL: there should be a click for each press, and none for the moves and releases\n");
+    failures++;
+  }
+
+  for(int i = 0; i < count && i < CHECK_PRESSES; i++)
+  {
+    if(clicks[i].target.x != presses[i].x || clicks[i].target.y != presses[i].y)
+    {
+      printf("FAIL: click %d is at %d, %d rather than %d, %d\n", i, clicks[i].target.x, clicks[i].target.y, presses[i].x, presses[i].y);
+      failures++;
+    }
+  }
+
+  endwin();
+
+  printf("%s\n", failures ? "FAILED" : "OK");
+
+  return failures ? 1 : 0;
+}
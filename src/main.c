@@ -40,6 +40,10 @@
  */
 #define ENEMY_MISSILE_BUFFER 12
 #define PLAYER_MISSILE_BUFFER 4
+// The most cells in a missile trail, which is more than any path across the viewport has.
+#define TRAIL_LENGTH (VIEWPORT_WIDTH + VIEWPORT_HEIGHT)
+// The most columns in an archetype table.
+#define ARCHETYPE_COLUMNS 20
 
 // Defines colour of character and background drawn to viewport.
 #define RED 1
@@ -50,13 +54,98 @@
 
 #define ESCAPE 27
 
+// The most mouse events handled in a single frame.
+#define MOUSE_EVENT_BATCH 16
+
+// Marks the cells of sprite art that leave the viewport underneath unchanged.
+#define SPRITE_TRANSPARENCY '.'
+
+// The number of frames in the explosion animation.
+#define EXPLOSION_FRAMES 6
+// The size of the largest explosion frame, which bounds the blast of an explosion.
+#define BLAST_WIDTH 7
+#define BLAST_HEIGHT 5
+// The width and height of each bucket of the grid that warheads are sorted into, to find those caught in a blast.
+#define BLAST_GRID_CELL 8
+#define BLAST_GRID_COLUMNS ((VIEWPORT_WIDTH + BLAST_GRID_CELL - 1) / BLAST_GRID_CELL)
+#define BLAST_GRID_ROWS ((VIEWPORT_HEIGHT + BLAST_GRID_CELL - 1) / BLAST_GRID_CELL)
+
+// The size of the banner that summarises a survived round.
+#define ROUND_END_BANNER_HEIGHT 9
+#define ROUND_END_BANNER_WIDTH 39
+
+// The bytes set aside for short-lived windows, such as the round end banner.
+#define OVERLAY_ARENA_SIZE 8192
+// The width of each bucket of the input latency histograms, and the number of buckets (100ms in all).
+#define LATENCY_BUCKET_MICROS 250
+#define LATENCY_BUCKETS 400
+// The number of frames kept by the frame profiler in debug builds. The overlay is redrawn each time they have all been replaced.
+#define PROFILE_FRAMES 128
+// Shows or hides the frame profiler overlay in debug builds.
+#define PROFILE_OVERLAY_KEY 'p'
+// Names the file that the frame profiler writes a CSV row to on every frame, in debug builds.
+#define PROFILE_CSV_VARIABLE "MISSILE_COMMAND_PROFILE_CSV"
+// Names the file that a trace of the frame phases and of PDCurses' work is written to, in debug builds. It is in the Chrome trace event format, which chrome://tracing and Perfetto open.
+#define TRACE_VARIABLE "MISSILE_COMMAND_TRACE"
+// The number of frames kept by the flight recorder, and the most recordings it writes in a game.
+#define FLIGHT_RECORDER_FRAMES 512
+#define FLIGHT_RECORDER_MAX_DUMPS 8
+// The frame budget in milliseconds, past which the flight recorder writes out its frames. Can be changed with FRAME_BUDGET_VARIABLE.
+#define FRAME_BUDGET_MILLIS 16
+#define FRAME_BUDGET_VARIABLE "MISSILE_COMMAND_FRAME_BUDGET_MS"
+// The number of snapshots passed from the simulation thread to the render thread. With three, each thread holds one while the newest waits to be taken.
+#define SNAPSHOT_BUFFERS 3
+// Marks the published snapshot as newer than the one the render thread holds.
+#define SNAPSHOT_FRESH 0x100
+// The most clicks that can wait for the simulation thread. A power of two, so that the ring's indices can wrap.
+#define INPUT_RING_SIZE 64
+// The longest the input thread waits for console input before it checks whether it should stop.
+#define INPUT_WAIT_MILLIS 10
+// How long the round summary is shown, and how long drawing waits for the console to settle after a resize.
+#define ROUND_SUMMARY_MILLIS 5000
+#define RESIZE_SETTLE_MILLIS 300
+// The time between enemy missile spawns from the top of the viewport, and between frames of the explosion animation.
+#define ENEMY_SPAWN_MILLIS 2000
+#define EXPLOSION_FRAME_MILLIS 100
+// The requests that the input thread passes to the render thread, as bits of inputRequests.
+#define INPUT_REQUEST_QUIT 1
+#define INPUT_REQUEST_RESIZE 2
+#define INPUT_REQUEST_OVERLAY 4
+// The thread ids that the render and simulation threads are shown under in traces.
+#define RENDER_THREAD_ID 1
+#define SIMULATION_THREAD_ID 2
+// The most tasks in a task graph, and the most threads that run them, counting the simulation thread.
+#define TASK_GRAPH_SIZE 8
+#define TASK_POOL_MAX_WORKERS 8
+// The number of active missiles at which a tick's missile phases run in parallel. Can be changed with PARALLEL_MISSILES_VARIABLE.
+// The missile buffers hold far fewer, so by default the phases always run serially; the task graph only pays off for swarms larger than
+// the game's, and is run in the game by setting the variable to at most PLAYER_MISSILE_BUFFER + ENEMY_MISSILE_BUFFER, as taskgraphcheck does.
+#define PARALLEL_MISSILES 256
+#define PARALLEL_MISSILES_VARIABLE "MISSILE_COMMAND_PARALLEL_MISSILES"
+
+// Declares CreateWaitableTimerExW(), which arrived in Windows Vista.
+#ifndef _WIN32_WINNT
+#define _WIN32_WINNT 0x0600
+#endif
+
 // Allows for ASCII graphics to be displayed.
 #include <curses.h>
 
+#include <limits.h>
 #include <math.h>
 #include <time.h>
+#include <stdarg.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <windows.h>
+#include "flightrecord.h"
+#include "missilestep.h"
+
+// Asks for a waitable timer that keeps to the millisecond, where Windows supports it (10, version 1803 and later).
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
 
 /**
  * Vector
@@ -71,66 +160,137 @@ struct Vector {
 };
 
 /**
- * Base
- * Description: A player asset. If all bases are destroyed, or all ammunition has been launched in a given round, then the round is over.
+ * components
+ * Description:
+ * The components that the game's entities are built from, as bits. The set of components an entity has is its archetype.
+ * Each component is stored as the columns named below, in the archetype tables that have it.
+ *
+ * positionComponent - the entity's current and previous cells: currX, currY, prevX and prevY
+ * stepperComponent - the path the entity moves along, from startX, startY to destX, destY, and the columns of MissileSteppers that step it: fixedX, fixedY, stepX, stepY and stepsLeft
+ * explosionComponent - explosionFrame, the frame of the explosion animation or 0 before it explodes, and explosionTimer, which times its frames
+ * trailComponent - trail, the handle of the entity's trail in the table's trail pool, and colour, the colour of the trail
+ * fragmentComponent - canFragment, 1 while the entity can still fragment into a second missile
+ * assetComponent - offset, the horizontal distance between the left edge of the viewport and the entity's leftmost character, and isAlive, 1 until it is destroyed
+ * targetComponent - targetX, targetY, the coordinate that enemy missiles set as their destination to target the entity
+ * launcherComponent - ammoCount, the missiles the entity can launch in the current round, and sourceX, sourceY, the coordinate they are launched from
+ */
+enum components {positionComponent = 1, stepperComponent = 2, explosionComponent = 4, trailComponent = 8, fragmentComponent = 16,
+  assetComponent = 32, targetComponent = 64, launcherComponent = 128};
+
+// The archetypes of the game's entities. A new kind of entity needs only a table with its own mix of components.
+#define PLAYER_MISSILE_ARCHETYPE (positionComponent | stepperComponent | explosionComponent | trailComponent)
+#define ENEMY_MISSILE_ARCHETYPE (PLAYER_MISSILE_ARCHETYPE | fragmentComponent)
+#define CITY_ARCHETYPE (assetComponent | targetComponent)
+#define BASE_ARCHETYPE (CITY_ARCHETYPE | launcherComponent)
+
+/**
+ * Column
+ * Description: A column of an archetype table, so that whole rows can be cleared and moved whatever the archetype.
  * Fields:
- * isAlive - determines whether the base has been destroyed. If 1, it is alive, else if 0 it is destroyed.
- * offset - the horizontal distance between the left edge of the viewport and the leftmost character of the city
- * ammoCount - the remaining number of missiles that the base can fire in the current round
- * enemyMissileTarget - the coordinate that enemy missiles set as their destination to target this asset
- * playerMissileSource - the coordinate that player missiles set as their starting position when launched from this base
- */
-struct Base {
-  int isAlive;
-  short offset;
-  short ammoCount;
-  struct Vector enemyMissileTarget;
-  struct Vector playerMissileSource;
+ * values - the column's values, one for each row of the table
+ * size - the size of each value
+ */
+struct Column {
+  unsigned char* values;
+  size_t size;
 };
 
 /**
- * City
- * Description: A player asset. If all cities are destroyed then the game is over.
+ * TrailPool
+ * Description: The trails of the entities in an archetype table. Each entity holds the handle of its trail, which stays the same when the entity changes rows.
  * Fields:
- * isAlive - determines whether the city has been destroyed. If 1, it is alive, else if 0 it is destroyed
- * offset - the horizontal distance between the left edge of the viewport and the leftmost character of the city
- * enemyMissileTarget - the coordinate that enemy missiles set as their destination to target this asset
- */
-struct City {
-  int isAlive;
-  unsigned short offset;
-  struct Vector enemyMissileTarget;
+ * cells - the cells of each trail, TRAIL_LENGTH for each handle, in the order they were entered
+ * lengths - the number of cells in each trail
+ * freeHandles - the handles that are not in use, of which there are freeCount
+ * freeCount - the number of free handles
+ */
+struct TrailPool {
+  struct Vector* cells;
+  short* lengths;
+  int* freeHandles;
+  int freeCount;
 };
 
 /**
- * Missile
- * Description: A generic missile that represents both enemy and player missiles.
+ * ArchetypeTable
+ * Description:
+ * The entities of a single archetype, stored as a column for each field of their components.
+ * The entities are rows 0 to count - 1, with no gaps between them, so that systems run down dense columns.
  * Fields:
- * currPos - the current position of the missile
- * startPos - the start position of the missile
- * destPos - the destination position of the missile
- * prevPos - the previous position of the missile
- * trailCoords - stores the location of missile trail. If an element is 1, then the two indexes representing
- * that element represent the coordinate location.
- * explosionTimer - coordinates timing of the missile's explosion animation
- * explosionFrame - the animation frame of the missile's explosion
- * canFragment - determines whether the missile can fragment. If 1, it can fragment; else if 0, it cannot.
- * True for enemy missiles that spawned from the top of the viewport
- * isActive - determines whether the missile is active.  If 1, it is active; else if 0, it is not.
- * colour -  the colour of the trail made by the missile
- */
-struct Missile
-{
-  struct Vector currPos;
-  struct Vector startPos;
-  struct Vector destPos;
-  struct Vector prevPos;
-  unsigned short trailCoords[VIEWPORT_WIDTH][VIEWPORT_HEIGHT];
-  clock_t explosionTimer;
-  short explosionFrame;
-  int canFragment;
-  int isActive;
-  int colour;
+ * components - the archetype, from components
+ * count - the number of entities in the table
+ * capacity - the number of rows in each column
+ * headColour - the colour that the head of a moving entity is drawn in
+ * currX to sourceY - the columns of the components, described in components. The columns of components that the archetype lacks are NULL.
+ * trails - the trails of the entities, for archetypes with trailComponent
+ * moves - the cells that the entities entered in their last step, for archetypes with stepperComponent
+ * columns - the columns that the archetype has, of which there are columnCount
+ * columnCount - the number of columns
+ * storage - the memory that the columns and trails are laid out in
+ */
+struct ArchetypeTable {
+  unsigned int components;
+  int count;
+  int capacity;
+  short headColour;
+  short* currX;
+  short* currY;
+  short* prevX;
+  short* prevY;
+  short* startX;
+  short* startY;
+  short* destX;
+  short* destY;
+  int32_t* fixedX;
+  int32_t* fixedY;
+  int32_t* stepX;
+  int32_t* stepY;
+  int32_t* stepsLeft;
+  short* explosionFrame;
+  clock_t* explosionTimer;
+  int* trail;
+  short* colour;
+  char* canFragment;
+  short* offset;
+  char* isAlive;
+  short* targetX;
+  short* targetY;
+  short* ammoCount;
+  short* sourceX;
+  short* sourceY;
+  struct TrailPool trails;
+  struct MissileCells moves;
+  struct Column columns[ARCHETYPE_COLUMNS];
+  int columnCount;
+  void* storage;
+};
+
+/**
+ * Blast
+ * Description: A blast waiting to be checked for the warheads it catches.
+ * Fields:
+ * centre - the centre of the explosion
+ * shape - the cells of the blast
+ */
+struct Blast {
+  struct Vector centre;
+  struct BlastShape* shape;
+};
+
+/**
+ * BlastGrid
+ * Description:
+ * The enemy missiles that can still be set off, sorted into buckets of BLAST_GRID_CELL by BLAST_GRID_CELL cells by the position of their head,
+ * so that a blast only looks at the missiles in the buckets it overlaps. Also holds the blasts that are waiting to be checked.
+ * Fields:
+ * bucketStarts - the index in warheads of the first missile in each bucket. The last element is the number of missiles.
+ * warheads - the rows of the missiles, bucket by bucket
+ * blasts - the blasts waiting to be checked, oldest first. Every missile can add at most one blast in a tick.
+ */
+struct BlastGrid {
+  int bucketStarts[BLAST_GRID_COLUMNS * BLAST_GRID_ROWS + 1];
+  int warheads[ENEMY_MISSILE_BUFFER];
+  struct Blast blasts[PLAYER_MISSILE_BUFFER + ENEMY_MISSILE_BUFFER];
 };
 
 /**
@@ -139,956 +299,2640 @@ struct Missile
  *
  * ongoing - normal round execution. The player can fire missiles at will.
  * roundEnding - preparing for the end of the round. Missile speed increases.
- * endOfRound - the end of round screen is being displayed. Showing the results of a survived round.
- * endOfGame - the game over screen is being displayed.
+ * endOfRound - the round has been survived, and its results are about to be shown.
+ * endOfGame - the last city has been destroyed, and the game over screen is about to be shown.
+ * showingRoundSummary - the results of a survived round are being displayed, until ROUND_SUMMARY_MILLIS have passed.
+ * gameOver - the game over screen is being displayed. The simulation sleeps until the player leaves.
  */
-enum gameStates {ongoing, roundEnding, endOfRound, endOfGame};
+enum gameStates {ongoing, roundEnding, endOfRound, endOfGame, showingRoundSummary, gameOver};
 
 /**
- * getPlayerMissilesRemaining
- * Description: Gets the number of missiles that the player can fire in the current round.
- * Params:
- * bases - the collection of bases
- * Return: the number of missiles remaining that the player can fire in the current round
+ * screenStates
+ * Description: Defines the states of the render thread.
+ *
+ * showing - snapshots are drawn as they arrive.
+ * resizing - the console has been resized. Drawing waits until RESIZE_SETTLE_MILLIS have passed, so that the screen does not clip.
  */
-int getPlayerMissilesRemaining(struct Base bases[])
-{
-  int ammoCount = 0;
+enum screenStates {showing, resizing};
 
-  for(int i = 0; i < NUMBER_OF_BASES; i++)
-  {
-    if(bases[i].isAlive)
-    {
-      ammoCount += bases[i].ammoCount;
-    }
-  }
+/**
+ * canvasEditRules
+ * Description: Defines when a change to a cell of the canvas is made, by what the cell holds at the time.
+ *
+ * drawAlways - the cell is always changed.
+ * drawUnlessEnemyHead - the cell is changed unless it holds the head of an enemy missile (a white asterisk).
+ * eraseIfColour - the cell is cleared if it is in the given colour, so that a trail only erases its own cells.
+ */
+enum canvasEditRules {drawAlways, drawUnlessEnemyHead, eraseIfColour};
 
-  return ammoCount;
-}
+/**
+ * framePhases
+ * Description: The parts of a frame that are timed by the frame profiler in debug builds.
+ *
+ * phaseRefresh - drawing the newest snapshot to the screen. Render thread.
+ * phaseInput - reading keyboard and mouse input, and passing clicks on to the simulation. Render thread.
+ * phaseLaunch - launching player missiles for the clicks passed on. This and the phases below are on the simulation thread.
+ * phaseFragmentSpawn - spawning enemy missiles from fragmentation.
+ * phaseTimedSpawn - spawning enemy missiles from the top of the viewport.
+ * phasePlayerMissiles - updatePlayerMissiles().
+ * phaseEnemyMissiles - updateEnemyMissiles().
+ * phaseDestroyAssets - destroyAssets().
+ * phaseInterceptions - checkInterceptions().
+ * phaseEndOfRound - the end of round and end of game checks, and the screens that follow them.
+ * FRAME_PHASES - the number of phases.
+ */
+enum framePhases {phaseRefresh, phaseInput, phaseLaunch, phaseFragmentSpawn, phaseTimedSpawn, phasePlayerMissiles, phaseEnemyMissiles,
+  phaseDestroyAssets, phaseInterceptions, phaseEndOfRound, FRAME_PHASES};
+
+// The first of the phases that run on the simulation thread.
+#define FIRST_SIMULATION_PHASE phaseLaunch
 
 /**
- * drawScore
- * Description: Draws the player's current score.
- * Params:
- * score - the player's score
+ * BlastShape
+ * Description: The cells that a blast destroys warheads in.
+ * Fields:
+ * cells - 1 for each cell in the blast, with the centre of the explosion at cells[BLAST_HEIGHT / 2][BLAST_WIDTH / 2]
  */
-void drawScore(int score)
-{
-  attron(COLOR_PAIR(RED));
-  mvprintw(1, 1, "%d", score);
-}
+struct BlastShape {
+  unsigned char cells[BLAST_HEIGHT][BLAST_WIDTH];
+};
 
 /**
- * drawBaseMissileCount
- * Description: Draws the number of missiles remaining in a given missile base.
- * Params:
- * b - the base to draw the missile count for
+ * ExplosionFrame
+ * Description: A single frame of the explosion animation.
+ * Fields:
+ * sprite - the art drawn for the frame
+ * offset - the position of the sprite's top left corner, relative to the centre of the explosion
+ * blast - the cells that the frame's art covers, which destroy warheads while the frame is shown
  */
-void drawBaseMissileCount(struct Base* b)
-{
-  attron(COLOR_PAIR(CYAN));
-  mvprintw(VIEWPORT_HEIGHT - GROUND_HEIGHT - 2, b->offset + 4, "%d", b->ammoCount);
-}
+struct ExplosionFrame {
+  PDC_SPRITE* sprite;
+  struct Vector offset;
+  struct BlastShape blast;
+};
 
 /**
- * drawBases
- * Description: Draws the bases
- * Params:
- * bases - the collection of bases to draw
+ * LatencyHistogram
+ * Description: Counts measured delays in buckets of LATENCY_BUCKET_MICROS, so that percentiles can be read at any time.
+ * Fields:
+ * buckets - the number of delays that fell in each bucket. The last bucket also counts every longer delay.
+ * samples - the total number of delays counted
  */
-void drawBases(struct Base bases[])
-{
-  for(int i = 0; i < NUMBER_OF_BASES; i++)
-  {
-    if(bases[i].isAlive)
-    {
-      attron(COLOR_PAIR(YELLOW));
+struct LatencyHistogram {
+  unsigned long buckets[LATENCY_BUCKETS];
+  unsigned long samples;
+};
 
-      mvprintw(VIEWPORT_HEIGHT - GROUND_HEIGHT - 4, bases[i].offset + 2,  "/\\_/\\");
-      mvprintw(VIEWPORT_HEIGHT - GROUND_HEIGHT - 3, bases[i].offset + 1, "/XXXXX\\");
-      mvprintw(VIEWPORT_HEIGHT - GROUND_HEIGHT - 2, bases[i].offset,    "/XX   XX\\");
+/**
+ * CanvasEdit
+ * Description: A change to a cell of the canvas, recorded by a task so that it can be made after the tasks running alongside it.
+ * Fields:
+ * y - the row of the cell
+ * x - the column of the cell
+ * cell - the character and colour to set it to
+ * rule - when the change is made, from canvasEditRules
+ * colour - for eraseIfColour, the colour that the cell must be in
+ */
+struct CanvasEdit {
+  short y;
+  short x;
+  chtype cell;
+  short rule;
+  short colour;
+};
 
-      drawBaseMissileCount(&bases[i]);
-    }
-  }
-}
+/**
+ * CanvasEdits
+ * Description: The canvas edits and flight recorder events of one task, in the order they were made.
+ * Fields:
+ * edits - the recorded edits, with room for capacity of them
+ * count - the number of edits recorded
+ * capacity - the number of edits there is room for. The room grows as it is needed and is kept between ticks.
+ * timersFired - the timers that fired in the task
+ */
+struct CanvasEdits {
+  struct CanvasEdit* edits;
+  int count;
+  int capacity;
+  uint32_t timersFired;
+};
 
 /**
- * drawCities
- * Description: Draws the cities.
- * Params:
- * cities - the collection of cities to draw
+ * Canvas
+ * Description:
+ * The cells of the viewport as the simulation thread draws them.
+ * Missiles find each other by the characters left here, so the canvas is part of the game's state and not only its picture.
+ * Fields:
+ * cells - the character and colour of every cell, as curses would store them
+ * changed - 1 if a cell has changed since the canvas was last published, else 0
  */
-void drawCities(struct City cities[])
-{
-  attron(COLOR_PAIR(CYAN));
+struct Canvas {
+  chtype cells[VIEWPORT_HEIGHT][VIEWPORT_WIDTH];
+  int changed;
+};
 
-  for(int i = 0; i < NUMBER_OF_CITIES; i++)
-  {
-    if(cities[i].isAlive)
-    {
-      mvprintw(VIEWPORT_HEIGHT - GROUND_HEIGHT - 3, cities[i].offset, "/MMM\\");
-      mvprintw(VIEWPORT_HEIGHT - GROUND_HEIGHT - 2, cities[i].offset, "|[]||");
-    }
-  }
-}
+/**
+ * RoundEndSummary
+ * Description: The figures shown on the banner at the end of a survived round.
+ * Fields:
+ * roundNumber - the round that was survived
+ * score - the player's score, including the bonus for the round
+ * enemyMissilesDestroyed - the number of enemy missiles intercepted in the round
+ * basesSurvived - the number of bases that survived the round
+ * ammoRemaining - the number of missiles that were not launched in the round
+ */
+struct RoundEndSummary {
+  int roundNumber;
+  int score;
+  int enemyMissilesDestroyed;
+  int basesSurvived;
+  int ammoRemaining;
+};
 
 /**
- * drawLandscape
- * Description: Draws the ground, bases and cities.
- * Params:
- * bases - the collection of missile bases
- * cities - the collection of cities
+ * Launch
+ * Description: A player missile launched by the simulation, so that the render thread can measure when it reaches the screen.
+ * Fields:
+ * startPos - the missile's first cell
+ * clickTicks - when PDCurses received the click that launched it, from PDC_get_ticks()
  */
-void drawLandscape(struct Base bases[], struct City cities[])
-{
+struct Launch {
+  struct Vector startPos;
+  unsigned long clickTicks;
+};
 
-  // Draws ground.
-  attron(COLOR_PAIR(YELLOW));
+/**
+ * Snapshot
+ * Description: Everything the render thread needs to draw the simulation. Once published, it is not changed until the render thread hands it back.
+ * Fields:
+ * cells - the viewport: missile positions, trails, explosion frames, assets and the score
+ * roundEnd - the figures for the round end banner, which is shown while showRoundEnd is 1
+ * showRoundEnd - 1 while the round end banner should be shown, else 0
+ * launches - the player missiles launched since the last snapshot, of which there are launchCount
+ * launchCount - the number of launches
+ * events - the spawns, interceptions and timers fired since the last snapshot, for the flight recorder
+ * phaseMicros - the microseconds spent in each simulation phase since the last snapshot, for the frame profiler in debug builds
+ */
+struct Snapshot {
+  chtype cells[VIEWPORT_HEIGHT][VIEWPORT_WIDTH];
+  struct RoundEndSummary roundEnd;
+  int showRoundEnd;
+  struct Launch launches[PLAYER_MISSILE_BUFFER];
+  int launchCount;
+  struct FlightRecord events;
+  unsigned long phaseMicros[FRAME_PHASES];
+};
 
-  for(int row = 0; row < GROUND_HEIGHT; row++)
-  {
-    for(int col = 0; col < VIEWPORT_WIDTH - 2; col++)
-    {
-      mvprintw(VIEWPORT_HEIGHT - 2 - row, col + 1, "X");
-    }
-  }
+/**
+ * Click
+ * Description: A press of the left mouse button in the viewport, passed from the input thread to the simulation thread.
+ * Fields:
+ * target - the cell that was clicked
+ * ticks - when PDCurses received the click, from PDC_get_ticks()
+ */
+struct Click {
+  struct Vector target;
+  unsigned long ticks;
+};
 
-  // Draws bases.
-  drawBases(bases);
+/**
+ * FrameTask
+ * Description: A task in a task graph, which runs once all the tasks it depends on have finished.
+ * Fields:
+ * run - the function that does the task's work
+ * context - passed to run
+ * dependents - the indexes of the tasks that depend on this one, of which there are dependentCount
+ * dependentCount - the number of dependents
+ * dependencyCount - the number of tasks this one depends on
+ * dependenciesLeft - the number of those tasks that have not yet finished in the current run of the graph
+ */
+struct FrameTask {
+  void (*run)(void* context);
+  void* context;
+  int dependents[TASK_GRAPH_SIZE];
+  int dependentCount;
+  int dependencyCount;
+  volatile LONG dependenciesLeft;
+};
 
-  // Draws cities.
-  drawCities(cities);
-}
+/**
+ * TaskGraph
+ * Description: The tasks of a tick, and the order they must run in.
+ * Fields:
+ * tasks - the tasks, of which there are taskCount
+ * taskCount - the number of tasks
+ * tasksLeft - the number of tasks that have not yet finished in the current run
+ * finished - signalled when the last task of a run finishes
+ */
+struct TaskGraph {
+  struct FrameTask tasks[TASK_GRAPH_SIZE];
+  int taskCount;
+  volatile LONG tasksLeft;
+  HANDLE finished;
+};
 
 /**
- * drawRoundEnd
- * Description: Draws the text that appears at the end of a survived round.
- * Params:
- * score - the player's score
- * bases - the collection of missile bases
- * cities - the collection of cities
- * enemyMissilesDestroyed - the number of enemy missiles intercepted in the current round
+ * TaskDeque
+ * Description:
+ * The tasks waiting to run on one thread of the task pool.
+ * The thread takes the task it pushed last, from the bottom; other threads steal the oldest, from the top.
+ * Fields:
+ * tasks - the indexes of the waiting tasks, from tasks[top % TASK_GRAPH_SIZE] to tasks[(bottom - 1) % TASK_GRAPH_SIZE]
+ * top - counts the tasks taken from the top
+ * bottom - counts the tasks pushed, less those taken from the bottom
+ * lock - held while the deque is changed
+ */
+struct TaskDeque {
+  int tasks[TASK_GRAPH_SIZE];
+  int top;
+  int bottom;
+  CRITICAL_SECTION lock;
+};
+
+/**
+ * SimulationTick
+ * Description: The simulation state that the tasks of a tick work on.
+ * Fields:
+ * playerMissiles - the table of player missiles
+ * enemyMissiles - the table of enemy missiles
+ * bases - the table of missile bases
+ * cities - the table of cities
+ * gameState - the state of the game
+ * playersLastUpdateTime - coordinates timing for player missile movement
+ * enemiesLastUpdateTime - coordinates timing for enemy missile movement
  * roundNumber - the current round number
+ * score - the player's score
+ * enemyMissilesDestroyed - the number of enemy missiles intercepted in the round
+ * blastGrid - the grid used to find the enemy missiles caught in blasts
  */
-void drawRoundEnd(int* score, struct Base bases[], struct City cities[], int enemyMissilesDestroyed, int roundNumber)
-{
-  int basesSurvived = 0;
-  int ammoRemaining = getPlayerMissilesRemaining(bases);
+struct SimulationTick {
+  struct ArchetypeTable* playerMissiles;
+  struct ArchetypeTable* enemyMissiles;
+  struct ArchetypeTable* bases;
+  struct ArchetypeTable* cities;
+  enum gameStates* gameState;
+  clock_t* playersLastUpdateTime;
+  clock_t* enemiesLastUpdateTime;
+  int* roundNumber;
+  int* score;
+  int* enemyMissilesDestroyed;
+  struct BlastGrid* blastGrid;
+};
 
-  for(int i = 0; i < NUMBER_OF_BASES; i++)
-  {
-    if(bases[i].isAlive)
-    {
-      basesSurvived++;
-    }
-  }
+// The missile base art.
+static PDC_SPRITE* baseSprite;
+// The city art.
+static PDC_SPRITE* citySprite;
+// The frames of the explosion animation, in the order they are drawn.
+static struct ExplosionFrame explosionFrames[EXPLOSION_FRAMES];
+// The blast of a warhead that is set off by another: every cell of every frame at once, so that chain reactions carry on in the same tick.
+static struct BlastShape warheadBlast;
+
+// Short-lived windows are allocated from this arena rather than the heap, and it is emptied when they are deleted.
+static unsigned char overlayArenaBuffer[OVERLAY_ARENA_SIZE];
+static PDC_ARENA overlayArena;
+static PDC_ALLOCATOR* overlayAllocator;
+
+// The summary shown at the end of a survived round. NULL when it is not on screen.
+static WINDOW* roundEndBanner;
+
+// Counts the frames played, and those on which PDCurses allocated from the heap, which should stay at zero.
+static unsigned long framesPlayed;
+static unsigned long framesThatAllocated;
+/*
+ * The allocator PDCurses draws from during play, which the input thread shares. Its counters are only read with cursesLock held:
+ * renderAllocations adds up what the heap gained while the render thread held the lock, so that the input thread's allocations are not counted.
+ */
+static PDC_ALLOCATOR* cursesHeap;
+static unsigned long renderAllocations;
+static unsigned long allocationsAtLock;
+// Counts the frames that sent any cells to the screen.
+static unsigned long framesThatDrew;
+
+// Delays from a click reaching PDCurses to its missile being launched, and to the missile's first cell being sent to the screen.
+static struct LatencyHistogram clickToLaunch;
+static struct LatencyHistogram clickToFirstCell;
+// The watches on the first cells of launched missiles, with the clicks that launched them, until the frame that draws them has been refreshed.
+static int firstCellWatches[PLAYER_MISSILE_BUFFER];
+static unsigned long firstCellClickTicks[PLAYER_MISSILE_BUFFER];
+static int firstCellWatchCount;
 
-  *score += 100 * basesSurvived + 5 * ammoRemaining;
-  drawScore(*score);
+/*
+ * The simulation thread draws into the canvas, and publishes a copy of it in a snapshot whenever it changes.
+ * Only the simulation thread touches the canvas, the round end banner figures and nextSnapshot once it has started.
+ */
+static struct Canvas canvas;
+static struct RoundEndSummary roundEndSummary;
+static int roundEndShown;
+// The edits of the task running on this thread, while tasks run in parallel. NULL when edits are made to the canvas at once.
+static __thread struct CanvasEdits* canvasRecorder;
 
-  attron(COLOR_PAIR(RED));
+/*
+ * The snapshots form a triple buffer. The simulation thread fills snapshots[simulationSnapshot], and the render thread draws snapshots[renderSnapshot].
+ * publishedSnapshot holds the index of the third, the newest published, with SNAPSHOT_FRESH set until the render thread takes it.
+ * Each thread swaps its own snapshot for the published one with a single atomic exchange, so neither ever waits for the other.
+ */
+static struct Snapshot snapshots[SNAPSHOT_BUFFERS];
+static volatile LONG publishedSnapshot = 1;
+static int simulationSnapshot = 0;
+static int renderSnapshot = 2;
+static struct Snapshot* nextSnapshot = &snapshots[0];
+// Signalled whenever a snapshot is published, so that the render thread can wait for one.
+static HANDLE snapshotReady;
+// Signalled when the input thread has requests for the render thread, and when it has pushed clicks for the simulation thread.
+static HANDLE renderWake;
+static HANDLE clicksReady;
+// Wakes the simulation thread when its next timer is due.
+static HANDLE tickTimer;
 
-  mvprintw(VIEWPORT_HEIGHT/2 - 5, VIEWPORT_WIDTH/2 - 6,             "ROUND %d CLEARED"             , roundNumber);
+/*
+ * Above parallelMissiles active missiles, the missile phases of a tick run as frameGraph on the task pool.
+ * The simulation thread is worker 0 of the pool, and the pool's own threads are started the first time it is needed.
+ * taskWorkers counts the workers once the pool has been started, and is 1 if the machine has a single processor.
+ */
+static unsigned int parallelMissiles;
+static struct TaskGraph frameGraph;
+static struct TaskGraph* runningGraph;
+static struct TaskDeque taskDeques[TASK_POOL_MAX_WORKERS];
+static HANDLE taskWorkerThreads[TASK_POOL_MAX_WORKERS];
+static int taskWorkers;
+// Released once for each task pushed, to wake a worker; and the event that stops the workers.
+static HANDLE taskPoolWork;
+static HANDLE taskPoolStop;
+// The canvas edits of the missile phases while they run in parallel. They are made in the order the phases run in otherwise.
+static struct CanvasEdits playerMissileEdits;
+static struct CanvasEdits enemyMissileEdits;
+// The version of the missile stepping kernel that the processor supports, picked when the simulation starts.
+static MissileStepKernel missileStepKernel;
 
-  mvprintw(VIEWPORT_HEIGHT/2 - 3, VIEWPORT_WIDTH/2 - 11,        "CIVILISATION HAS SURVIVED"        );
+/*
+ * Clicks waiting for the simulation thread, in a ring with a single producer, the input thread, and a single consumer, the simulation thread.
+ * inputRingTail counts the clicks pushed and inputRingHead those taken; each is written only by its own thread, so neither needs a lock.
+ */
+static struct Click inputRing[INPUT_RING_SIZE];
+static volatile LONG inputRingHead;
+static volatile LONG inputRingTail;
+// Counts the clicks dropped because the ring was full.
+static unsigned long inputRingDropped;
+
+// The input thread, the event that asks it to stop, and the INPUT_REQUEST bits it has set for the render thread.
+static HANDLE inputThread;
+static HANDLE inputStop;
+static volatile LONG inputRequests;
+// The window the input thread reads from. The game never draws in it, so reading from it never refreshes the screen.
+static WINDOW* inputWindow;
 
-  mvprintw(VIEWPORT_HEIGHT/2 - 1, VIEWPORT_WIDTH/2 - 4,                 "SCORE: %d"                , *score);
+/*
+ * PDCurses is not thread safe. The render thread holds cursesLock while it draws, and the input thread while it reads input.
+ * The simulation thread never calls PDCurses.
+ */
+static CRITICAL_SECTION cursesLock;
 
-  mvprintw(VIEWPORT_HEIGHT/2 + 1, VIEWPORT_WIDTH/2 - 17, "MISSILES INTERCEPTED:  %02d X 25 POINTS" , enemyMissilesDestroyed);
-  mvprintw(VIEWPORT_HEIGHT/2 + 2, VIEWPORT_WIDTH/2 - 17, "BASES SURVIVED:        %d X 100 POINTS"  , basesSurvived);
-  mvprintw(VIEWPORT_HEIGHT/2 + 3, VIEWPORT_WIDTH/2 - 17, "MISSILES REMAINING:     %02d X 5 POINTS" , ammoRemaining);
+// The simulation thread, and the event that asks it to stop.
+static HANDLE simulationThread;
+static HANDLE simulationStop;
 
-  /*
-   * Redraws the landscape.
-   * Corrects any visual damage to surviving bases, cities and the ground.
-   */
-  drawLandscape(bases, cities);
+/*
+ * The flight recorder keeps the events of the last FLIGHT_RECORDER_FRAMES frames.
+ * Only the render thread writes to it, so the ring needs no locking: flightFrames counts the frames recorded, and the next one goes in at flightFrames % FLIGHT_RECORDER_FRAMES.
+ */
+static struct FlightRecord flightRecords[FLIGHT_RECORDER_FRAMES];
+static uint32_t flightFrames;
+// The events of the frame being played, and PDCurses' output counters when it began.
+static struct FlightRecord flightFrame;
+static PDC_RENDER_STATS renderStatsAtFrameStart;
+// The frame budget in microseconds, the number of recordings written, and the frame of the last one.
+static unsigned long frameBudgetMicros;
+static int flightDumps;
+static uint32_t lastFlightDumpFrame;
+
+#ifndef NDEBUG
+// The names of the frame phases, as used for the overlay and the CSV columns.
+static const char* phaseNames[FRAME_PHASES] = {"refresh", "input", "launch", "fragment", "spawn", "player", "enemy", "assets", "hits", "round"};
+// The time in microseconds spent in each phase of the last PROFILE_FRAMES frames, and the frame being timed.
+static unsigned long phaseMicros[PROFILE_FRAMES][FRAME_PHASES];
+static int profiledFrame;
+// When each phase that is being timed began, from PDC_get_ticks().
+static unsigned long phaseStarted[FRAME_PHASES];
+// The row that shows the profile. It is created at start up so that showing it does not allocate during play.
+static WINDOW* profileOverlay;
+static int profileOverlayShown;
+// The CSV file that each frame's profile is written to. NULL unless PROFILE_CSV_VARIABLE is set.
+static FILE* profileCsv;
+static unsigned long csvFrames;
+// The trace file, NULL unless TRACE_VARIABLE is set. Its timestamps count from traceStartTicks.
+static FILE* traceFile;
+static unsigned long traceStartTicks;
+static unsigned long traceEventsWritten;
+// Held while an event is written, as both threads write to the trace.
+static CRITICAL_SECTION traceLock;
+
+#define PROFILE_BEGIN(phase) (phaseStarted[phase] = PDC_get_ticks())
+#define PROFILE_END(phase) endProfiledPhase(phase)
+#define PROFILE_END_FRAME() endProfiledFrame()
+#else
+// The frame profiler is compiled out of release builds.
+#define PROFILE_BEGIN(phase)
+#define PROFILE_END(phase)
+#define PROFILE_END_FRAME()
+#endif
 
-  refresh();
-  Sleep(5000);
+/**
+ * initColours
+ * Description: Starts colour, and defines the colour pairs that the game draws with. Must be called after initscr().
+ */
+void initColours()
+{
+  // Takes the format: key, fg colour, bg colour.
+  start_color();
+  init_pair(RED, COLOR_RED, COLOR_BLACK);
+  init_pair(YELLOW, COLOR_YELLOW, COLOR_BLACK);
+  init_pair(BLUE, COLOR_BLUE, COLOR_BLACK);
+  init_pair(CYAN, COLOR_CYAN, COLOR_BLACK);
+  init_pair(WHITE, COLOR_WHITE, COLOR_BLACK);
 }
 
 /**
- * eraseRoundEnd
- * Description: Erases the text that appears at game over.
+ * initInput
+ * Description: Opens inputWindow, which readInput() reads from, and asks PDCurses for the keys and mouse events that the game uses. Must be called after initscr().
  */
-void eraseRoundEnd()
+void initInput()
 {
-  for(int lineNumber = 0; lineNumber < 9; lineNumber++)
-  {
-    // Selects the rows that contains text.
-    if(!lineNumber || lineNumber == 2 || lineNumber == 4 || lineNumber >= 6)
-    {
-      // Replaces the row with whitespace.
-      for(int i = 1; i < VIEWPORT_WIDTH - 1; i++)
-      {
-        mvprintw(VIEWPORT_HEIGHT/2 - 5 + lineNumber, i, " ");
-      }
-    }
-  }
+  // Input is read from a window of its own, which is left untouched so that wgetch() never refreshes it.
+  inputWindow = newwin(1, 1, 0, 0);
+  leaveok(inputWindow, TRUE);
+  untouchwin(inputWindow);
+  // Enables input polling without halting the program.
+  nodelay(inputWindow, TRUE);
+  // Enables keyboard/mouse input.
+  keypad(inputWindow, TRUE);
+  // Enables mouse input; presses are reported at once, rather than as clicks on release. Moves are not reported, as nothing follows the pointer.
+  mousemask(BUTTON1_PRESSED, NULL);
 }
 
 /**
- * drawGameEnd
- * Description: Draws the text that appears at game over.
+ * initAllocators
+ * Description: Sets aside the arena for short-lived windows, and notes the heap that PDCurses draws from during play, whose counters show whether a frame allocated.
  */
-void drawGameEnd()
+void initAllocators()
 {
-  attron(COLOR_PAIR(RED));
-  mvprintw(VIEWPORT_HEIGHT/2 - 1, VIEWPORT_WIDTH/2 - 1, "THE");
-  mvprintw(VIEWPORT_HEIGHT/2 + 1, VIEWPORT_WIDTH/2 - 1, "END");
-  refresh();
+  overlayAllocator = PDC_arena_init(&overlayArena, overlayArenaBuffer, OVERLAY_ARENA_SIZE);
+  cursesHeap = PDC_get_allocator();
 }
 
 /**
- * drawExplosion
- * Description: Draws the explosion animation for missiles.
- * Params:
- * m - the missile to draw the explosion animation for
+ * initSprites
+ * Description:
+ * Converts the art for assets and explosions into sprites, so that they can be drawn as blocks of cells.
+ * Cells marked with SPRITE_TRANSPARENCY are not drawn; spaces are drawn, erasing whatever is underneath.
+ * Must be called before any asset or explosion is drawn.
  */
-void drawExplosion(struct Missile* m)
+void initSprites()
 {
-  // Alternates the colour of the explosion frames.
-  if(m->explosionFrame % 2)
-  {
-     attron(COLOR_PAIR(RED));
-  }
-  else
-  {
-    attron(COLOR_PAIR(YELLOW));
-  }
+  const char* baseArt[] = {"../\\_/\\..",
+                           "./XXXXX\\.",
+                           "/XX   XX\\"};
+
+  const char* cityArt[] = {"/MMM\\",
+                           "|[]||"};
+
+  const char* frame1[] = {"*"};
+
+  const char* frame2[] = {".*.",
+                          "***",
+                          ".*."};
+
+  const char* frame3[] = {".* * *.",
+                          "..***..",
+                          "*******",
+                          ". *** .",
+                          ".* * *."};
+
+  const char* frame4[] = {".     .",
+                          ".. * ..",
+                          "  ***  ",
+                          ".. * ..",
+                          ".     ."};
+
+  const char* frame5[] = {". .",
+                          " * ",
+                          ". ."};
 
-  switch(m->explosionFrame)
+  const char* frame6[] = {" "};
+
+  const char** frameArt[EXPLOSION_FRAMES] = {frame1, frame2, frame3, frame4, frame5, frame6};
+  const int frameHeights[EXPLOSION_FRAMES] = {1, 3, 5, 5, 3, 1};
+
+  baseSprite = new_sprite(baseArt, 3, COLOR_PAIR(YELLOW), SPRITE_TRANSPARENCY);
+  citySprite = new_sprite(cityArt, 2, COLOR_PAIR(CYAN), SPRITE_TRANSPARENCY);
+
+  for(int i = 0; i < EXPLOSION_FRAMES; i++)
   {
-    case 1:
-    {
-      mvprintw(m->currPos.y, m->currPos.x,  "*");
-      break;
-    }
-    case 2:
-    {
-      mvprintw(m->currPos.y - 1, m->currPos.x,  "*");
-      mvprintw(m->currPos.y, m->currPos.x - 1, "***");
-      mvprintw(m->currPos.y + 1, m->currPos.x,  "*");
-      break;
-    }
-    case 3:
-    {
-      mvprintw(m->currPos.y - 2, m->currPos.x - 2, "* * *");
-      mvprintw(m->currPos.y - 1, m->currPos.x - 1,  "***");
-      mvprintw(m->currPos.y, m->currPos.x - 3,    "*******");
-      mvprintw(m->currPos.y + 1, m->currPos.x - 2, " *** ");
-      mvprintw(m->currPos.y + 2, m->currPos.x- 2,  "* * *");
-      break;
-    }
-    case 4:
-    {
-      mvprintw(m->currPos.y - 2, m->currPos.x - 2, "     ");
-      mvprintw(m->currPos.y - 1, m->currPos.x - 1,  " * ");
-      mvprintw(m->currPos.y, m->currPos.x - 3,    "  ***  ");
-      mvprintw(m->currPos.y + 1, m->currPos.x - 1,  " * ");
-      mvprintw(m->currPos.y + 2, m->currPos.x - 2, "     ");
-      break;
-    }
-    case 5:
-    {
-      mvprintw(m->currPos.y - 1, m->currPos.x,  " ");
-      mvprintw(m->currPos.y, m->currPos.x - 1, " * ");
-      mvprintw(m->currPos.y + 1, m->currPos.x,  " ");
-      break;
-    }
-    case 6:
+    // Alternates the colour of the explosion frames, starting with red.
+    chtype colour = (i % 2) ? COLOR_PAIR(YELLOW) : COLOR_PAIR(RED);
+
+    explosionFrames[i].sprite = new_sprite(frameArt[i], frameHeights[i], colour, SPRITE_TRANSPARENCY);
+
+    // Centres each frame on the explosion.
+    explosionFrames[i].offset.x = -(explosionFrames[i].sprite->_maxx / 2);
+    explosionFrames[i].offset.y = -(frameHeights[i] / 2);
+
+    // The blast of each frame is the cells its art covers, including the spaces that erase what is underneath.
+    for(int row = 0; row < explosionFrames[i].sprite->_maxy; row++)
     {
-      mvprintw(m->currPos.y, m->currPos.x, " ");
-      break;
+      for(int col = 0; col < explosionFrames[i].sprite->_maxx; col++)
+      {
+        if(explosionFrames[i].sprite->_mask[row * explosionFrames[i].sprite->_maxx + col])
+        {
+          int blastRow = BLAST_HEIGHT / 2 + explosionFrames[i].offset.y + row;
+          int blastCol = BLAST_WIDTH / 2 + explosionFrames[i].offset.x + col;
+
+          explosionFrames[i].blast.cells[blastRow][blastCol] = 1;
+          warheadBlast.cells[blastRow][blastCol] = 1;
+        }
+      }
     }
   }
 }
 
 /**
- * initBases
- * Description: Initialises the state for bases.
- * Params:
- * bases - the collection of bases to initialise.
+ * clearCanvas
+ * Description: Fills the canvas with blank cells, as curses fills a new window.
  */
-void initBases(struct Base bases[])
+void clearCanvas()
 {
-  // Horizontal offsets for missile bases.
-  bases[0].offset = 1;
-  bases[1].offset = VIEWPORT_WIDTH/2 - 4;
-  bases[2].offset = VIEWPORT_WIDTH - 10;
-
-  for(int i = 0; i < NUMBER_OF_BASES; i++)
+  for(int row = 0; row < VIEWPORT_HEIGHT; row++)
   {
-    bases[i].isAlive = 1;
-    bases[i].ammoCount = MISSILES_PER_BASE;
-
-    bases[i].enemyMissileTarget.x = bases[i].offset + 4;
-    bases[i].enemyMissileTarget.y = VIEWPORT_HEIGHT - GROUND_HEIGHT - 4;
-
-    bases[i].playerMissileSource.x = bases[i].offset + 4;
-    bases[i].playerMissileSource.y = VIEWPORT_HEIGHT - GROUND_HEIGHT - 5;
+    for(int col = 0; col < VIEWPORT_WIDTH; col++)
+    {
+      canvas.cells[row][col] = ' ';
+    }
   }
+
+  canvas.changed = 1;
 }
 
 /**
- * initCities
- * Description: Initialises the state for cities.
+ * storeCanvasCell
+ * Description: Sets a cell of the canvas. Cells outside the viewport are ignored.
  * Params:
- * cities - the collection of cities that are initialised
- * bases - the collection of bases. Provided because cities are positioned relative to the bases.
+ * y - the row of the cell
+ * x - the column of the cell
+ * cell - the character and colour to set it to
  */
-void initCities(struct City cities[], struct Base bases[])
+void storeCanvasCell(int y, int x, chtype cell)
 {
-  // Horizontal offsets for cities.
-  for(int i = 0; i < NUMBER_OF_CITIES; i++)
+  if(y < 0 || y >= VIEWPORT_HEIGHT || x < 0 || x >= VIEWPORT_WIDTH || canvas.cells[y][x] == cell)
   {
-    short cityWidthsRequired = i % (NUMBER_OF_CITIES / 2);
-    int paddingRequired = cityWidthsRequired + 1;
+    return;
+  }
+
+  canvas.cells[y][x] = cell;
+  canvas.changed = 1;
+}
 
-    cities[i].offset = bases[i >= (NUMBER_OF_CITIES / 2)].offset +
-                       BASE_WIDTH +
-                      (paddingRequired * ASSET_PADDING) +
-                      (cityWidthsRequired * CITY_WIDTH);
+/**
+ * applyCanvasEdit
+ * Description: Makes a change to a cell of the canvas, if its rule allows it.
+ * Params:
+ * edit - the change to make
+ */
+void applyCanvasEdit(struct CanvasEdit* edit)
+{
+  if(edit->y < 0 || edit->y >= VIEWPORT_HEIGHT || edit->x < 0 || edit->x >= VIEWPORT_WIDTH)
+  {
+    return;
   }
 
-  for(int i = 0; i < NUMBER_OF_CITIES; i++)
+  chtype current = canvas.cells[edit->y][edit->x];
+
+  if(edit->rule == drawUnlessEnemyHead && (current & A_CHARTEXT) == '*' && (current & A_COLOR) >> 24 == WHITE)
   {
-    cities[i].isAlive = 1;
+    return;
+  }
 
-    cities[i].enemyMissileTarget.x = cities[i].offset + 2;
-    cities[i].enemyMissileTarget.y = VIEWPORT_HEIGHT - GROUND_HEIGHT - 4;
+  if(edit->rule == eraseIfColour && (current & A_COLOR) >> 24 != edit->colour)
+  {
+    return;
   }
+
+  storeCanvasCell(edit->y, edit->x, edit->cell);
 }
 
 /**
- * isBaseActive
- * Description: Determines whether the base is capable of firing a missile.
+ * editCanvas
+ * Description:
+ * Changes a cell of the canvas by a rule. While a task records its edits, the change is added to them instead.
+ * The rule is tested when the change is made, so recorded edits have the same effect as if they had been made at once in the same order.
  * Params:
- * base - a pointer to the base that is inspected, to determine if it is active
- * Returns: 1 if base is active, else 0
+ * y - the row of the cell
+ * x - the column of the cell
+ * cell - the character and colour to set it to
+ * rule - when the change is made, from canvasEditRules
+ * colour - for eraseIfColour, the colour that the cell must be in
  */
-int isBaseActive(struct Base* base)
+void editCanvas(int y, int x, chtype cell, enum canvasEditRules rule, int colour)
 {
-  return base->ammoCount > 0 && base->isAlive;
+  struct CanvasEdit edit = {y, x, cell, rule, colour};
+  struct CanvasEdits* recorder = canvasRecorder;
+
+  if(!recorder)
+  {
+    applyCanvasEdit(&edit);
+    return;
+  }
+
+  if(recorder->count == recorder->capacity)
+  {
+    int capacity = recorder->capacity ? recorder->capacity * 2 : VIEWPORT_WIDTH * VIEWPORT_HEIGHT;
+    struct CanvasEdit* edits = realloc(recorder->edits, capacity * sizeof(struct CanvasEdit));
+
+    // The edit is lost if there is no memory for it.
+    if(!edits)
+    {
+      return;
+    }
+
+    recorder->edits = edits;
+    recorder->capacity = capacity;
+  }
+
+  recorder->edits[recorder->count++] = edit;
 }
 
 /**
- * hasMissileReachedDestination
- * Description: Determines whether the provided missile's current location is the same as its destination location.
+ * putCanvasCell
+ * Description: Sets a cell of the canvas. Cells outside the viewport are ignored.
  * Params:
- * m - the missile that is inspected to determine whether it has reached its destination
- * Returns: 1 if the missile has reached its destination, else 0
+ * y - the row of the cell
+ * x - the column of the cell
+ * cell - the character and colour to set it to
  */
-int hasMissileReachedDestination(struct Missile* m)
+void putCanvasCell(int y, int x, chtype cell)
 {
-  return m->currPos.x == m->destPos.x && m->currPos.y == m->destPos.y;
+  editCanvas(y, x, cell, drawAlways, 0);
 }
 
 /**
- * checkEndOfRoundPending
- * Description: Determines whether the game state should progress to prepare for the end of the round.
+ * putCanvasHead
+ * Description: Draws the head of a missile, unless the head of an enemy missile is already in the cell.
  * Params:
- * gameState - the state of the game. This is progressed to reflect the end of the round or game as required.
- * bases - the collection of bases
- * cities - the collection of cities
- * playerMissiles - the collection of player missiles
- * enemyMissiles - the collection of enemy missiles
- * enemyMissilesFired - the number of enemy missiles that have been created in the current round
+ * y - the row of the cell
+ * x - the column of the cell
+ * cell - the character and colour of the head
  */
-void checkEndOfRoundPending(enum gameStates* gameState, struct Base bases[], struct City cities[],
-                            struct Missile* playerMissiles, struct Missile* enemyMissiles, int enemyMissilesFired)
+void putCanvasHead(int y, int x, chtype cell)
 {
-  if(*gameState != ongoing)
-  {
-    return;
-  }
+  editCanvas(y, x, cell, drawUnlessEnemyHead, 0);
+}
 
-  int basesActive = 0;
+/**
+ * eraseCanvasTrail
+ * Description: Clears a cell of a missile trail, if it is still in the trail's colour.
+ * Params:
+ * y - the row of the cell
+ * x - the column of the cell
+ * colour - the colour of the trail
+ */
+void eraseCanvasTrail(int y, int x, int colour)
+{
+  editCanvas(y, x, ' ', eraseIfColour, colour);
+}
 
-  // The player must have an active base to continue the round.
-  for(int i = 0; i <= NUMBER_OF_BASES; i++)
+/**
+ * countTimerFired
+ * Description: Counts a timer firing for the flight recorder, in the running task's edits if there is one.
+ */
+void countTimerFired()
+{
+  if(canvasRecorder)
   {
-    if(isBaseActive(&bases[i]))
-    {
-      basesActive = 1;
-    }
+    canvasRecorder->timersFired++;
   }
-
-  int citiesSurvived = 0;
-
-  // The player must have a city that is alive to continue the round.
-  for(int i = 0; i < NUMBER_OF_CITIES; i++)
+  else
   {
-    if(cities[i].isAlive)
-    {
-      citiesSurvived = 1;
-    }
+    nextSnapshot->events.timersFired++;
   }
+}
 
-  int enemyMissilesRemaining = 0;
-
-  /*
-   * The enemy must have missiles left to fire or missiles
-   * currently active to continue the round.
-   */
-  if(enemyMissilesFired < ENEMY_MISSILES_PER_ROUND)
-  {
-    enemyMissilesRemaining = 1;
-  }
-  else
+/**
+ * getCanvasCell
+ * Description: Reads a cell of the canvas, as mvinch() reads a cell of a window.
+ * Params:
+ * y - the row of the cell
+ * x - the column of the cell
+ * Returns: the character and colour of the cell, or ERR if it is outside the viewport
+ */
+chtype getCanvasCell(int y, int x)
+{
+  if(y < 0 || y >= VIEWPORT_HEIGHT || x < 0 || x >= VIEWPORT_WIDTH)
   {
-    for(int i = 0; i < ENEMY_MISSILE_BUFFER; i++)
-    {
-      if(enemyMissiles[i].isActive)
-      {
-        enemyMissilesRemaining = 1;
-      }
-    }
+    return (chtype)ERR;
   }
 
-  int playerMissilesRemaining = 0;
+  return canvas.cells[y][x];
+}
 
-  /*
-   * The player must have missiles remaining or missiles
-   * currently active to continue the round.
-   */
-  if(getPlayerMissilesRemaining(bases) > 0)
+/**
+ * printCanvas
+ * Description: Writes formatted text to the canvas, as mvprintw() writes it to a window.
+ * Params:
+ * y - the row to write on
+ * x - the column of the first character
+ * colour - the colour pair to write in, from COLOR_PAIR()
+ * format - the printf() format of the text, followed by its arguments
+ */
+void printCanvas(int y, int x, chtype colour, const char* format, ...)
+{
+  char text[VIEWPORT_WIDTH + 1];
+  va_list args;
+
+  va_start(args, format);
+  vsnprintf(text, sizeof(text), format, args);
+  va_end(args);
+
+  for(int i = 0; text[i]; i++)
   {
-    playerMissilesRemaining = 1;
+    putCanvasCell(y, x + i, (unsigned char)text[i] | colour);
   }
-  else
+}
+
+/**
+ * blitCanvasSprite
+ * Description: Draws the opaque cells of a sprite onto the canvas, as blit_sprite() draws them onto stdscr.
+ * Params:
+ * y - the row of the sprite's top left corner
+ * x - the column of the sprite's top left corner
+ * sprite - the sprite to draw
+ */
+void blitCanvasSprite(int y, int x, PDC_SPRITE* sprite)
+{
+  for(int row = 0; row < sprite->_maxy; row++)
   {
-    for(int i = 0; i < PLAYER_MISSILE_BUFFER; i++)
+    for(int col = 0; col < sprite->_maxx; col++)
     {
-      if(playerMissiles[i].isActive)
+      if(sprite->_mask[row * sprite->_maxx + col])
       {
-        playerMissilesRemaining = 1;
+        putCanvasCell(y + row, x + col, sprite->_cells[row * sprite->_maxx + col]);
       }
     }
   }
-
-  if(!citiesSurvived || !basesActive || !enemyMissilesRemaining || !playerMissilesRemaining)
-  {
-    *gameState = roundEnding;
-  }
 }
 
 /**
- * checkEndOfRound
- * Description: Determines whether the round has ended, and whether it is a game over state or a next round state.
- * Params:
- * gameState - the state of the game. This is progressed to reflect the end of the round or game as required.
- * cities - the collection of cities
- * playerMissiles - the collection of player missiles
- * enemyMissiles - the collection of enemy missiles
- * enemyMissilesFired - the number of enemy missiles that have been created in the current round
+ * publishSnapshot
+ * Description:
+ * Copies the canvas into the snapshot being filled, and makes it the newest for the render thread to take.
+ * Then starts filling the snapshot that the exchange handed back. Simulation thread.
  */
-void checkEndOfRound(enum gameStates* gameState, struct City cities[], struct Missile playerMissiles[], struct Missile enemyMissiles[], int enemyMissilesFired)
+void publishSnapshot()
 {
-  if(*gameState != roundEnding)
-  {
-    return;
-  }
+  memcpy(nextSnapshot->cells, canvas.cells, sizeof(canvas.cells));
+  nextSnapshot->roundEnd = roundEndSummary;
+  nextSnapshot->showRoundEnd = roundEndShown;
+  canvas.changed = 0;
 
-  // All enemy missiles must have been fired to complete the round.
-  if(enemyMissilesFired < ENEMY_MISSILES_PER_ROUND)
-  {
-    return;
-  }
+  LONG previous = InterlockedExchange(&publishedSnapshot, simulationSnapshot | SNAPSHOT_FRESH);
 
-  int activeEnemyMissile = 0;
+  simulationSnapshot = previous & ~SNAPSHOT_FRESH;
+  nextSnapshot = &snapshots[simulationSnapshot];
 
-  for(int i = 0; i < ENEMY_MISSILE_BUFFER; i++)
+  /*
+   * The counts in a snapshot cover only the ticks since the last one the render thread took.
+   * A snapshot handed back while still fresh was never taken, so its counts are kept and added to.
+   */
+  if(!(previous & SNAPSHOT_FRESH))
   {
-    if(enemyMissiles[i].isActive)
-    {
-      activeEnemyMissile = 1;
-      break;
-    }
+    nextSnapshot->launchCount = 0;
+    memset(&nextSnapshot->events, 0, sizeof(nextSnapshot->events));
+    memset(nextSnapshot->phaseMicros, 0, sizeof(nextSnapshot->phaseMicros));
   }
 
-  int activePlayerMissile = 0;
+  SetEvent(snapshotReady);
+}
 
-  for(int i = 0; i < PLAYER_MISSILE_BUFFER; i++)
+/**
+ * takeSnapshot
+ * Description: Swaps the render thread's snapshot for the newest published one, if there is a newer one. Render thread.
+ * Returns: 1 if snapshots[renderSnapshot] is now a snapshot that has not been drawn, else 0
+ */
+int takeSnapshot()
+{
+  // Only this thread clears SNAPSHOT_FRESH, so a snapshot seen to be fresh is still there to take.
+  if(!(publishedSnapshot & SNAPSHOT_FRESH))
   {
-    if(playerMissiles[i].isActive)
-    {
-      activePlayerMissile = 1;
-      break;
-    }
+    return 0;
   }
 
-  // All missiles must be inactive to complete the round.
-  if(!activePlayerMissile && !activeEnemyMissile)
-  {
-    int citiesSurvived = 0;
+  LONG previous = InterlockedExchange(&publishedSnapshot, renderSnapshot);
 
-    for(int i = 0; i < NUMBER_OF_CITIES; i++)
-    {
-      if(cities[i].isAlive)
-      {
-        citiesSurvived = 1;
-        break;
-      }
-    }
+  renderSnapshot = previous & ~SNAPSHOT_FRESH;
 
-    // Game over if all cities have been destroyed, else a new round begins.
-    if(!citiesSurvived)
-    {
-      *gameState = endOfGame;
-    }
-    else
-    {
-      *gameState = endOfRound;
-    }
-  }
+  return 1;
 }
 
 /**
- * destroyAssets
- * Description: Sets the status of bases or cities to 0, if the asset has been hit with a missile explosion.
+ * pushClick
+ * Description: Passes a click on to the simulation thread. Input thread.
  * Params:
- * enemyMissiles - the collection of enemy missiles
- * bases - the collection of missile bases. These are assets that can be destroyed by enemy missiles.
- * cities - the collection of cities. These are assets that can be destroyed by enemy missiles.
+ * target - the cell that was clicked
+ * ticks - when PDCurses received the click, from PDC_get_ticks()
+ * Returns: 1 if the click was queued, or 0 if it was dropped because the ring is full
  */
-void destroyAssets(struct Missile enemyMissiles[], struct Base bases[], struct City cities[])
+int pushClick(struct Vector target, unsigned long ticks)
 {
-  for(int i = 0; i < ENEMY_MISSILE_BUFFER; i++)
-  {
-    if(hasMissileReachedDestination(&enemyMissiles[i]) && enemyMissiles[i].currPos.y == (VIEWPORT_HEIGHT - GROUND_HEIGHT - 4))
-    {
-      for(int j = 0; j < NUMBER_OF_BASES; j++)
-      {
-        // Decides which base was hit by the enemy missile.
-        if(bases[j].offset + 4 == enemyMissiles[i].destPos.x)
-        {
-          bases[j].isAlive = 0;
-          break;
-        }
-      }
+  LONG tail = inputRingTail;
 
-      for(int j = 0; j < NUMBER_OF_CITIES; j++)
-      {
-        // Decides which city was hit by the enemy missile.
-        if(cities[j].offset + 2 == enemyMissiles[i].destPos.x)
-        {
-          cities[j].isAlive = 0;
-          break;
-        }
-      }
-    }
+  if(tail - inputRingHead == INPUT_RING_SIZE)
+  {
+    inputRingDropped++;
+    return 0;
   }
+
+  inputRing[tail & (INPUT_RING_SIZE - 1)].target = target;
+  inputRing[tail & (INPUT_RING_SIZE - 1)].ticks = ticks;
+
+  // The exchange is a full barrier, so the click is written before the simulation thread can see it.
+  InterlockedExchange(&inputRingTail, tail + 1);
+  SetEvent(clicksReady);
+
+  return 1;
 }
 
 /**
- * initMissile
- * Description:
- * Initialises the provided missile.
- * This is called indirectly at the start of the game, and at the start of a new round through initMissiles().
- * It is also called directly on creating a new missile instance.
- * This function must be called prior to a new round beginning to prevent the missile from wrongly being considered active.
+ * takeClicks
+ * Description: Empties the input ring. Simulation thread.
  * Params:
- * m - the missile to initialise
+ * clicks - filled with the clicks that were queued, oldest first. Must hold INPUT_RING_SIZE clicks.
+ * Returns: the number of clicks taken
  */
-void initMissile(struct Missile* m)
+int takeClicks(struct Click clicks[])
 {
-  m->isActive = 0;
+  LONG head = inputRingHead;
+  LONG tail = inputRingTail;
+  int count = 0;
 
-  m->currPos.x = -1;
-  m->currPos.y = -1;
+  // Keeps the clicks from being read before the tail that says they have been written.
+  MemoryBarrier();
 
-  m->startPos.x = -1;
-  m->startPos.y = -1;
-
-  m->destPos.x = -1;
-  m->destPos.y = -1;
-
-  m->prevPos.x = -1;
-  m->prevPos.y = -1;
+  for(; head != tail; head++)
+  {
+    clicks[count++] = inputRing[head & (INPUT_RING_SIZE - 1)];
+  }
 
-  m->explosionTimer = 0;
+  // Hands the slots back to the input thread once they have been read.
+  InterlockedExchange(&inputRingHead, head);
 
-  m->explosionFrame = 0;
+  return count;
+}
 
-  m->canFragment = 0;
+/**
+ * getPlayerMissilesRemaining
+ * Description: Gets the number of missiles that the player can fire in the current round.
+ * Params:
+ * bases - the table of bases
+ * Return: the number of missiles remaining that the player can fire in the current round
+ */
+int getPlayerMissilesRemaining(struct ArchetypeTable* bases)
+{
+  int ammoCount = 0;
 
-  for(int row = 0; row < VIEWPORT_HEIGHT; row++)
+  for(int row = 0; row < bases->count; row++)
   {
-    for(int col = 0; col < VIEWPORT_WIDTH; col++)
+    if(bases->isAlive[row])
     {
-      m->trailCoords[col][row] = 0;
+      ammoCount += bases->ammoCount[row];
     }
   }
+
+  return ammoCount;
 }
 
 /**
- * initMissiles
- * Description: Initialises all missiles in the provided missile collection.
- * This must be called performed prior to a new round beginning to prevent missiles wrongly being considered active.
+ * drawScore
+ * Description: Draws the player's current score.
  * Params:
- * missiles - the collection of missiles to initialise
- * size - the size of the missiles[] array
+ * score - the player's score
  */
-void initMissiles(struct Missile missiles[], size_t size)
+void drawScore(int score)
 {
-  for(int i = 0; i < size; i++)
-  {
-    initMissile(&missiles[i]);
-  }
+  printCanvas(1, 1, COLOR_PAIR(RED), "%d", score);
 }
 
 /**
- * removeTrail
- * Description: Removes the trail from the provided missile.
+ * drawBaseMissileCount
+ * Description: Draws the number of missiles remaining in a given missile base.
  * Params:
- * m - a pointer to the missile that will have its trail removed
+ * bases - the table of bases
+ * row - the row of the base to draw the missile count for
  */
-void removeTrail(struct Missile* m)
+void drawBaseMissileCount(struct ArchetypeTable* bases, int row)
 {
-  for(int col = 0; col < VIEWPORT_WIDTH; col++)
-  {
-    for(int row = 0; row < VIEWPORT_HEIGHT; row++)
-    {
-      if(m->trailCoords[col][row])
-      {
-        m->trailCoords[col][row] = 0;
-
-        /*
-         * Only deletes parts of the trail that match the missiles colour.
-         * This prevents the trail deletion potentially triggering missile explosions (from obscuring the missile location).
-         */
-        if((A_COLOR & mvinch(row, col)) >> 24 == m->colour)
-        {
-          mvprintw(row, col, " ");
-        }
-      }
-    }
-  }
+  printCanvas(VIEWPORT_HEIGHT - GROUND_HEIGHT - 2, bases->offset[row] + 4, COLOR_PAIR(CYAN), "%d", bases->ammoCount[row]);
 }
 
 /**
- * checkInterceptions
- * Description:
- * Destroys enemy missiles that have been hit with a player missiles.
- * Increases the player's score by 25 for each enemy missile hit.
- *
- * This implementation means that enemy missiles will rarely detonate upon colliding with another enemyMissile, but
- * this issue cannot be trivially solved unless missile head colours do not differ from the trail; and therefore preventing
- * the need to redraw over the previous location.
+ * drawBases
+ * Description: Draws the bases
  * Params:
- * fragmentIndexes - an array that is populated with 1 in all indexes where the same index in enemyMissiles can fragment
- * enemyMissiles - the collection of enemyMissiles
+ * bases - the table of bases to draw
  */
-void checkInterceptions(struct Missile enemyMissiles[], int* score, int* enemyMissilesDestroyed)
+void drawBases(struct ArchetypeTable* bases)
 {
-  for(int i = 0; i < ENEMY_MISSILE_BUFFER; i++)
+  for(int row = 0; row < bases->count; row++)
   {
-    if(!hasMissileReachedDestination(&enemyMissiles[i]) && !enemyMissiles[i].explosionFrame)
+    if(bases->isAlive[row])
     {
-      chtype head = mvinch(enemyMissiles[i].currPos.y, enemyMissiles[i].currPos.x);
-
-      // Removes obscured missile as long as it is not obscured by a cross (target).
-      if(!((head & A_CHARTEXT) == '*' && (head & A_COLOR) >> 24 == WHITE) &&
-      (head & A_CHARTEXT) != 'X')
-      {
-        // Resetting the destination prevents the missile path from continuing once intercepted.
-        enemyMissiles[i].destPos.x = enemyMissiles[i].currPos.x;
-        enemyMissiles[i].destPos.y = enemyMissiles[i].currPos.y;
-
-        removeTrail(&enemyMissiles[i]);
-        enemyMissiles[i].explosionFrame = 1;
+      blitCanvasSprite(VIEWPORT_HEIGHT - GROUND_HEIGHT - 4, bases->offset[row], baseSprite);
 
-        *score += 25;
-        *enemyMissilesDestroyed += 1;
-      }
+      drawBaseMissileCount(bases, row);
     }
   }
 }
 
 /**
- * checkFragment
- * Description:
- * Retrieves the indexes of the enemyMissiles that are able to fragment.
- * A fragment is a second missile that forms at the current position of the base missile.
+ * drawCities
+ * Description: Draws the cities.
  * Params:
- * fragmentIndexes - an array that is populated with 1 in all indexes where the same index in enemyMissiles can fragment
- * enemyMissiles - the collection of enemyMissiles
+ * cities - the table of cities to draw
  */
-void checkFragment(int fragmentIndexes[], struct Missile enemyMissiles[])
+void drawCities(struct ArchetypeTable* cities)
 {
-  for(int i = 0; i < ENEMY_MISSILE_BUFFER; i++)
+  for(int row = 0; row < cities->count; row++)
   {
-    if((enemyMissiles[i].currPos.y == VIEWPORT_HEIGHT / 2)
-    && (enemyMissiles[i].prevPos.y == (enemyMissiles[i].currPos.y - 1))
-    && (enemyMissiles[i].isActive)
-    && (enemyMissiles[i].canFragment))
+    if(cities->isAlive[row])
     {
-      fragmentIndexes[i] = 1;
+      blitCanvasSprite(VIEWPORT_HEIGHT - GROUND_HEIGHT - 3, cities->offset[row], citySprite);
     }
   }
 }
 
 /**
- * getMillisElapsed
- * Description: Gets the elapsed time in milliseconds since the provided value was recorded.
+ * drawLandscape
+ * Description: Draws the ground, bases and cities.
  * Params:
- * lastTimeRecorded - the reference point in time that the elapsed time is calculated from
- * Returns: the elapsed time in milliseconds since the provided value was recorded
+ * bases - the table of missile bases
+ * cities - the table of cities
  */
-unsigned int getMillisElapsed(clock_t* lastTimeRecorded)
+void drawLandscape(struct ArchetypeTable* bases, struct ArchetypeTable* cities)
 {
-  return (unsigned int)(((double)(clock() - *lastTimeRecorded)) / CLOCKS_PER_SEC * 1000);
-}
 
-/**
- * updateAbstractMissile
- * Description: Coordinates the explosion and signals whether a movement update is required for a single missile.
- * Params:
- * index - the index of the missile in missiles[]
- * missiles - the collection of missiles to update
- * gameState - the state of the game
- * Returns: 1 if the missile should have its position updated on the current tick, else 0
- */
-int updateAbstractMissile(int index, struct Missile missiles[], enum gameStates* gameState)
-{
-  if(missiles[index].isActive)
+  // Draws ground.
+  for(int row = 0; row < GROUND_HEIGHT; row++)
   {
-    /*
-     * Initiates explosions for missiles that have reached their destination
-     * and removes their missile trail.
-     */
-    if(hasMissileReachedDestination(&missiles[index]))
+    for(int col = 0; col < VIEWPORT_WIDTH - 2; col++)
     {
-      if(!missiles[index].explosionFrame)
-      {
-        removeTrail(&missiles[index]);
-        missiles[index].explosionFrame = 1;
-      }
+      putCanvasCell(VIEWPORT_HEIGHT - 2 - row, col + 1, 'X' | COLOR_PAIR(YELLOW));
     }
+  }
 
-    // Attempts to progress the explosion if it has been initiated.
-    if(missiles[index].explosionFrame)
-    {
-      // Determines the speed of the explosion animation.
-      int millisBetweenExplosionUpdates = 100;
-
-      if(!missiles[index].explosionTimer || getMillisElapsed(&(missiles[index].explosionTimer)) > millisBetweenExplosionUpdates)
-      {
-        missiles[index].explosionTimer = clock();
+  // Draws bases.
+  drawBases(bases);
 
-        drawExplosion(&missiles[index]);
+  // Draws cities.
+  drawCities(cities);
+}
+
+/**
+ * drawRoundEnd
+ * Description:
+ * Adds the bonus for a survived round to the score, and publishes a snapshot that shows the round end banner.
+ * The banner stays up until hideRoundEnd() is called. Simulation thread.
+ * Params:
+ * score - the player's score
+ * bases - the table of missile bases
+ * cities - the table of cities
+ * enemyMissilesDestroyed - the number of enemy missiles intercepted in the current round
+ * roundNumber - the current round number
+ */
+void drawRoundEnd(int* score, struct ArchetypeTable* bases, struct ArchetypeTable* cities, int enemyMissilesDestroyed, int roundNumber)
+{
+  int basesSurvived = 0;
+  int ammoRemaining = getPlayerMissilesRemaining(bases);
+
+  for(int row = 0; row < bases->count; row++)
+  {
+    if(bases->isAlive[row])
+    {
+      basesSurvived++;
+    }
+  }
+
+  *score += 100 * basesSurvived + 5 * ammoRemaining;
+  drawScore(*score);
+
+  /*
+   * Redraws the landscape.
+   * Corrects any visual damage to surviving bases, cities and the ground.
+   */
+  drawLandscape(bases, cities);
+
+  roundEndSummary.roundNumber = roundNumber;
+  roundEndSummary.score = *score;
+  roundEndSummary.enemyMissilesDestroyed = enemyMissilesDestroyed;
+  roundEndSummary.basesSurvived = basesSurvived;
+  roundEndSummary.ammoRemaining = ammoRemaining;
+  roundEndShown = 1;
+  publishSnapshot();
+}
+
+/**
+ * hideRoundEnd
+ * Description: Publishes a snapshot without the round end banner. Simulation thread.
+ */
+void hideRoundEnd()
+{
+  roundEndShown = 0;
+  publishSnapshot();
+}
+
+/**
+ * drawRoundEndBanner
+ * Description: Draws the banner that appears at the end of a survived round. Render thread.
+ * Params:
+ * summary - the figures to show on the banner
+ */
+void drawRoundEndBanner(struct RoundEndSummary* summary)
+{
+  // The banner lives only until the next round starts, so it is taken from the overlay arena instead of the heap.
+  PDC_set_allocator(overlayAllocator);
+  roundEndBanner = newwin(ROUND_END_BANNER_HEIGHT, ROUND_END_BANNER_WIDTH, VIEWPORT_HEIGHT/2 - 5, VIEWPORT_WIDTH/2 - 17);
+  PDC_set_allocator(NULL);
+
+  if(roundEndBanner)
+  {
+    wattron(roundEndBanner, COLOR_PAIR(RED));
+
+    mvwprintw(roundEndBanner, 0, 11,             "ROUND %d CLEARED"             , summary->roundNumber);
+
+    mvwprintw(roundEndBanner, 2, 6,         "CIVILISATION HAS SURVIVED"        );
+
+    mvwprintw(roundEndBanner, 4, 13,                "SCORE: %d"                , summary->score);
+
+    mvwprintw(roundEndBanner, 6, 0, "MISSILES INTERCEPTED:  %02d X 25 POINTS" , summary->enemyMissilesDestroyed);
+    mvwprintw(roundEndBanner, 7, 0, "BASES SURVIVED:        %d X 100 POINTS"  , summary->basesSurvived);
+    mvwprintw(roundEndBanner, 8, 0, "MISSILES REMAINING:     %02d X 5 POINTS" , summary->ammoRemaining);
+  }
+}
+
+/**
+ * eraseRoundEnd
+ * Description: Erases the banner that appears at the end of a survived round, and empties the overlay arena it was allocated from. Render thread.
+ */
+void eraseRoundEnd()
+{
+  if(!roundEndBanner)
+  {
+    return;
+  }
+
+  delwin(roundEndBanner);
+  roundEndBanner = NULL;
+  PDC_arena_reset(&overlayArena);
+
+  // Restores the part of the viewport that the banner covered on the next refresh.
+  touchline(stdscr, VIEWPORT_HEIGHT/2 - 5, ROUND_END_BANNER_HEIGHT);
+}
+
+/**
+ * reportHeapAllocations
+ * Description: Prints the number of frames on which PDCurses allocated from the heap, so that regressions are noticed.
+ * Registered with atexit() in debug builds, so that it runs after endwin() has restored the terminal.
+ */
+void reportHeapAllocations()
+{
+  fprintf(stderr, "Frames that allocated from the heap: %lu of %lu\n", framesThatAllocated, framesPlayed);
+}
+
+/**
+ * reportRenderStats
+ * Description: Prints how much of the screen PDCurses examined and redrew on an average frame that drew anything, so that overdraw is noticed.
+ * Registered with atexit() in debug builds, so that it runs after endwin() has restored the terminal.
+ */
+void reportRenderStats()
+{
+  PDC_RENDER_STATS stats;
+  double frames = framesThatDrew ? framesThatDrew : 1;
+
+  PDC_get_render_stats(&stats);
+
+  fprintf(stderr, "Per frame that drew (%lu): %.1f changed lines scanned, %.1f cells compared, %.1f cells sent in %.1f runs, %.1f bytes written\n",
+    framesThatDrew, stats.lines / frames, stats.compared / frames, stats.cells / frames, stats.runs / frames, stats.bytes / frames);
+}
+
+/**
+ * recordLatency
+ * Description: Counts a delay in a latency histogram.
+ * Params:
+ * histogram - the histogram to count the delay in
+ * micros - the delay in microseconds
+ */
+void recordLatency(struct LatencyHistogram* histogram, unsigned long micros)
+{
+  unsigned long bucket = micros / LATENCY_BUCKET_MICROS;
+
+  histogram->buckets[bucket < LATENCY_BUCKETS ? bucket : LATENCY_BUCKETS - 1]++;
+  histogram->samples++;
+}
+
+/**
+ * getLatencyPercentile
+ * Description: Reads a percentile from a latency histogram. May be called at any point during play.
+ * Params:
+ * histogram - the histogram to read
+ * percentile - the percentile to read, from 1 to 100
+ * Returns: the upper edge, in microseconds, of the bucket that holds the percentile. 0 if the histogram is empty.
+ */
+unsigned long getLatencyPercentile(struct LatencyHistogram* histogram, int percentile)
+{
+  // The number of delays that are at or below the percentile, rounded up.
+  unsigned long rank = (histogram->samples * percentile + 99) / 100;
+  unsigned long counted = 0;
+
+  if(!histogram->samples)
+  {
+    return 0;
+  }
+
+  for(int i = 0; i < LATENCY_BUCKETS; i++)
+  {
+    counted += histogram->buckets[i];
+
+    if(counted >= rank)
+    {
+      return (unsigned long)(i + 1) * LATENCY_BUCKET_MICROS;
+    }
+  }
+
+  return (unsigned long)LATENCY_BUCKETS * LATENCY_BUCKET_MICROS;
+}
+
+/**
+ * reportLatencyHistogram
+ * Description: Prints the number of delays in a latency histogram, with their 50th, 95th and 99th percentiles.
+ * Params:
+ * name - what the delays measure
+ * histogram - the histogram to report
+ */
+void reportLatencyHistogram(const char* name, struct LatencyHistogram* histogram)
+{
+  fprintf(stderr, "%s (%lu samples): p50 %.2f ms, p95 %.2f ms, p99 %.2f ms\n", name, histogram->samples,
+    getLatencyPercentile(histogram, 50) / 1000.0, getLatencyPercentile(histogram, 95) / 1000.0, getLatencyPercentile(histogram, 99) / 1000.0);
+}
+
+/**
+ * reportLatency
+ * Description: Prints how long clicks took to launch missiles, and to put the missiles on screen.
+ * Registered with atexit() in debug builds, so that it runs after endwin() has restored the terminal.
+ */
+void reportLatency()
+{
+  reportLatencyHistogram("Click to missile launch", &clickToLaunch);
+  reportLatencyHistogram("Click to first missile cell on screen", &clickToFirstCell);
+  fprintf(stderr, "Clicks dropped by a full input ring: %lu\n", inputRingDropped);
+}
+
+/**
+ * collectFirstCellLatencies
+ * Description:
+ * Records the delay from click to screen for launched missiles whose first cell has been watched. Render thread.
+ * Must be called after the frame that drew the cells has been refreshed; a watch that has not completed by then never will, as the cell did not change.
+ */
+void collectFirstCellLatencies()
+{
+  for(int i = 0; i < firstCellWatchCount; i++)
+  {
+    unsigned long drawnTicks;
+
+    if(PDC_cell_drawn(firstCellWatches[i], &drawnTicks) == OK)
+    {
+      recordLatency(&clickToFirstCell, drawnTicks - firstCellClickTicks[i]);
+    }
+  }
+
+  firstCellWatchCount = 0;
+}
+
+#ifndef NDEBUG
+/**
+ * drawProfileOverlay
+ * Description: Fills the profiler overlay with the average and maximum microseconds spent in each phase over the last PROFILE_FRAMES frames.
+ */
+void drawProfileOverlay()
+{
+  werase(profileOverlay);
+  wmove(profileOverlay, 0, 0);
+
+  for(int phase = 0; phase < FRAME_PHASES; phase++)
+  {
+    unsigned long total = 0;
+    unsigned long longest = 0;
+
+    for(int frame = 0; frame < PROFILE_FRAMES; frame++)
+    {
+      total += phaseMicros[frame][phase];
+
+      if(phaseMicros[frame][phase] > longest)
+      {
+        longest = phaseMicros[frame][phase];
+      }
+    }
+
+    // Uses the first two letters of each name so that every phase fits on the row.
+    wprintw(profileOverlay, "%.2s %lu/%lu ", phaseNames[phase], total / PROFILE_FRAMES, longest);
+  }
+}
+
+/**
+ * toggleProfileOverlay
+ * Description: Shows or hides the profiler overlay along the top row of the viewport.
+ */
+void toggleProfileOverlay()
+{
+  if(!profileOverlay)
+  {
+    return;
+  }
+
+  profileOverlayShown = !profileOverlayShown;
+
+  if(profileOverlayShown)
+  {
+    drawProfileOverlay();
+  }
+  else
+  {
+    // Restores the row that the overlay covered on the next refresh.
+    touchline(stdscr, 0, 1);
+  }
+}
+
+/**
+ * initProfiler
+ * Description: Prepares the profiler overlay, and opens the CSV file if PROFILE_CSV_VARIABLE names one.
+ */
+void initProfiler()
+{
+  char* csvPath = getenv(PROFILE_CSV_VARIABLE);
+
+  profileOverlay = newwin(1, VIEWPORT_WIDTH, 0, 0);
+
+  if(profileOverlay)
+  {
+    wattron(profileOverlay, COLOR_PAIR(WHITE));
+  }
+
+  if(csvPath)
+  {
+    profileCsv = fopen(csvPath, "w");
+  }
+
+  if(profileCsv)
+  {
+    fprintf(profileCsv, "frame");
+
+    for(int phase = 0; phase < FRAME_PHASES; phase++)
+    {
+      fprintf(profileCsv, ",%s", phaseNames[phase]);
+    }
+
+    fprintf(profileCsv, "\n");
+  }
+}
+
+/**
+ * refreshProfileOverlay
+ * Description: Copies the profiler overlay over the top row of the viewport while it is shown. Called between refreshing stdscr and updating the screen.
+ */
+void refreshProfileOverlay()
+{
+  if(profileOverlayShown)
+  {
+    touchwin(profileOverlay);
+    wnoutrefresh(profileOverlay);
+  }
+}
+
+/**
+ * writeTraceEvent
+ * Description: Writes a span to the trace file as a complete event.
+ * Params:
+ * name - what the span timed
+ * category - "game" for the frame and its phases, "pdcurses" for the library's work
+ * thread - RENDER_THREAD_ID or SIMULATION_THREAD_ID, for the thread the span ran on
+ * start - when the span began, from PDC_get_ticks()
+ * end - when the span ended, from PDC_get_ticks()
+ * args - the members of the event's JSON args object, or "" for none
+ */
+void writeTraceEvent(const char* name, const char* category, int thread, unsigned long start, unsigned long end, const char* args)
+{
+  EnterCriticalSection(&traceLock);
+
+  fprintf(traceFile, "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%lu,\"dur\":%lu,\"pid\":1,\"tid\":%d,\"args\":{%s}}",
+    traceEventsWritten++ ? ",\n" : "", name, category, start - traceStartTicks, end - start, thread, args);
+
+  LeaveCriticalSection(&traceLock);
+}
+
+/**
+ * traceLibrarySpan
+ * Description: Writes a span of PDCurses' work to the trace file. Installed with PDC_set_trace_hook().
+ * Params:
+ * span - which PDC_SPAN_ the span is
+ * start - when the span began, from PDC_get_ticks()
+ * end - when the span ended, from PDC_get_ticks()
+ * arg1 - the first figure reported for the span
+ * arg2 - the second figure reported for the span, unused by PDC_SPAN_UPDATE_RECTS
+ */
+void traceLibrarySpan(int span, unsigned long start, unsigned long end, long arg1, long arg2)
+{
+  static const char* spanNames[] = {"wnoutrefresh", "doupdate", "PDC_transform_line", "PDC_update_rects"};
+  static const char* argNames[][2] = {{"lines", "cells"}, {"runs", "cells"}, {"line", "cells"}, {"rects", NULL}};
+  char args[64];
+
+  if(span < PDC_SPAN_WNOUTREFRESH || span > PDC_SPAN_UPDATE_RECTS)
+  {
+    return;
+  }
+
+  if(argNames[span][1])
+  {
+    snprintf(args, sizeof(args), "\"%s\":%ld,\"%s\":%ld", argNames[span][0], arg1, argNames[span][1], arg2);
+  }
+  else
+  {
+    snprintf(args, sizeof(args), "\"%s\":%ld", argNames[span][0], arg1);
+  }
+
+  // The input thread only reads from inputWindow, which is never refreshed, so every span is the render thread's.
+  writeTraceEvent(spanNames[span], "pdcurses", RENDER_THREAD_ID, start, end, args);
+}
+
+/**
+ * finishTrace
+ * Description: Closes the JSON in the trace file, and the file itself.
+ * Registered with atexit() when tracing, as the game leaves by calling exit() once the simulation thread has stopped.
+ */
+void finishTrace()
+{
+  PDC_set_trace_hook(NULL);
+
+  fprintf(traceFile, "\n]}\n");
+  fclose(traceFile);
+  traceFile = NULL;
+}
+
+/**
+ * initTracer
+ * Description: Opens the trace file if TRACE_VARIABLE names one, and has PDCurses report its work to it.
+ */
+void initTracer()
+{
+  char* tracePath = getenv(TRACE_VARIABLE);
+
+  if(!tracePath || !(traceFile = fopen(tracePath, "w")))
+  {
+    return;
+  }
+
+  fprintf(traceFile, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+  traceStartTicks = PDC_get_ticks();
+  InitializeCriticalSection(&traceLock);
+
+  PDC_set_trace_hook(traceLibrarySpan);
+  atexit(finishTrace);
+}
+
+/**
+ * endProfiledPhase
+ * Description:
+ * Adds the time since a phase began to its total, and writes the phase to the trace file.
+ * Simulation phases are added to the snapshot being filled, and reach the profile of the frame that takes it.
+ * Params:
+ * phase - the phase that has ended
+ */
+void endProfiledPhase(enum framePhases phase)
+{
+  unsigned long now = PDC_get_ticks();
+  int simulated = phase >= FIRST_SIMULATION_PHASE;
+
+  if(simulated)
+  {
+    nextSnapshot->phaseMicros[phase] += now - phaseStarted[phase];
+  }
+  else
+  {
+    phaseMicros[profiledFrame][phase] += now - phaseStarted[phase];
+  }
+
+  if(traceFile)
+  {
+    writeTraceEvent(phaseNames[phase], "game", simulated ? SIMULATION_THREAD_ID : RENDER_THREAD_ID, phaseStarted[phase], now, "");
+  }
+}
+
+/**
+ * endProfiledFrame
+ * Description: Writes the frame's profile to the CSV file and the frame to the trace file, then moves on to the next frame in the ring.
+ * The overlay is redrawn each time the ring wraps around.
+ */
+void endProfiledFrame()
+{
+  if(traceFile)
+  {
+    char args[32];
+
+    // Numbered as the flight recorder numbers frames, so that a slow frame in a recording can be found in the trace.
+    snprintf(args, sizeof(args), "\"frame\":%lu", (unsigned long)flightFrames);
+    writeTraceEvent("frame", "game", RENDER_THREAD_ID, phaseStarted[phaseRefresh], PDC_get_ticks(), args);
+  }
+
+  if(profileCsv)
+  {
+    fprintf(profileCsv, "%lu", csvFrames++);
+
+    for(int phase = 0; phase < FRAME_PHASES; phase++)
+    {
+      fprintf(profileCsv, ",%lu", phaseMicros[profiledFrame][phase]);
+    }
+
+    fprintf(profileCsv, "\n");
+  }
+
+  profiledFrame = (profiledFrame + 1) % PROFILE_FRAMES;
+
+  if(!profiledFrame && profileOverlayShown)
+  {
+    drawProfileOverlay();
+  }
+
+  for(int phase = 0; phase < FRAME_PHASES; phase++)
+  {
+    phaseMicros[profiledFrame][phase] = 0;
+  }
+}
+#endif
+
+/**
+ * initFlightRecorder
+ * Description: Sets the frame budget, from FRAME_BUDGET_VARIABLE if it holds a number of milliseconds.
+ */
+void initFlightRecorder()
+{
+  char* budget = getenv(FRAME_BUDGET_VARIABLE);
+  int millis = budget ? atoi(budget) : 0;
+
+  frameBudgetMicros = (millis > 0 ? millis : FRAME_BUDGET_MILLIS) * 1000UL;
+}
+
+/**
+ * beginFlightFrame
+ * Description: Starts recording the events of a new frame.
+ */
+void beginFlightFrame()
+{
+  memset(&flightFrame, 0, sizeof(flightFrame));
+
+  flightFrame.frame = flightFrames;
+  flightFrame.startTicks = PDC_get_ticks();
+
+  PDC_get_render_stats(&renderStatsAtFrameStart);
+}
+
+/**
+ * dumpFlightRecorder
+ * Description: Writes the recorded frames, oldest first, to a file named after the last of them. See flightrecord.h for the format.
+ */
+void dumpFlightRecorder()
+{
+  struct FlightRecorderHeader header;
+  uint32_t records = (flightFrames < FLIGHT_RECORDER_FRAMES) ? flightFrames : FLIGHT_RECORDER_FRAMES;
+  char path[32];
+
+  sprintf(path, "flight-%lu.mcfr", (unsigned long)flightFrames - 1);
+
+  FILE* file = fopen(path, "wb");
+
+  if(!file)
+  {
+    return;
+  }
+
+  memcpy(header.magic, FLIGHT_RECORDER_MAGIC, sizeof(header.magic));
+  header.version = FLIGHT_RECORDER_VERSION;
+  header.recordSize = sizeof(struct FlightRecord);
+  header.records = records;
+  header.budgetMicros = frameBudgetMicros;
+
+  fwrite(&header, sizeof(header), 1, file);
+
+  for(uint32_t frame = flightFrames - records; frame != flightFrames; frame++)
+  {
+    fwrite(&flightRecords[frame % FLIGHT_RECORDER_FRAMES], sizeof(struct FlightRecord), 1, file);
+  }
+
+  fclose(file);
+}
+
+/**
+ * endFlightFrame
+ * Description:
+ * Adds the frame to the flight recorder. If it took longer than the budget, the recorder is written out.
+ * Recordings are at least FLIGHT_RECORDER_FRAMES frames apart, so that they do not overlap.
+ * Params:
+ * checkBudget - 0 for frames that are slow on purpose, such as those that wait after a resize, else 1
+ */
+void endFlightFrame(int checkBudget)
+{
+  PDC_RENDER_STATS renderStats;
+
+  PDC_get_render_stats(&renderStats);
+
+  flightFrame.micros = PDC_get_ticks() - flightFrame.startTicks;
+  flightFrame.runs = renderStats.runs - renderStatsAtFrameStart.runs;
+  flightFrame.cellsDrawn = renderStats.cells - renderStatsAtFrameStart.cells;
+  flightFrame.bytesSent = renderStats.bytes - renderStatsAtFrameStart.bytes;
+
+  if(flightFrame.runs)
+  {
+    framesThatDrew++;
+  }
+
+  flightRecords[flightFrames % FLIGHT_RECORDER_FRAMES] = flightFrame;
+  flightFrames++;
+
+  if(checkBudget && flightFrame.micros > frameBudgetMicros && flightDumps < FLIGHT_RECORDER_MAX_DUMPS &&
+    (!flightDumps || flightFrames - lastFlightDumpFrame >= FLIGHT_RECORDER_FRAMES))
+  {
+    dumpFlightRecorder();
+
+    flightDumps++;
+    lastFlightDumpFrame = flightFrames;
+  }
+}
+
+/**
+ * applySnapshot
+ * Description:
+ * Copies a snapshot into stdscr, and shows or erases the round end banner to match it. Render thread.
+ * Also watches the first cells of the missiles it launched, and adds its events to the frame's flight record and profile.
+ * Params:
+ * snapshot - the snapshot taken from the simulation thread
+ */
+void applySnapshot(struct Snapshot* snapshot)
+{
+  // Only the cells that differ from stdscr are marked as changed, so doupdate() still sends just what moved.
+  for(int row = 0; row < VIEWPORT_HEIGHT; row++)
+  {
+    mvaddchnstr(row, 0, snapshot->cells[row], VIEWPORT_WIDTH);
+  }
+
+  if(snapshot->showRoundEnd && !roundEndBanner)
+  {
+    drawRoundEndBanner(&snapshot->roundEnd);
+  }
+  else if(!snapshot->showRoundEnd && roundEndBanner)
+  {
+    eraseRoundEnd();
+  }
+
+  for(int i = 0; i < snapshot->launchCount && firstCellWatchCount < PLAYER_MISSILE_BUFFER; i++)
+  {
+    int watch = PDC_watch_cell(snapshot->launches[i].startPos.y, snapshot->launches[i].startPos.x);
+
+    if(watch > 0)
+    {
+      firstCellWatches[firstCellWatchCount] = watch;
+      firstCellClickTicks[firstCellWatchCount] = snapshot->launches[i].clickTicks;
+      firstCellWatchCount++;
+    }
+  }
+
+  flightFrame.spawns += snapshot->events.spawns;
+  flightFrame.interceptions += snapshot->events.interceptions;
+  flightFrame.timersFired += snapshot->events.timersFired;
+
+#ifndef NDEBUG
+  for(int phase = FIRST_SIMULATION_PHASE; phase < FRAME_PHASES; phase++)
+  {
+    phaseMicros[profiledFrame][phase] += snapshot->phaseMicros[phase];
+  }
+#endif
+}
+
+/**
+ * drawGameEnd
+ * Description: Draws the text that appears at game over.
+ */
+void drawGameEnd()
+{
+  printCanvas(VIEWPORT_HEIGHT/2 - 1, VIEWPORT_WIDTH/2 - 1, COLOR_PAIR(RED), "THE");
+  printCanvas(VIEWPORT_HEIGHT/2 + 1, VIEWPORT_WIDTH/2 - 1, COLOR_PAIR(RED), "END");
+}
+
+/**
+ * drawExplosion
+ * Description: Draws the explosion animation for missiles.
+ * Params:
+ * missiles - the table of missiles
+ * row - the row of the missile to draw the explosion animation for
+ */
+void drawExplosion(struct ArchetypeTable* missiles, int row)
+{
+  // The final frame only signals the end of the animation, and is not drawn.
+  if(missiles->explosionFrame[row] < 1 || missiles->explosionFrame[row] > EXPLOSION_FRAMES)
+  {
+    return;
+  }
+
+  struct ExplosionFrame* frame = &explosionFrames[missiles->explosionFrame[row] - 1];
+
+  blitCanvasSprite(missiles->currY[row] + frame->offset.y, missiles->currX[row] + frame->offset.x, frame->sprite);
+}
+
+/**
+ * placeValues
+ * Description: Sets aside room for an array in the storage of an archetype table. Each array starts on a 16 byte boundary.
+ * Params:
+ * storage - the table's storage, or NULL while its size is being measured
+ * used - the bytes of storage set aside so far, which the array's size is added to
+ * count - the number of values in the array
+ * size - the size of each value
+ * Returns: the array, or NULL while the size is being measured
+ */
+void* placeValues(unsigned char* storage, size_t* used, size_t count, size_t size)
+{
+  void* values = storage ? storage + *used : NULL;
+
+  *used += (count * size + 15) & ~(size_t)15;
+
+  return values;
+}
+
+/**
+ * placeColumn
+ * Description: Sets aside a column of an archetype table in its storage, if the table's archetype has the component that the column belongs to.
+ * Params:
+ * table - the table
+ * component - the component that the column belongs to
+ * size - the size of each of the column's values
+ * storage - the table's storage, or NULL while its size is being measured
+ * used - the bytes of storage set aside so far
+ * Returns: the column, or NULL if the archetype lacks the component or the size is being measured
+ */
+void* placeColumn(struct ArchetypeTable* table, enum components component, size_t size, unsigned char* storage, size_t* used)
+{
+  if(!(table->components & component))
+  {
+    return NULL;
+  }
+
+  unsigned char* values = placeValues(storage, used, table->capacity, size);
+
+  // Remembers the column, so that whole rows can be cleared and moved.
+  if(values)
+  {
+    table->columns[table->columnCount].values = values;
+    table->columns[table->columnCount].size = size;
+    table->columnCount++;
+  }
+
+  return values;
+}
+
+/**
+ * layoutArchetypeTable
+ * Description: Lays out the columns of an archetype table one after another in its storage, followed by the trail pool if the archetype has trails.
+ * Params:
+ * table - the table
+ * storage - the table's storage, or NULL to measure the storage that the table needs
+ * Returns: the bytes of storage that the table needs
+ */
+size_t layoutArchetypeTable(struct ArchetypeTable* table, unsigned char* storage)
+{
+  size_t used = 0;
+
+  table->columnCount = 0;
+
+  table->currX = placeColumn(table, positionComponent, sizeof(short), storage, &used);
+  table->currY = placeColumn(table, positionComponent, sizeof(short), storage, &used);
+  table->prevX = placeColumn(table, positionComponent, sizeof(short), storage, &used);
+  table->prevY = placeColumn(table, positionComponent, sizeof(short), storage, &used);
+
+  table->startX = placeColumn(table, stepperComponent, sizeof(short), storage, &used);
+  table->startY = placeColumn(table, stepperComponent, sizeof(short), storage, &used);
+  table->destX = placeColumn(table, stepperComponent, sizeof(short), storage, &used);
+  table->destY = placeColumn(table, stepperComponent, sizeof(short), storage, &used);
+  table->fixedX = placeColumn(table, stepperComponent, sizeof(int32_t), storage, &used);
+  table->fixedY = placeColumn(table, stepperComponent, sizeof(int32_t), storage, &used);
+  table->stepX = placeColumn(table, stepperComponent, sizeof(int32_t), storage, &used);
+  table->stepY = placeColumn(table, stepperComponent, sizeof(int32_t), storage, &used);
+  table->stepsLeft = placeColumn(table, stepperComponent, sizeof(int32_t), storage, &used);
 
-        // Deactivates the missile once the explosion has finished.
-        if(missiles[index].explosionFrame == 7)
-        {
-          missiles[index].isActive = 0;
-        }
-        // Progresses the explosion animation.
-        else
-        {
-          missiles[index].explosionFrame++;
-        }
+  table->explosionFrame = placeColumn(table, explosionComponent, sizeof(short), storage, &used);
+  table->explosionTimer = placeColumn(table, explosionComponent, sizeof(clock_t), storage, &used);
+
+  table->trail = placeColumn(table, trailComponent, sizeof(int), storage, &used);
+  table->colour = placeColumn(table, trailComponent, sizeof(short), storage, &used);
+
+  table->canFragment = placeColumn(table, fragmentComponent, sizeof(char), storage, &used);
+
+  table->offset = placeColumn(table, assetComponent, sizeof(short), storage, &used);
+  table->isAlive = placeColumn(table, assetComponent, sizeof(char), storage, &used);
+
+  table->targetX = placeColumn(table, targetComponent, sizeof(short), storage, &used);
+  table->targetY = placeColumn(table, targetComponent, sizeof(short), storage, &used);
+
+  table->ammoCount = placeColumn(table, launcherComponent, sizeof(short), storage, &used);
+  table->sourceX = placeColumn(table, launcherComponent, sizeof(short), storage, &used);
+  table->sourceY = placeColumn(table, launcherComponent, sizeof(short), storage, &used);
+
+  // Trails are found by handle rather than by row, so they are not columns.
+  if(table->components & trailComponent)
+  {
+    table->trails.cells = placeValues(storage, &used, (size_t)table->capacity * TRAIL_LENGTH, sizeof(struct Vector));
+    table->trails.lengths = placeValues(storage, &used, table->capacity, sizeof(short));
+    table->trails.freeHandles = placeValues(storage, &used, table->capacity, sizeof(int));
+  }
+
+  // Moves are listed in the order they are made rather than by row, so they are not columns either.
+  if(table->components & stepperComponent)
+  {
+    table->moves.rows = placeValues(storage, &used, table->capacity, sizeof(int32_t));
+    table->moves.x = placeValues(storage, &used, table->capacity, sizeof(int32_t));
+    table->moves.y = placeValues(storage, &used, table->capacity, sizeof(int32_t));
+  }
+
+  return used;
+}
+
+/**
+ * initArchetypeTable
+ * Description:
+ * Creates an empty table for the entities of an archetype.
+ * All of the table's memory is allocated here, before the game starts, so that no frame has to allocate.
+ * Params:
+ * table - the table to create
+ * components - the archetype, from components
+ * capacity - the most entities that the table can hold
+ * headColour - the colour that the head of a moving entity is drawn in
+ * Returns: 1 if the table was created, else 0
+ */
+int initArchetypeTable(struct ArchetypeTable* table, unsigned int components, int capacity, short headColour)
+{
+  memset(table, 0, sizeof(*table));
+
+  table->components = components;
+  table->capacity = capacity;
+  table->headColour = headColour;
+
+  table->storage = calloc(1, layoutArchetypeTable(table, NULL));
+
+  if(!table->storage)
+  {
+    return 0;
+  }
+
+  layoutArchetypeTable(table, table->storage);
+
+  // Every trail is free to begin with.
+  if(components & trailComponent)
+  {
+    for(int i = 0; i < capacity; i++)
+    {
+      table->trails.freeHandles[i] = capacity - 1 - i;
+    }
+
+    table->trails.freeCount = capacity;
+  }
+
+  return 1;
+}
+
+/**
+ * freeArchetypeTable
+ * Description: Frees the memory of an archetype table.
+ * Params:
+ * table - the table
+ */
+void freeArchetypeTable(struct ArchetypeTable* table)
+{
+  free(table->storage);
+  table->storage = NULL;
+  table->count = 0;
+}
+
+/**
+ * addEntity
+ * Description: Adds an entity to the end of an archetype table, with its columns cleared and, if the archetype has trails, an empty trail.
+ * Params:
+ * table - the table
+ * Returns: the row of the new entity, or -1 if the table is full
+ */
+int addEntity(struct ArchetypeTable* table)
+{
+  if(table->count == table->capacity)
+  {
+    return -1;
+  }
+
+  int row = table->count++;
+
+  for(int i = 0; i < table->columnCount; i++)
+  {
+    memset(table->columns[i].values + row * table->columns[i].size, 0, table->columns[i].size);
+  }
+
+  if(table->components & trailComponent)
+  {
+    int handle = table->trails.freeHandles[--table->trails.freeCount];
+
+    table->trail[row] = handle;
+    table->trails.lengths[handle] = 0;
+  }
+
+  return row;
+}
+
+/**
+ * removeEntity
+ * Description:
+ * Removes an entity from an archetype table, freeing its trail.
+ * The last entity is moved into its row, so that the rows stay dense; callers walking the table must look at the row again.
+ * Params:
+ * table - the table
+ * row - the row of the entity to remove
+ */
+void removeEntity(struct ArchetypeTable* table, int row)
+{
+  if(table->components & trailComponent)
+  {
+    table->trails.freeHandles[table->trails.freeCount++] = table->trail[row];
+  }
+
+  int last = --table->count;
+
+  if(row != last)
+  {
+    for(int i = 0; i < table->columnCount; i++)
+    {
+      size_t size = table->columns[i].size;
+
+      memcpy(table->columns[i].values + row * size, table->columns[i].values + last * size, size);
+    }
+  }
+}
+
+/**
+ * removeAllEntities
+ * Description: Empties an archetype table. This must be called prior to a new round beginning.
+ * Params:
+ * table - the table
+ */
+void removeAllEntities(struct ArchetypeTable* table)
+{
+  while(table->count)
+  {
+    removeEntity(table, table->count - 1);
+  }
+}
+
+/**
+ * addTrailCell
+ * Description: Adds a cell to the trail of an entity.
+ * Params:
+ * table - the table of the entity
+ * row - the row of the entity
+ * x - the x coordinate of the cell
+ * y - the y coordinate of the cell
+ */
+void addTrailCell(struct ArchetypeTable* table, int row, short x, short y)
+{
+  int handle = table->trail[row];
+  short length = table->trails.lengths[handle];
+
+  if(length < TRAIL_LENGTH)
+  {
+    table->trails.cells[handle * TRAIL_LENGTH + length] = (struct Vector){x, y};
+    table->trails.lengths[handle] = length + 1;
+  }
+}
+
+/**
+ * aimMissile
+ * Description:
+ * Sets the steps that take a missile from its start position to its destination.
+ * Each step moves the missile one cell along the major axis of its path, and a fixed point fraction of a cell along the other.
+ * Params:
+ * missiles - the table of missiles
+ * row - the row of the missile, whose start position and destination have been set
+ */
+void aimMissile(struct ArchetypeTable* missiles, int row)
+{
+  int flightX = missiles->destX[row] - missiles->startX[row];
+  int flightY = missiles->destY[row] - missiles->startY[row];
+  int steps = (abs(flightX) > abs(flightY)) ? abs(flightX) : abs(flightY);
+
+  missiles->fixedX[row] = missiles->startX[row] * MISSILE_FIXED_ONE;
+  missiles->fixedY[row] = missiles->startY[row] * MISSILE_FIXED_ONE;
+  missiles->stepX[row] = steps ? flightX * MISSILE_FIXED_ONE / steps : 0;
+  missiles->stepY[row] = steps ? flightY * MISSILE_FIXED_ONE / steps : 0;
+  missiles->stepsLeft[row] = steps;
+}
+
+/**
+ * initBases
+ * Description: Initialises the state for bases.
+ * Params:
+ * bases - the table of bases to initialise. Its rows are left, centre and right.
+ */
+void initBases(struct ArchetypeTable* bases)
+{
+  // Horizontal offsets for missile bases.
+  short offsets[NUMBER_OF_BASES] = {1, VIEWPORT_WIDTH/2 - 4, VIEWPORT_WIDTH - 10};
+
+  removeAllEntities(bases);
+
+  for(int i = 0; i < NUMBER_OF_BASES; i++)
+  {
+    int row = addEntity(bases);
+
+    bases->offset[row] = offsets[i];
+    bases->isAlive[row] = 1;
+    bases->ammoCount[row] = MISSILES_PER_BASE;
+
+    bases->targetX[row] = offsets[i] + 4;
+    bases->targetY[row] = VIEWPORT_HEIGHT - GROUND_HEIGHT - 4;
+
+    bases->sourceX[row] = offsets[i] + 4;
+    bases->sourceY[row] = VIEWPORT_HEIGHT - GROUND_HEIGHT - 5;
+  }
+}
+
+/**
+ * initCities
+ * Description: Initialises the state for cities.
+ * Params:
+ * cities - the table of cities that are initialised
+ * bases - the table of bases. Provided because cities are positioned relative to the bases.
+ */
+void initCities(struct ArchetypeTable* cities, struct ArchetypeTable* bases)
+{
+  removeAllEntities(cities);
+
+  for(int i = 0; i < NUMBER_OF_CITIES; i++)
+  {
+    int row = addEntity(cities);
+
+    // Horizontal offsets for cities.
+    short cityWidthsRequired = i % (NUMBER_OF_CITIES / 2);
+    int paddingRequired = cityWidthsRequired + 1;
+
+    cities->offset[row] = bases->offset[i >= (NUMBER_OF_CITIES / 2)] +
+                          BASE_WIDTH +
+                         (paddingRequired * ASSET_PADDING) +
+                         (cityWidthsRequired * CITY_WIDTH);
+
+    cities->isAlive[row] = 1;
+
+    cities->targetX[row] = cities->offset[row] + 2;
+    cities->targetY[row] = VIEWPORT_HEIGHT - GROUND_HEIGHT - 4;
+  }
+}
+
+/**
+ * isBaseActive
+ * Description: Determines whether the base is capable of firing a missile.
+ * Params:
+ * bases - the table of bases
+ * row - the row of the base that is inspected, to determine if it is active
+ * Returns: 1 if base is active, else 0
+ */
+int isBaseActive(struct ArchetypeTable* bases, int row)
+{
+  return bases->ammoCount[row] > 0 && bases->isAlive[row];
+}
+
+/**
+ * hasMissileReachedDestination
+ * Description: Determines whether the provided missile has taken every step to its destination location.
+ * Params:
+ * missiles - the table of missiles
+ * row - the row of the missile that is inspected to determine whether it has reached its destination
+ * Returns: 1 if the missile has reached its destination, else 0
+ */
+int hasMissileReachedDestination(struct ArchetypeTable* missiles, int row)
+{
+  return !missiles->stepsLeft[row];
+}
+
+/**
+ * checkEndOfRoundPending
+ * Description: Determines whether the game state should progress to prepare for the end of the round.
+ * Params:
+ * gameState - the state of the game. This is progressed to reflect the end of the round or game as required.
+ * bases - the table of bases
+ * cities - the table of cities
+ * playerMissiles - the table of player missiles
+ * enemyMissiles - the table of enemy missiles
+ * enemyMissilesFired - the number of enemy missiles that have been created in the current round
+ */
+void checkEndOfRoundPending(enum gameStates* gameState, struct ArchetypeTable* bases, struct ArchetypeTable* cities,
+                            struct ArchetypeTable* playerMissiles, struct ArchetypeTable* enemyMissiles, int enemyMissilesFired)
+{
+  if(*gameState != ongoing)
+  {
+    return;
+  }
+
+  int basesActive = 0;
+
+  // The player must have an active base to continue the round.
+  for(int row = 0; row < bases->count; row++)
+  {
+    if(isBaseActive(bases, row))
+    {
+      basesActive = 1;
+    }
+  }
+
+  int citiesSurvived = 0;
+
+  // The player must have a city that is alive to continue the round.
+  for(int row = 0; row < cities->count; row++)
+  {
+    if(cities->isAlive[row])
+    {
+      citiesSurvived = 1;
+    }
+  }
+
+  /*
+   * The enemy must have missiles left to fire or missiles
+   * currently active to continue the round.
+   */
+  int enemyMissilesRemaining = enemyMissilesFired < ENEMY_MISSILES_PER_ROUND || enemyMissiles->count > 0;
+
+  /*
+   * The player must have missiles remaining or missiles
+   * currently active to continue the round.
+   */
+  int playerMissilesRemaining = getPlayerMissilesRemaining(bases) > 0 || playerMissiles->count > 0;
+
+  if(!citiesSurvived || !basesActive || !enemyMissilesRemaining || !playerMissilesRemaining)
+  {
+    *gameState = roundEnding;
+  }
+}
+
+/**
+ * checkEndOfRound
+ * Description: Determines whether the round has ended, and whether it is a game over state or a next round state.
+ * Params:
+ * gameState - the state of the game. This is progressed to reflect the end of the round or game as required.
+ * cities - the table of cities
+ * playerMissiles - the table of player missiles
+ * enemyMissiles - the table of enemy missiles
+ * enemyMissilesFired - the number of enemy missiles that have been created in the current round
+ */
+void checkEndOfRound(enum gameStates* gameState, struct ArchetypeTable* cities, struct ArchetypeTable* playerMissiles,
+                     struct ArchetypeTable* enemyMissiles, int enemyMissilesFired)
+{
+  if(*gameState != roundEnding)
+  {
+    return;
+  }
+
+  // All enemy missiles must have been fired to complete the round.
+  if(enemyMissilesFired < ENEMY_MISSILES_PER_ROUND)
+  {
+    return;
+  }
+
+  // All missiles must be inactive to complete the round.
+  if(!playerMissiles->count && !enemyMissiles->count)
+  {
+    int citiesSurvived = 0;
+
+    for(int row = 0; row < cities->count; row++)
+    {
+      if(cities->isAlive[row])
+      {
+        citiesSurvived = 1;
+        break;
+      }
+    }
+
+    // Game over if all cities have been destroyed, else a new round begins.
+    if(!citiesSurvived)
+    {
+      *gameState = endOfGame;
+    }
+    else
+    {
+      *gameState = endOfRound;
+    }
+  }
+}
+
+/**
+ * destroyAssetAt
+ * Description: Sets the status of the base or city that is targeted from the given x coordinate to 0.
+ * Params:
+ * assets - the table of bases or cities
+ * targetX - the x coordinate of the target that was hit
+ * Returns: 1 if an asset was targeted from targetX, else 0
+ */
+int destroyAssetAt(struct ArchetypeTable* assets, short targetX)
+{
+  for(int row = 0; row < assets->count; row++)
+  {
+    if(assets->targetX[row] == targetX)
+    {
+      assets->isAlive[row] = 0;
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+/**
+ * destroyAssets
+ * Description: Sets the status of bases or cities to 0, if the asset has been hit with a missile explosion.
+ * Params:
+ * enemyMissiles - the table of enemy missiles
+ * bases - the table of missile bases. These are assets that can be destroyed by enemy missiles.
+ * cities - the table of cities. These are assets that can be destroyed by enemy missiles.
+ */
+void destroyAssets(struct ArchetypeTable* enemyMissiles, struct ArchetypeTable* bases, struct ArchetypeTable* cities)
+{
+  for(int row = 0; row < enemyMissiles->count; row++)
+  {
+    if(hasMissileReachedDestination(enemyMissiles, row) && enemyMissiles->currY[row] == (VIEWPORT_HEIGHT - GROUND_HEIGHT - 4))
+    {
+      // Decides which base or city was hit by the enemy missile.
+      if(!destroyAssetAt(bases, enemyMissiles->destX[row]))
+      {
+        destroyAssetAt(cities, enemyMissiles->destX[row]);
       }
     }
+  }
+}
+
+/**
+ * removeTrail
+ * Description: Removes the trail from the provided missile.
+ * Params:
+ * missiles - the table of missiles
+ * row - the row of the missile that will have its trail removed
+ */
+void removeTrail(struct ArchetypeTable* missiles, int row)
+{
+  int handle = missiles->trail[row];
+  struct Vector* cells = &missiles->trails.cells[handle * TRAIL_LENGTH];
 
-    // If true, signals that the missile movement should be performed.
-    return !hasMissileReachedDestination(&missiles[index]);
+  for(int i = 0; i < missiles->trails.lengths[handle]; i++)
+  {
+    /*
+     * Only deletes parts of the trail that match the missiles colour.
+     * This prevents the trail deletion potentially triggering missile explosions (from obscuring the missile location).
+     */
+    eraseCanvasTrail(cells[i].y, cells[i].x, missiles->colour[row]);
   }
 
-  return 0;
+  missiles->trails.lengths[handle] = 0;
 }
 
 /**
- * updatePlayerMissiles
- * Description:
- * Updates the state of player missiles.
- * Coordinates explosions and signals whether missile movement is required.
- * Also moves player missiles towards their destination.
+ * getBlastShape
+ * Description: Gets the blast of an exploding missile, which is the shape of the explosion frame that was last drawn for it.
  * Params:
- * missiles - the collection of player missiles to update
- * gameState - the state of the game
- * timer - coordinates timing for missile movement
+ * missiles - the table of missiles
+ * row - the row of the missile
+ * Returns: the blast, or NULL if no frame has been drawn for the missile
  */
-void updatePlayerMissiles(struct Missile missiles[], enum gameStates* gameState, clock_t* timer)
+struct BlastShape* getBlastShape(struct ArchetypeTable* missiles, int row)
 {
-  // Determines the rate of enemy missile movement updates.
-  unsigned short millisBetweenMovementUpdate = (*gameState == roundEnding) ? 12 : 14;
+  // The frame is advanced as soon as it has been drawn.
+  int drawn = missiles->explosionFrame[row] - 1;
 
-  // Determines whether a movement update should be performed on the current tick.
-  int updateTimer = !(*timer) || getMillisElapsed(timer) > millisBetweenMovementUpdate;
+  if(drawn < 1 || drawn > EXPLOSION_FRAMES)
+  {
+    return NULL;
+  }
+
+  return &explosionFrames[drawn - 1].blast;
+}
+
+/**
+ * isWarhead
+ * Description: Determines whether an enemy missile can be set off by a blast; that is, whether it is still flying and not yet exploding.
+ * Params:
+ * enemyMissiles - the table of enemy missiles
+ * row - the row of the missile
+ * Returns: 1 if the missile can be set off, else 0
+ */
+int isWarhead(struct ArchetypeTable* enemyMissiles, int row)
+{
+  return !hasMissileReachedDestination(enemyMissiles, row) && !enemyMissiles->explosionFrame[row];
+}
+
+/**
+ * getBlastGridBucket
+ * Description: Gets the bucket of the blast grid that a cell falls in, keeping cells outside the viewport in the buckets at its edges.
+ * Params:
+ * x - the x coordinate of the cell
+ * y - the y coordinate of the cell
+ * Returns: the index of the bucket
+ */
+int getBlastGridBucket(int x, int y)
+{
+  int col = (x < 0) ? 0 : (x >= VIEWPORT_WIDTH) ? BLAST_GRID_COLUMNS - 1 : x / BLAST_GRID_CELL;
+  int row = (y < 0) ? 0 : (y >= VIEWPORT_HEIGHT) ? BLAST_GRID_ROWS - 1 : y / BLAST_GRID_CELL;
+
+  return row * BLAST_GRID_COLUMNS + col;
+}
+
+/**
+ * fillBlastGrid
+ * Description: Sorts the enemy missiles that can be set off into the buckets of the blast grid, by counting them into place.
+ * Params:
+ * grid - the blast grid
+ * enemyMissiles - the table of enemy missiles
+ */
+void fillBlastGrid(struct BlastGrid* grid, struct ArchetypeTable* enemyMissiles)
+{
+  memset(grid->bucketStarts, 0, sizeof(grid->bucketStarts));
 
-  for(int i = 0; i < PLAYER_MISSILE_BUFFER; i++)
+  // Counts the missiles in each bucket, in the element after the bucket's own.
+  for(int row = 0; row < enemyMissiles->count; row++)
   {
-    if(updateAbstractMissile(i, missiles, gameState) && updateTimer)
+    if(isWarhead(enemyMissiles, row))
     {
-      struct Vector flightPath = {missiles[i].destPos.x - missiles[i].startPos.x, abs(missiles[i].destPos.y - missiles[i].startPos.y)};
+      grid->bucketStarts[getBlastGridBucket(enemyMissiles->currX[row], enemyMissiles->currY[row]) + 1]++;
+    }
+  }
 
-      // Moves missile vertically.
-      if(missiles[i].currPos.x == missiles[i].destPos.x)
-      {
-        missiles[i].currPos.y--;
-      }
-      // Moves the missile on trajectories with a greater horizontal component.
-      else if(abs(flightPath.x) >= flightPath.y)
-      {
-        double theta = atan2(flightPath.y, abs(flightPath.x));
+  for(int bucket = 0; bucket < BLAST_GRID_COLUMNS * BLAST_GRID_ROWS; bucket++)
+  {
+    grid->bucketStarts[bucket + 1] += grid->bucketStarts[bucket];
+  }
 
-        missiles[i].currPos.y = missiles[i].startPos.y - round(tan(theta) * (abs(missiles[i].currPos.x - missiles[i].startPos.x) + 1));
+  // Places each missile, using the starts as cursors; this leaves each start where the next bucket's begins.
+  for(int row = 0; row < enemyMissiles->count; row++)
+  {
+    if(isWarhead(enemyMissiles, row))
+    {
+      grid->warheads[grid->bucketStarts[getBlastGridBucket(enemyMissiles->currX[row], enemyMissiles->currY[row])]++] = row;
+    }
+  }
 
-        if(flightPath.x > 0)
-        {
-          missiles[i].currPos.x++;
-        }
-        else
-        {
-          missiles[i].currPos.x--;
-        }
-      }
-      // Moves the missile on trajectories with a greater vertical component.
-      else
-      {
-        double theta = atan2(abs(flightPath.x), flightPath.y);
+  // Shifts the starts back by a bucket.
+  for(int bucket = BLAST_GRID_COLUMNS * BLAST_GRID_ROWS; bucket > 0; bucket--)
+  {
+    grid->bucketStarts[bucket] = grid->bucketStarts[bucket - 1];
+  }
 
-        missiles[i].currPos.y--;
+  grid->bucketStarts[0] = 0;
+}
 
-        if(flightPath.x > 0)
-        {
-          missiles[i].currPos.x = missiles[i].startPos.x + round(tan(theta) * abs(missiles[i].startPos.y - missiles[i].currPos.y));
-        }
-        else
-        {
-          missiles[i].currPos.x = missiles[i].startPos.x - round(tan(theta) * abs(missiles[i].startPos.y - missiles[i].currPos.y));
-        }
-      }
+/**
+ * isInBlast
+ * Description: Determines whether a cell is in a blast.
+ * Params:
+ * blast - the blast
+ * x - the x coordinate of the cell
+ * y - the y coordinate of the cell
+ * Returns: 1 if the cell is in the blast, else 0
+ */
+int isInBlast(struct Blast* blast, int x, int y)
+{
+  int col = x - blast->centre.x + BLAST_WIDTH / 2;
+  int row = y - blast->centre.y + BLAST_HEIGHT / 2;
+
+  return col >= 0 && col < BLAST_WIDTH && row >= 0 && row < BLAST_HEIGHT && blast->shape->cells[row][col];
+}
 
-      missiles[i].trailCoords[missiles[i].currPos.x][missiles[i].currPos.y] = 1;
+/**
+ * queueExplodingMissiles
+ * Description: Adds the blasts of the missiles in a table whose explosions are being drawn to the blasts waiting to be checked.
+ * Params:
+ * grid - the blast grid
+ * blastCount - the number of blasts waiting, which is increased by the number added
+ * missiles - the table of missiles
+ */
+void queueExplodingMissiles(struct BlastGrid* grid, int* blastCount, struct ArchetypeTable* missiles)
+{
+  for(int row = 0; row < missiles->count; row++)
+  {
+    struct BlastShape* shape = getBlastShape(missiles, row);
 
-       //Stores the character in the missile's updated location.
-      int charRead = mvinch(missiles[i].currPos.y, missiles[i].currPos.x);
+    if(shape)
+    {
+      grid->blasts[(*blastCount)++] = (struct Blast){{missiles->currX[row], missiles->currY[row]}, shape};
+    }
+  }
+}
 
-      /*
-       * Draws the head of the missile.
-       *
-       * Prevents the missile path destroying enemy missiles.
-       * The path cannot draw over white asterisks (the head of enemy missiles).
-       */
-      if(!(((charRead & A_CHARTEXT) == '*') && ((A_COLOR & charRead) >> 24 == WHITE)))
+/**
+ * checkInterceptions
+ * Description:
+ * Destroys enemy missiles that have been caught in a blast, whether of a player missile, an enemy missile that has reached its
+ * destination, or another enemy missile that has been destroyed. Increases the player's score by 25 for each enemy missile destroyed.
+ *
+ * Each destroyed missile's warhead goes off with the blast of every explosion frame at once. Its blast is checked in turn, breadth first,
+ * so that a chain reaction plays out in full in a single tick. Missiles are found through the blast grid, so each blast only looks at the
+ * missiles near it.
+ * Params:
+ * playerMissiles - the table of player missiles
+ * enemyMissiles - the table of enemy missiles
+ * grid - the blast grid
+ * score - the player's score
+ * enemyMissilesDestroyed - the number of enemy missiles intercepted in the round
+ */
+void checkInterceptions(struct ArchetypeTable* playerMissiles, struct ArchetypeTable* enemyMissiles, struct BlastGrid* grid,
+                        int* score, int* enemyMissilesDestroyed)
+{
+  int blastCount = 0;
+
+  queueExplodingMissiles(grid, &blastCount, playerMissiles);
+  queueExplodingMissiles(grid, &blastCount, enemyMissiles);
+
+  if(!blastCount)
+  {
+    return;
+  }
+
+  fillBlastGrid(grid, enemyMissiles);
+
+  for(int next = 0; next < blastCount; next++)
+  {
+    struct Blast blast = grid->blasts[next];
+    int firstBucket = getBlastGridBucket(blast.centre.x - BLAST_WIDTH / 2, blast.centre.y - BLAST_HEIGHT / 2);
+    int lastBucket = getBlastGridBucket(blast.centre.x + BLAST_WIDTH / 2, blast.centre.y + BLAST_HEIGHT / 2);
+
+    // Looks at the missiles in the buckets that the blast overlaps.
+    for(int bucketRow = firstBucket / BLAST_GRID_COLUMNS; bucketRow <= lastBucket / BLAST_GRID_COLUMNS; bucketRow++)
+    {
+      for(int bucketCol = firstBucket % BLAST_GRID_COLUMNS; bucketCol <= lastBucket % BLAST_GRID_COLUMNS; bucketCol++)
       {
-         attron(COLOR_PAIR(missiles[i].colour));
-         mvprintw(missiles[i].currPos.y, missiles[i].currPos.x, "*");
+        int bucket = bucketRow * BLAST_GRID_COLUMNS + bucketCol;
+
+        for(int i = grid->bucketStarts[bucket]; i < grid->bucketStarts[bucket + 1]; i++)
+        {
+          int row = grid->warheads[i];
+
+          // Missiles that have already been set off are left in the grid, but are no longer warheads.
+          if(!isWarhead(enemyMissiles, row) || !isInBlast(&blast, enemyMissiles->currX[row], enemyMissiles->currY[row]))
+          {
+            continue;
+          }
+
+          // Resetting the destination prevents the missile path from continuing once intercepted.
+          enemyMissiles->destX[row] = enemyMissiles->currX[row];
+          enemyMissiles->destY[row] = enemyMissiles->currY[row];
+          enemyMissiles->stepsLeft[row] = 0;
+
+          removeTrail(enemyMissiles, row);
+          enemyMissiles->explosionFrame[row] = 1;
+
+          grid->blasts[blastCount++] = (struct Blast){{enemyMissiles->currX[row], enemyMissiles->currY[row]}, &warheadBlast};
+
+          *score += 25;
+          *enemyMissilesDestroyed += 1;
+          nextSnapshot->events.interceptions++;
+        }
       }
     }
   }
+}
 
-  if(updateTimer)
+/**
+ * checkFragment
+ * Description:
+ * Retrieves the rows of the enemyMissiles that are able to fragment.
+ * A fragment is a second missile that forms at the current position of the base missile.
+ * Params:
+ * fragmentIndexes - an array that is populated with 1 in all indexes where the same row in enemyMissiles can fragment
+ * enemyMissiles - the table of enemy missiles
+ */
+void checkFragment(int fragmentIndexes[], struct ArchetypeTable* enemyMissiles)
+{
+  for(int row = 0; row < enemyMissiles->count; row++)
   {
-    *timer = clock();
+    if((enemyMissiles->currY[row] == VIEWPORT_HEIGHT / 2)
+    && (enemyMissiles->prevY[row] == (enemyMissiles->currY[row] - 1))
+    && (enemyMissiles->canFragment[row]))
+    {
+      fragmentIndexes[row] = 1;
+    }
   }
 }
 
 /**
- * updateEnemyMissiles
- * Description:
- * Updates the state of enemy missiles.
- * Coordinates explosions and signals whether missile movement is required.
- * Also moves enemy missiles towards their destination.
+ * getMillisElapsed
+ * Description: Gets the elapsed time in milliseconds since the provided value was recorded.
+ * Params:
+ * lastTimeRecorded - the reference point in time that the elapsed time is calculated from
+ * Returns: the elapsed time in milliseconds since the provided value was recorded
+ */
+unsigned int getMillisElapsed(clock_t* lastTimeRecorded)
+{
+  return (unsigned int)(((double)(clock() - *lastTimeRecorded)) / CLOCKS_PER_SEC * 1000);
+}
+
+/**
+ * getMillisUntilDue
+ * Description: Gets the time left until a timer is due. A timer is due once more than its interval has elapsed since it was last recorded.
+ * Params:
+ * lastTimeRecorded - when the timer was last recorded, or 0 if it is due at once
+ * interval - the milliseconds between the timer's updates
+ * Returns: the milliseconds until the timer is due, or 0 if it is due now
+ */
+unsigned int getMillisUntilDue(clock_t* lastTimeRecorded, unsigned int interval)
+{
+  if(!*lastTimeRecorded)
+  {
+    return 0;
+  }
+
+  unsigned int elapsed = getMillisElapsed(lastTimeRecorded);
+
+  return (elapsed > interval) ? 0 : interval - elapsed + 1;
+}
+
+/**
+ * getPlayerMissileInterval
+ * Description: Gets the time between movement updates for player missiles.
+ * Params:
+ * gameState - the state of the game
+ * Returns: the milliseconds between movement updates
+ */
+unsigned short getPlayerMissileInterval(enum gameStates gameState)
+{
+  return (gameState == roundEnding) ? 12 : 14;
+}
+
+/**
+ * getEnemyMissileInterval
+ * Description: Gets the time between movement updates for enemy missiles. Missile speed increases by 20% for each round survived.
  * Params:
- * missiles - the collection of enemy missiles to update
  * gameState - the state of the game
- * timer - coordinates whether missile movement is to be performed on the current tick
  * roundNumber - the current round number that modifies enemy missile speed
+ * Returns: the milliseconds between movement updates
  */
-void updateEnemyMissiles(struct Missile missiles[], enum gameStates* gameState, clock_t* timer, int roundNumber)
+unsigned short getEnemyMissileInterval(enum gameStates gameState, int roundNumber)
 {
-  /*
-   * Determines the rate of enemy missile movement updates.
-   * Missile speed increases by 20% for each round survived.
-   */
-  unsigned short millisBetweenMovementUpdate = (*gameState == roundEnding) ? 12 : (unsigned short)(250 * pow(.8d, roundNumber - 1));
+  unsigned short millisBetweenMovementUpdate = (gameState == roundEnding) ? 12 : (unsigned short)(250 * pow(.8d, roundNumber - 1));
 
   if(millisBetweenMovementUpdate < 12)
   {
     millisBetweenMovementUpdate = 12;
   }
 
-  // Determines whether a movement update should be performed on the current tick.
-  int updateTimer = !(*timer) || getMillisElapsed(timer) > millisBetweenMovementUpdate;
+  return millisBetweenMovementUpdate;
+}
+
+/**
+ * explodeMissiles
+ * Description:
+ * Coordinates the explosions of a table of missiles.
+ * Starts the explosion of each missile that has reached its destination, removing its trail, and removes missiles whose explosion has finished.
+ * Params:
+ * missiles - the table of missiles to update
+ */
+void explodeMissiles(struct ArchetypeTable* missiles)
+{
+  int row = 0;
 
-  for(int i = 0; i < ENEMY_MISSILE_BUFFER; i++)
+  while(row < missiles->count)
   {
-    if(updateAbstractMissile(i, missiles, gameState) && updateTimer)
+    /*
+     * Initiates explosions for missiles that have reached their destination
+     * and removes their missile trail.
+     */
+    if(hasMissileReachedDestination(missiles, row) && !missiles->explosionFrame[row])
     {
-      struct Vector flightPath = {missiles[i].destPos.x - missiles[i].startPos.x, missiles[i].destPos.y - missiles[i].startPos.y};
+      removeTrail(missiles, row);
+      missiles->explosionFrame[row] = 1;
+    }
 
-      // Reprints the previous position in the trail, changing its colour to red.
-      missiles[i].prevPos.y = missiles[i].currPos.y;
-      missiles[i].prevPos.x = missiles[i].currPos.x;
+    // Attempts to progress the explosion if it has been initiated.
+    if(missiles->explosionFrame[row] && !getMillisUntilDue(&missiles->explosionTimer[row], EXPLOSION_FRAME_MILLIS))
+    {
+      missiles->explosionTimer[row] = clock();
+      countTimerFired();
 
-      attron(COLOR_PAIR(missiles[i].colour));
-      mvprintw(missiles[i].prevPos.y, missiles[i].prevPos.x, "*");
+      drawExplosion(missiles, row);
 
-      // Moves missile vertically.
-      if(missiles[i].currPos.x == missiles[i].destPos.x)
+      // Removes the missile once the explosion has finished. The last missile takes its row, so the row is looked at again.
+      if(missiles->explosionFrame[row] == 7)
       {
-        missiles[i].currPos.y++;
+        removeEntity(missiles, row);
+        continue;
       }
-      // Moves the missile on trajectories with a greater horizontal component than vertical.
-      else if(abs(flightPath.x) >= flightPath.y)
-      {
-        double theta = atan2(flightPath.y, abs(flightPath.x));
 
-        missiles[i].currPos.y = missiles[i].startPos.y + round(tan(theta) * (abs(missiles[i].currPos.x - missiles[i].startPos.x) + 1));
+      // Progresses the explosion animation.
+      missiles->explosionFrame[row]++;
+    }
 
-        if(flightPath.x > 0)
-        {
-          missiles[i].currPos.x++;
-        }
-        else
-        {
-          missiles[i].currPos.x--;
-        }
-      }
-      // Moves the missile on trajectories with a greater vertical component than horizontal.
-      else
-      {
-        double theta = atan2(abs(flightPath.x), flightPath.y);
+    row++;
+  }
+}
 
-        missiles[i].currPos.y++;
+/**
+ * moveMissiles
+ * Description:
+ * Moves each missile in a table that has not reached its destination a single cell along its path, adding the cell to its trail.
+ * The missiles are stepped together by missileStepKernel, and the cells they entered are drawn afterwards.
+ * Missiles whose head is drawn in a different colour to their trail repaint their previous cell in the colour of the trail.
+ * Params:
+ * missiles - the table of missiles to move
+ */
+void moveMissiles(struct ArchetypeTable* missiles)
+{
+  struct MissileSteppers steppers = {missiles->fixedX, missiles->fixedY, missiles->stepX, missiles->stepY, missiles->stepsLeft, missiles->count};
+  int moved = missileStepKernel(&steppers, &missiles->moves);
 
-        if(flightPath.x > 0)
-        {
-          missiles[i].currPos.x = missiles[i].startPos.x + round(tan(theta) * abs(missiles[i].startPos.y - missiles[i].currPos.y));
-        }
-        else
-        {
-          missiles[i].currPos.x = missiles[i].startPos.x - round(tan(theta) * abs(missiles[i].startPos.y - missiles[i].currPos.y));
-        }
-      }
+  for(int i = 0; i < moved; i++)
+  {
+    int row = missiles->moves.rows[i];
 
-      missiles[i].trailCoords[missiles[i].currPos.x][missiles[i].currPos.y] = 1;
+    missiles->prevX[row] = missiles->currX[row];
+    missiles->prevY[row] = missiles->currY[row];
 
-      /*
-       * Draws the head of the missile.
-       *
-       * Prevents the missile path destroying enemy missiles.
-       * The path cannot draw over white asterisks (the head of enemy missiles).
-       */
-      // Stores the character in the missile's updated location.
-      int charRead = mvinch(missiles[i].currPos.y, missiles[i].currPos.x);
-      if(!(((charRead & A_CHARTEXT) == '*') && ((A_COLOR & charRead) >> 24 == WHITE)))
-      {
-        attron(COLOR_PAIR(WHITE));
-        mvprintw(missiles[i].currPos.y, missiles[i].currPos.x, "*");
-      }
+    // Reprints the previous position in the trail, changing its colour to that of the trail.
+    if(missiles->headColour != missiles->colour[row])
+    {
+      putCanvasCell(missiles->prevY[row], missiles->prevX[row], '*' | COLOR_PAIR(missiles->colour[row]));
     }
+
+    missiles->currX[row] = missiles->moves.x[i];
+    missiles->currY[row] = missiles->moves.y[i];
+
+    addTrailCell(missiles, row, missiles->currX[row], missiles->currY[row]);
+
+    /*
+     * Draws the head of the missile.
+     *
+     * Prevents the missile path destroying enemy missiles.
+     * The path cannot draw over white asterisks (the head of enemy missiles).
+     */
+    putCanvasHead(missiles->currY[row], missiles->currX[row], '*' | COLOR_PAIR(missiles->headColour));
+  }
+}
+
+/**
+ * updatePlayerMissiles
+ * Description:
+ * Updates the state of player missiles.
+ * Coordinates explosions, and moves player missiles towards their destination when their timer is due.
+ * Params:
+ * missiles - the table of player missiles to update
+ * gameState - the state of the game
+ * timer - coordinates timing for missile movement
+ */
+void updatePlayerMissiles(struct ArchetypeTable* missiles, enum gameStates* gameState, clock_t* timer)
+{
+  // Determines whether a movement update should be performed on the current tick.
+  int updateTimer = !getMillisUntilDue(timer, getPlayerMissileInterval(*gameState));
+
+  explodeMissiles(missiles);
+
+  if(updateTimer)
+  {
+    moveMissiles(missiles);
+
+    *timer = clock();
+    countTimerFired();
   }
+}
+
+/**
+ * updateEnemyMissiles
+ * Description:
+ * Updates the state of enemy missiles.
+ * Coordinates explosions, and moves enemy missiles towards their destination when their timer is due.
+ * Params:
+ * missiles - the table of enemy missiles to update
+ * gameState - the state of the game
+ * timer - coordinates whether missile movement is to be performed on the current tick
+ * roundNumber - the current round number that modifies enemy missile speed
+ */
+void updateEnemyMissiles(struct ArchetypeTable* missiles, enum gameStates* gameState, clock_t* timer, int roundNumber)
+{
+  // Determines whether a movement update should be performed on the current tick.
+  int updateTimer = !getMillisUntilDue(timer, getEnemyMissileInterval(*gameState, roundNumber));
+
+  explodeMissiles(missiles);
 
   if(updateTimer)
   {
+    moveMissiles(missiles);
+
     *timer = clock();
+    countTimerFired();
   }
 }
 
@@ -1096,12 +2940,20 @@ void updateEnemyMissiles(struct Missile missiles[], enum gameStates* gameState,
  * createPlayerMissile
  * Description: Spawns a new player missile, targeting the location that was left-clicked on the viewport.
  * Params:
+ * playerMissiles - the table of player missiles
  * target - the X, Y location of the missile's destination in viewport coordinates
- * bases - the collection of missile bases
- * Returns: a new player missile
+ * bases - the table of missile bases
+ * clickTicks - when PDCurses received the click, from PDC_get_ticks()
+ * Returns: the row of the new player missile, or -1 if there is no room for it or no base can fire it
  */
-struct Missile createPlayerMissile(struct Vector target, struct Base bases[])
+int createPlayerMissile(struct ArchetypeTable* playerMissiles, struct Vector target, struct ArchetypeTable* bases, unsigned long clickTicks)
 {
+  if(playerMissiles->count == playerMissiles->capacity)
+  {
+    return -1;
+  }
+
+
   /*
    * Holds the most appropriate order of base priority, based on their
    * proximity from the missile's target.
@@ -1161,64 +3013,76 @@ struct Missile createPlayerMissile(struct Vector target, struct Base bases[])
   }
 
   // Selects an active base to fire the missile.
-  int baseIndex = -1;
+  int baseRow = -1;
   for(int i = 0; i < NUMBER_OF_BASES; i++)
   {
-    if(isBaseActive(&bases[baseOrder[i]]))
+    if(isBaseActive(bases, baseOrder[i]))
     {
-      bases[baseOrder[i]].ammoCount--;
-      drawBaseMissileCount(&bases[baseOrder[i]]);
+      bases->ammoCount[baseOrder[i]]--;
+      drawBaseMissileCount(bases, baseOrder[i]);
 
-      baseIndex = baseOrder[i];
+      baseRow = baseOrder[i];
 
       break;
     }
   }
 
-  struct Missile m;
-  initMissile(&m);
-
-  // True if a base has been selected.
-  if(baseIndex != -1)
+  if(baseRow == -1)
   {
-    m.isActive = 1;
-    m.colour = BLUE;
+    return -1;
+  }
+
+  int row = addEntity(playerMissiles);
+
+  playerMissiles->colour[row] = BLUE;
+
+  playerMissiles->startX[row] = bases->sourceX[baseRow];
+  playerMissiles->startY[row] = bases->sourceY[baseRow];
+
+  playerMissiles->currX[row] = playerMissiles->startX[row];
+  playerMissiles->currY[row] = playerMissiles->startY[row];
 
-    m.startPos.x = bases[baseIndex].playerMissileSource.x;
-    m.startPos.y = bases[baseIndex].playerMissileSource.y;
+  playerMissiles->destX[row] = target.x;
+  playerMissiles->destY[row] = target.y;
 
-    m.currPos.x = m.startPos.x;
-    m.currPos.y = m.startPos.y;
+  aimMissile(playerMissiles, row);
 
-    m.destPos.x = target.x;
-    m.destPos.y = target.y;
+  addTrailCell(playerMissiles, row, playerMissiles->startX[row], playerMissiles->startY[row]);
 
-    m.trailCoords[m.startPos.x][m.startPos.y] = 1;
+  // Draws the start position.
+  putCanvasCell(playerMissiles->startY[row], playerMissiles->startX[row], '*' | COLOR_PAIR(playerMissiles->colour[row]));
 
-    // Draws the start position.
-    attron(COLOR_PAIR(m.colour));
-    mvprintw(m.startPos.y, m.startPos.x, "*");
+  /*
+   * Measures the delay from the click to the launch.
+   * The render thread watches for the start position reaching the screen once it takes the snapshot.
+   */
+  recordLatency(&clickToLaunch, PDC_get_ticks() - clickTicks);
 
-    // Draws the missile target.
-    attron(COLOR_PAIR(WHITE));
-    mvprintw(m.destPos.y, m.destPos.x, "X");
+  if(nextSnapshot->launchCount < PLAYER_MISSILE_BUFFER)
+  {
+    nextSnapshot->launches[nextSnapshot->launchCount].startPos = (struct Vector){playerMissiles->startX[row], playerMissiles->startY[row]};
+    nextSnapshot->launches[nextSnapshot->launchCount].clickTicks = clickTicks;
+    nextSnapshot->launchCount++;
   }
 
-  return m;
+  // Draws the missile target.
+  putCanvasCell(target.y, target.x, 'X' | COLOR_PAIR(WHITE));
+
+  return row;
 }
 
 /**
  * createEnemyMissile
  * Description: Spawns a new enemy missile, which attempts to target an active missile base or city that is alive.
  * Params:
- * enemyMissiles - the collection of enemy missiles
- * fragmentIndex - the index of the active missile in the enemy missile buffer to fragment from
- * bases - collection of missile bases
- * cities - the collection of cities
+ * enemyMissiles - the table of enemy missiles
+ * fragmentRow - the row of the missile in enemyMissiles to fragment from, or -1 to spawn from the top of the viewport
+ * bases - the table of missile bases
+ * cities - the table of cities
  * xPosOfTargetToAvoid - the missile target point of an asset that should not be considered a target for the missile.
- * Returns: a new enemy missile
+ * Returns: the row of the new enemy missile, or -1 if there is no room for it
  */
-struct Missile createEnemyMissile(struct Missile enemyMissiles[], int fragmentIndex, struct Base bases[], struct City cities[], short xPosOfTargetToAvoid)
+int createEnemyMissile(struct ArchetypeTable* enemyMissiles, int fragmentRow, struct ArchetypeTable* bases, struct ArchetypeTable* cities, short xPosOfTargetToAvoid)
 {
   /*
    * Stores whether the target at the given index in targets[] is valid.
@@ -1239,14 +3103,14 @@ struct Missile createEnemyMissile(struct Missile enemyMissiles[], int fragmentIn
   // Adds base targets.
   for(int i = 0; i < NUMBER_OF_BASES; i++)
   {
-    targets[i] = bases[i].enemyMissileTarget;
+    targets[i] = (struct Vector){bases->targetX[i], bases->targetY[i]};
 
     // If true, prevents the base from becoming the missile's target.
-    if(bases[i].enemyMissileTarget.x == xPosOfTargetToAvoid)
+    if(bases->targetX[i] == xPosOfTargetToAvoid)
     {
       targetToAvoid = i;
     }
-    else if(isBaseActive(&bases[i]))
+    else if(isBaseActive(bases, i))
     {
       totalTargets++;
       targetValidity[i] = 1;
@@ -1256,14 +3120,14 @@ struct Missile createEnemyMissile(struct Missile enemyMissiles[], int fragmentIn
   // Add city targets.
   for(int i = 0; i < NUMBER_OF_CITIES; i++)
   {
-    targets[i + NUMBER_OF_BASES] = cities[i].enemyMissileTarget;
+    targets[i + NUMBER_OF_BASES] = (struct Vector){cities->targetX[i], cities->targetY[i]};
 
     // If true, prevents the city from becoming the missile's target.
-    if(cities[i].enemyMissileTarget.x == xPosOfTargetToAvoid)
+    if(cities->targetX[i] == xPosOfTargetToAvoid)
     {
       targetToAvoid = i + NUMBER_OF_BASES;
     }
-    else if(cities[i].isAlive)
+    else if(cities->isAlive[i])
     {
       totalTargets++;
       targetValidity[i + NUMBER_OF_BASES] = 1;
@@ -1302,21 +3166,25 @@ struct Missile createEnemyMissile(struct Missile enemyMissiles[], int fragmentIn
     }
   }
 
-  struct Missile m;
-  initMissile(&m);
+  int row = addEntity(enemyMissiles);
+
+  if(row == -1)
+  {
+    return -1;
+  }
 
   /*
    * Initialising an enemy missile that is not from a fragment.
    * I.e., it spawns from the top of the viewport.
    */
-  if(fragmentIndex == -1)
+  if(fragmentRow == -1)
   {
-    m.canFragment = 1;
+    enemyMissiles->canFragment[row] = 1;
 
     // Prevents enemyMissiles from colliding with the score and being destroyed prematurely.
     short scoreOffset = 4;
-    m.startPos.x = rand() % (VIEWPORT_WIDTH - 2 - scoreOffset) + 1 + scoreOffset;
-    m.startPos.y = 1;
+    enemyMissiles->startX[row] = rand() % (VIEWPORT_WIDTH - 2 - scoreOffset) + 1 + scoreOffset;
+    enemyMissiles->startY[row] = 1;
   }
   /*
    * Initialising an enemy missile that is a fragment.
@@ -1324,77 +3192,588 @@ struct Missile createEnemyMissile(struct Missile enemyMissiles[], int fragmentIn
    */
   else
   {
-    m.startPos.x = enemyMissiles[fragmentIndex].currPos.x;
-    m.startPos.y = enemyMissiles[fragmentIndex].currPos.y;
+    enemyMissiles->startX[row] = enemyMissiles->currX[fragmentRow];
+    enemyMissiles->startY[row] = enemyMissiles->currY[fragmentRow];
+  }
+
+  enemyMissiles->colour[row] = RED;
+
+  enemyMissiles->currX[row] = enemyMissiles->startX[row];
+  enemyMissiles->currY[row] = enemyMissiles->startY[row];
+
+  // Samples a random target from the possible targets.
+  int randomTarget = rand() % totalTargets;
+
+  enemyMissiles->destX[row] = validTargets[randomTarget].x;
+  enemyMissiles->destY[row] = validTargets[randomTarget].y;
+
+  aimMissile(enemyMissiles, row);
+
+  addTrailCell(enemyMissiles, row, enemyMissiles->startX[row], enemyMissiles->startY[row]);
+
+  // Draws the head of the missile.
+  putCanvasCell(enemyMissiles->startY[row], enemyMissiles->startX[row], '*' | COLOR_PAIR(enemyMissiles->headColour));
+
+  return row;
+}
+
+/**
+ * getMillisUntilNextTick
+ * Description: Gets the time until the simulation next has something to do, so that it can sleep until then.
+ * Params:
+ * gameState - the state of the game
+ * playerMissiles - the table of player missiles
+ * enemyMissiles - the table of enemy missiles
+ * enemiesLastSpawnTime - coordinates timing for enemy missile spawning
+ * enemiesLastUpdateTime - coordinates timing for enemy missile movement
+ * playersLastUpdateTime - coordinates timing for player missile movement
+ * enemyMissilesFired - the number of enemy missiles spawned in the round
+ * roundNumber - the current round number
+ * roundSummaryStarted - when the results of the last round were first shown
+ * Returns: the milliseconds until the next timer is due, 0 if one is due now, or INFINITE if none will be
+ */
+DWORD getMillisUntilNextTick(enum gameStates gameState, struct ArchetypeTable* playerMissiles, struct ArchetypeTable* enemyMissiles,
+                             clock_t* enemiesLastSpawnTime, clock_t* enemiesLastUpdateTime, clock_t* playersLastUpdateTime,
+                             int enemyMissilesFired, int roundNumber, clock_t* roundSummaryStarted)
+{
+  if(gameState == gameOver)
+  {
+    return INFINITE;
+  }
+
+  if(gameState == showingRoundSummary)
+  {
+    return getMillisUntilDue(roundSummaryStarted, ROUND_SUMMARY_MILLIS);
+  }
+
+  unsigned int millis = getMillisUntilDue(playersLastUpdateTime, getPlayerMissileInterval(gameState));
+  unsigned int enemyMillis = getMillisUntilDue(enemiesLastUpdateTime, getEnemyMissileInterval(gameState, roundNumber));
+
+  if(enemyMillis < millis)
+  {
+    millis = enemyMillis;
+  }
+
+  if(enemyMissilesFired < ENEMY_MISSILES_PER_ROUND)
+  {
+    unsigned int spawnMillis = getMillisUntilDue(enemiesLastSpawnTime, ENEMY_SPAWN_MILLIS);
+
+    if(spawnMillis < millis)
+    {
+      millis = spawnMillis;
+    }
+  }
+
+  // Explosions are animated on timers of their own.
+  struct ArchetypeTable* missileTables[2] = {playerMissiles, enemyMissiles};
+
+  for(int i = 0; i < 2; i++)
+  {
+    struct ArchetypeTable* missiles = missileTables[i];
+
+    for(int row = 0; row < missiles->count; row++)
+    {
+      if(missiles->explosionFrame[row])
+      {
+        unsigned int explosionMillis = getMillisUntilDue(&missiles->explosionTimer[row], EXPLOSION_FRAME_MILLIS);
+
+        if(explosionMillis < millis)
+        {
+          millis = explosionMillis;
+        }
+      }
+    }
+  }
+
+  return millis;
+}
+
+/**
+ * waitForTick
+ * Description: Sleeps until the next tick is due, a click arrives, or the simulation is asked to stop. Simulation thread.
+ * Params:
+ * millis - the milliseconds until the next tick is due, or INFINITE to wait only for clicks and stopping
+ */
+void waitForTick(DWORD millis)
+{
+  HANDLE wakers[3] = {simulationStop, clicksReady, tickTimer};
+
+  if(!millis)
+  {
+    return;
+  }
+
+  if(millis == INFINITE)
+  {
+    WaitForMultipleObjects(2, wakers, FALSE, INFINITE);
+    return;
+  }
+
+  // A negative due time is relative to now, in units of 100 nanoseconds.
+  LARGE_INTEGER dueTime;
+  dueTime.QuadPart = -(LONGLONG)millis * 10000;
+
+  SetWaitableTimer(tickTimer, &dueTime, 0, NULL, NULL, FALSE);
+  WaitForMultipleObjects(3, wakers, FALSE, INFINITE);
+}
+
+/**
+ * addFrameTask
+ * Description: Adds a task to a task graph.
+ * Params:
+ * graph - the graph to add the task to
+ * run - the function that does the task's work
+ * context - passed to run
+ * Returns: the index of the task in the graph
+ */
+int addFrameTask(struct TaskGraph* graph, void (*run)(void* context), void* context)
+{
+  struct FrameTask* task = &graph->tasks[graph->taskCount];
+
+  task->run = run;
+  task->context = context;
+  task->dependentCount = 0;
+  task->dependencyCount = 0;
+
+  return graph->taskCount++;
+}
+
+/**
+ * addTaskDependency
+ * Description: Makes a task of a graph wait for another to finish before it runs.
+ * Params:
+ * graph - the graph that holds both tasks
+ * before - the index of the task that must finish first
+ * after - the index of the task that waits for it
+ */
+void addTaskDependency(struct TaskGraph* graph, int before, int after)
+{
+  graph->tasks[before].dependents[graph->tasks[before].dependentCount++] = after;
+  graph->tasks[after].dependencyCount++;
+}
+
+/**
+ * pushTask
+ * Description: Adds a task that is ready to run to the bottom of a worker's deque, and wakes a worker to run it.
+ * Params:
+ * worker - the worker whose deque the task is pushed to
+ * task - the index of the task in the running graph
+ */
+void pushTask(int worker, int task)
+{
+  struct TaskDeque* deque = &taskDeques[worker];
+
+  EnterCriticalSection(&deque->lock);
+  deque->tasks[deque->bottom % TASK_GRAPH_SIZE] = task;
+  deque->bottom++;
+  LeaveCriticalSection(&deque->lock);
+
+  ReleaseSemaphore(taskPoolWork, 1, NULL);
+}
+
+/**
+ * takeTask
+ * Description: Takes the task that a worker pushed last. If its deque is empty, steals the oldest task from another worker.
+ * Params:
+ * worker - the worker looking for a task
+ * Returns: the index of the task in the running graph, or -1 if no task is waiting
+ */
+int takeTask(int worker)
+{
+  for(int i = 0; i < taskWorkers; i++)
+  {
+    struct TaskDeque* deque = &taskDeques[(worker + i) % taskWorkers];
+    int task = -1;
+
+    EnterCriticalSection(&deque->lock);
+    if(deque->bottom > deque->top)
+    {
+      // Workers take from the bottom of their own deques, and steal from the top of the others'.
+      task = i ? deque->tasks[deque->top++ % TASK_GRAPH_SIZE] : deque->tasks[--deque->bottom % TASK_GRAPH_SIZE];
+    }
+    LeaveCriticalSection(&deque->lock);
+
+    if(task != -1)
+    {
+      return task;
+    }
+  }
+
+  return -1;
+}
+
+/**
+ * runTask
+ * Description: Runs a task of the running graph, then pushes the tasks that were only waiting for it.
+ * Params:
+ * worker - the worker running the task
+ * index - the index of the task in the running graph
+ */
+void runTask(int worker, int index)
+{
+  struct TaskGraph* graph = runningGraph;
+  struct FrameTask* task = &graph->tasks[index];
+
+  task->run(task->context);
+
+  for(int i = 0; i < task->dependentCount; i++)
+  {
+    if(!InterlockedDecrement(&graph->tasks[task->dependents[i]].dependenciesLeft))
+    {
+      pushTask(worker, task->dependents[i]);
+    }
+  }
+
+  if(!InterlockedDecrement(&graph->tasksLeft))
+  {
+    SetEvent(graph->finished);
+  }
+}
+
+/**
+ * runTaskWorker
+ * Description: Runs tasks on a thread of the task pool, sleeping while there are none, until the pool is stopped.
+ * Params:
+ * workerIndex - the worker's index, and so its deque
+ * Returns: 0 once taskPoolStop has been signalled
+ */
+DWORD WINAPI runTaskWorker(LPVOID workerIndex)
+{
+  int worker = (int)(INT_PTR)workerIndex;
+  HANDLE wakers[2] = {taskPoolStop, taskPoolWork};
+
+  while(WaitForMultipleObjects(2, wakers, FALSE, INFINITE) != WAIT_OBJECT_0)
+  {
+    int task;
+
+    while((task = takeTask(worker)) != -1)
+    {
+      runTask(worker, task);
+    }
+  }
+
+  return 0;
+}
+
+/**
+ * startTaskPool
+ * Description: Starts a worker thread for each processor after the first, the first time it is called. Simulation thread.
+ * Returns: 1 if the pool has threads to run tasks in parallel, or 0 if the machine has a single processor
+ */
+int startTaskPool()
+{
+  if(!taskWorkers)
+  {
+    SYSTEM_INFO system;
+
+    GetSystemInfo(&system);
+    taskWorkers = (system.dwNumberOfProcessors < TASK_POOL_MAX_WORKERS) ? system.dwNumberOfProcessors : TASK_POOL_MAX_WORKERS;
+
+    if(taskWorkers < 1)
+    {
+      taskWorkers = 1;
+    }
+
+    for(int i = 0; i < taskWorkers; i++)
+    {
+      InitializeCriticalSection(&taskDeques[i].lock);
+    }
+
+    taskPoolWork = CreateSemaphore(NULL, 0, LONG_MAX, NULL);
+    taskPoolStop = CreateEvent(NULL, TRUE, FALSE, NULL);
+
+    for(int i = 1; i < taskWorkers; i++)
+    {
+      taskWorkerThreads[i] = CreateThread(NULL, 0, runTaskWorker, (LPVOID)(INT_PTR)i, 0, NULL);
+    }
+  }
+
+  return taskWorkers > 1;
+}
+
+/**
+ * stopTaskPool
+ * Description: Stops the task pool's threads, if it was started, and waits for them to finish. Simulation thread.
+ */
+void stopTaskPool()
+{
+  if(taskWorkers < 2)
+  {
+    return;
+  }
+
+  SetEvent(taskPoolStop);
+
+  for(int i = 1; i < taskWorkers; i++)
+  {
+    WaitForSingleObject(taskWorkerThreads[i], INFINITE);
+  }
+}
+
+/**
+ * runTaskGraph
+ * Description: Runs every task of a graph on the task pool, each once its dependencies have finished. The simulation thread runs tasks too, and returns once all have finished.
+ * Params:
+ * graph - the graph to run
+ */
+void runTaskGraph(struct TaskGraph* graph)
+{
+  runningGraph = graph;
+  graph->tasksLeft = graph->taskCount;
+
+  for(int i = 0; i < graph->taskCount; i++)
+  {
+    graph->tasks[i].dependenciesLeft = graph->tasks[i].dependencyCount;
+  }
+
+  for(int i = 0; i < graph->taskCount; i++)
+  {
+    if(!graph->tasks[i].dependencyCount)
+    {
+      pushTask(0, i);
+    }
+  }
+
+  // Reads the count with an interlocked operation, so that the work of the tasks that finished is seen along with it.
+  while(InterlockedCompareExchange(&graph->tasksLeft, 0, 0))
+  {
+    int task = takeTask(0);
+
+    if(task != -1)
+    {
+      runTask(0, task);
+    }
+    // The tasks left are running on other workers, which will push any that follow them.
+    else
+    {
+      WaitForSingleObject(graph->finished, INFINITE);
+    }
+  }
+}
+
+/**
+ * stepPlayerMissilesTask
+ * Description: Moves the player missiles, recording their canvas edits for mergeCanvasEditsTask.
+ * Params:
+ * context - the SimulationTick
+ */
+void stepPlayerMissilesTask(void* context)
+{
+  struct SimulationTick* tick = context;
+
+  canvasRecorder = &playerMissileEdits;
+  PROFILE_BEGIN(phasePlayerMissiles);
+  updatePlayerMissiles(tick->playerMissiles, tick->gameState, tick->playersLastUpdateTime);
+  PROFILE_END(phasePlayerMissiles);
+  canvasRecorder = NULL;
+}
+
+/**
+ * stepEnemyMissilesTask
+ * Description: Moves the enemy missiles, recording their canvas edits for mergeCanvasEditsTask.
+ * Params:
+ * context - the SimulationTick
+ */
+void stepEnemyMissilesTask(void* context)
+{
+  struct SimulationTick* tick = context;
+
+  canvasRecorder = &enemyMissileEdits;
+  PROFILE_BEGIN(phaseEnemyMissiles);
+  updateEnemyMissiles(tick->enemyMissiles, tick->gameState, tick->enemiesLastUpdateTime, *tick->roundNumber);
+  PROFILE_END(phaseEnemyMissiles);
+  canvasRecorder = NULL;
+}
+
+/**
+ * mergeCanvasEdits
+ * Description: Makes the canvas edits that a task recorded, and counts its events.
+ * Params:
+ * edits - the task's edits, which are emptied
+ */
+void mergeCanvasEdits(struct CanvasEdits* edits)
+{
+  for(int i = 0; i < edits->count; i++)
+  {
+    applyCanvasEdit(&edits->edits[i]);
+  }
+
+  nextSnapshot->events.timersFired += edits->timersFired;
+
+  edits->count = 0;
+  edits->timersFired = 0;
+}
+
+/**
+ * mergeCanvasEditsTask
+ * Description: Makes the canvas edits of both missile phases, player missiles first, as the phases run in otherwise.
+ * Params:
+ * context - the SimulationTick
+ */
+void mergeCanvasEditsTask(void* context)
+{
+  mergeCanvasEdits(&playerMissileEdits);
+  mergeCanvasEdits(&enemyMissileEdits);
+}
+
+/**
+ * destroyAssetsTask
+ * Description: Marks the assets that have been hit by enemy missiles as not being alive.
+ * Params:
+ * context - the SimulationTick
+ */
+void destroyAssetsTask(void* context)
+{
+  struct SimulationTick* tick = context;
+
+  PROFILE_BEGIN(phaseDestroyAssets);
+  destroyAssets(tick->enemyMissiles, tick->bases, tick->cities);
+  PROFILE_END(phaseDestroyAssets);
+}
+
+/**
+ * checkInterceptionsTask
+ * Description: Checks whether any enemy missiles have been intercepted.
+ * Params:
+ * context - the SimulationTick
+ */
+void checkInterceptionsTask(void* context)
+{
+  struct SimulationTick* tick = context;
+
+  PROFILE_BEGIN(phaseInterceptions);
+  checkInterceptions(tick->playerMissiles, tick->enemyMissiles, tick->blastGrid, tick->score, tick->enemyMissilesDestroyed);
+  PROFILE_END(phaseInterceptions);
+}
+
+/**
+ * initFrameGraph
+ * Description:
+ * Builds the graph that the missile phases of a tick run as in parallel.
+ * The player and enemy missiles move independently, as their canvas edits are recorded. Asset damage needs only the enemy missiles to have moved.
+ * Interceptions need both sets of missiles to have moved, and erase trails, so wait for the edits to be made. They come after asset damage as they do otherwise.
+ * Params:
+ * tick - the simulation state that the tasks work on
+ */
+void initFrameGraph(struct SimulationTick* tick)
+{
+  int players = addFrameTask(&frameGraph, stepPlayerMissilesTask, tick);
+  int enemies = addFrameTask(&frameGraph, stepEnemyMissilesTask, tick);
+  int merge = addFrameTask(&frameGraph, mergeCanvasEditsTask, tick);
+  int assets = addFrameTask(&frameGraph, destroyAssetsTask, tick);
+  int hits = addFrameTask(&frameGraph, checkInterceptionsTask, tick);
+
+  addTaskDependency(&frameGraph, players, merge);
+  addTaskDependency(&frameGraph, enemies, merge);
+  addTaskDependency(&frameGraph, enemies, assets);
+  addTaskDependency(&frameGraph, merge, hits);
+  addTaskDependency(&frameGraph, assets, hits);
+
+  frameGraph.finished = CreateEvent(NULL, FALSE, FALSE, NULL);
+
+  char* threshold = getenv(PARALLEL_MISSILES_VARIABLE);
+  int missiles = threshold ? atoi(threshold) : 0;
+
+  parallelMissiles = missiles > 0 ? missiles : PARALLEL_MISSILES;
+}
+
+/**
+ * countActiveMissiles
+ * Description: Counts the player and enemy missiles that are active.
+ * Params:
+ * playerMissiles - the table of player missiles
+ * enemyMissiles - the table of enemy missiles
+ * Returns: the number of active missiles
+ */
+unsigned int countActiveMissiles(struct ArchetypeTable* playerMissiles, struct ArchetypeTable* enemyMissiles)
+{
+  return playerMissiles->count + enemyMissiles->count;
+}
+
+/**
+ * runMissilePhases
+ * Description:
+ * Moves the missiles, destroys the assets they hit and checks for interceptions. Simulation thread.
+ * Runs frameGraph on the task pool once there are parallelMissiles active missiles, and on the simulation thread before then.
+ * Params:
+ * tick - the simulation state that the phases work on
+ */
+void runMissilePhases(struct SimulationTick* tick)
+{
+  // Only swarms of missiles are worth the cost of handing the missile phases to other threads.
+  if(countActiveMissiles(tick->playerMissiles, tick->enemyMissiles) >= parallelMissiles && startTaskPool())
+  {
+    runTaskGraph(&frameGraph);
+    return;
   }
 
-  m.isActive = 1;
-  m.colour = RED;
-
-  m.currPos.x = m.startPos.x;
-  m.currPos.y = m.startPos.y;
-
-  // Samples a random target from the possible targets.
-  int randomTarget = rand() % totalTargets;
+  PROFILE_BEGIN(phasePlayerMissiles);
+  updatePlayerMissiles(tick->playerMissiles, tick->gameState, tick->playersLastUpdateTime);
+  PROFILE_END(phasePlayerMissiles);
 
-  m.destPos.x = validTargets[randomTarget].x;
-  m.destPos.y = validTargets[randomTarget].y;
+  PROFILE_BEGIN(phaseEnemyMissiles);
+  updateEnemyMissiles(tick->enemyMissiles, tick->gameState, tick->enemiesLastUpdateTime, *tick->roundNumber);
+  PROFILE_END(phaseEnemyMissiles);
 
-  m.trailCoords[m.startPos.x][m.startPos.y] = 1;
-
-  // Draws the head of the missile.
-  attron(COLOR_PAIR(WHITE));
-  mvprintw(m.startPos.y, m.startPos.x, "*");
+  // Marks the assets that have hit been hit by enemy missiles as not being alive.
+  PROFILE_BEGIN(phaseDestroyAssets);
+  destroyAssets(tick->enemyMissiles, tick->bases, tick->cities);
+  PROFILE_END(phaseDestroyAssets);
 
-  return m;
+  // Checks whether any enemy missiles have been intercepted.
+  PROFILE_BEGIN(phaseInterceptions);
+  checkInterceptions(tick->playerMissiles, tick->enemyMissiles, tick->blastGrid, tick->score, tick->enemyMissilesDestroyed);
+  PROFILE_END(phaseInterceptions);
 }
 
 /**
- * main
- * Description: controls the game loop and handles updates in the game's state.
- * Returns: 0 at the end of normal program execution, else a non-zero value
+ * requestRender
+ * Description: Passes a request to the render thread, and wakes it to act on it. Input thread.
+ * Params:
+ * request - the INPUT_REQUEST bit to set
  */
-int main()
+void requestRender(LONG request)
 {
-  /*
-   * PDCURSES SETUP.
-   */
-  // Initialises curses. This must be the first curses function to be called in the program.
-  initscr();
-  // Sets the dimensions  of the viewport.
-  resize_term(VIEWPORT_HEIGHT, VIEWPORT_WIDTH);
-  // Sets the input mode for the current terminal to cbreak mode.
-  cbreak();
-  // Removes the cursor from the viewport.
-  curs_set(0);
-  // Enables input polling without halting the program.
-  nodelay(stdscr, TRUE);
-  // Prevents characters from keyboard input being printed to the terminal.
-  noecho();
-  // Enables keyboard/mouse input.
-  keypad(stdscr, TRUE);
-  // Enables mouse clicking interrupts.
-  mousemask(BUTTON1_CLICKED | REPORT_MOUSE_POSITION, NULL);
-
-  /*
-   * Redefines colour pair combinations.
-   * Takes the format: key, fg colour, bg colour.
-   */
-  start_color();
-  init_pair(RED, COLOR_RED, COLOR_BLACK);
-  init_pair(YELLOW, COLOR_YELLOW, COLOR_BLACK);
-  init_pair(BLUE, COLOR_BLUE, COLOR_BLACK);
-  init_pair(CYAN, COLOR_CYAN, COLOR_BLACK);
-  init_pair(WHITE, COLOR_WHITE, COLOR_BLACK);
+  InterlockedOr(&inputRequests, request);
+  SetEvent(renderWake);
+}
 
-  struct Base bases[NUMBER_OF_BASES];
-  struct City cities[NUMBER_OF_CITIES];
+/**
+ * runSimulation
+ * Description:
+ * Runs the game's simulation on its own thread: launches missiles for queued clicks, spawns and moves missiles, and checks for hits and the end of rounds.
+ * Draws into the canvas, and publishes a snapshot of it after each tick that changed it. Sleeps between ticks until the next timer is due.
+ * Params:
+ * unused - required by CreateThread()
+ * Returns: 0 once the game has ended or simulationStop has been signalled
+ */
+DWORD WINAPI runSimulation(LPVOID unused)
+{
+  struct ArchetypeTable bases;
+  struct ArchetypeTable cities;
   // Player missile buffer.
-  struct Missile playerMissiles[PLAYER_MISSILE_BUFFER];
+  struct ArchetypeTable playerMissiles;
   // Enemy missile buffer.
-  struct Missile enemyMissiles[ENEMY_MISSILE_BUFFER];
+  struct ArchetypeTable enemyMissiles;
   int score = 0;
 
+  int tablesCreated = initArchetypeTable(&bases, BASE_ARCHETYPE, NUMBER_OF_BASES, 0);
+  tablesCreated &= initArchetypeTable(&cities, CITY_ARCHETYPE, NUMBER_OF_CITIES, 0);
+  tablesCreated &= initArchetypeTable(&playerMissiles, PLAYER_MISSILE_ARCHETYPE, PLAYER_MISSILE_BUFFER, BLUE);
+  tablesCreated &= initArchetypeTable(&enemyMissiles, ENEMY_MISSILE_ARCHETYPE, ENEMY_MISSILE_BUFFER, WHITE);
+
+  // The game cannot be played without its entities, so the render thread is asked to quit.
+  if(!tablesCreated)
+  {
+    freeArchetypeTable(&bases);
+    freeArchetypeTable(&cities);
+    freeArchetypeTable(&playerMissiles);
+    freeArchetypeTable(&enemyMissiles);
+
+    requestRender(INPUT_REQUEST_QUIT);
+    return 1;
+  }
+
   /*
    * INITIALISE ROUND VARIABLES.
    */
@@ -1411,231 +3790,507 @@ int main()
   int enemyMissilesDestroyed = 0;
   int roundNumber = 1;
   enum gameStates gameState = ongoing;
+  // When the results of the last round were first shown.
+  clock_t roundSummaryStarted = 0;
+  // Finds the enemy missiles caught in blasts.
+  struct BlastGrid blastGrid;
 
-  // Initialise missiles.
-  initMissiles(playerMissiles, PLAYER_MISSILE_BUFFER);
-  initMissiles(enemyMissiles, ENEMY_MISSILE_BUFFER);
+  // The state that the tasks of frameGraph work on, when the missile phases run in parallel.
+  struct SimulationTick tick = {&playerMissiles, &enemyMissiles, &bases, &cities, &gameState, &playersLastUpdateTime,
+    &enemiesLastUpdateTime, &roundNumber, &score, &enemyMissilesDestroyed, &blastGrid};
+  initFrameGraph(&tick);
+
+  missileStepKernel = getMissileStepKernel(NULL);
 
   // Initialise assets.
-  initBases(bases);
-  initCities(cities, bases);
+  initBases(&bases);
+  initCities(&cities, &bases);
 
   // Draws the ground, bases and cities.
-  drawLandscape(bases, cities);
+  clearCanvas();
+  drawLandscape(&bases, &cities);
   // Draws the score (initially 0).
   drawScore(score);
 
   // Generates a seed for random value generation.
   srand(time(NULL));
 
-  while(1)
+  while(WaitForSingleObject(simulationStop, 0) == WAIT_TIMEOUT)
   {
-    int inputEvent = getch();
-    MEVENT event;
+    struct Click clicks[INPUT_RING_SIZE];
+    int clickCount = takeClicks(clicks);
 
-    switch(inputEvent)
+    PROFILE_BEGIN(phaseLaunch);
+
+    for(int c = 0; c < clickCount; c++)
     {
-      case ESCAPE:
-      {
-        endwin();
-        exit(0);
-      }
-      case KEY_RESIZE:
-      {
-        resize_term(VIEWPORT_HEIGHT, VIEWPORT_WIDTH);
-        /*
-         * The amount of sleep affects whether the screen clips when it is resized.
-         * I do not know why this behaviour is happening.
-         * At the value of 300, the clipping does not seem to appear (Windows 10.0.22621) but that may not be universal.
-         */
-        Sleep(300);
-        break;
-      }
-      case KEY_MOUSE:
+      // Check if the game state allows for missile fire and there are missiles remaining.
+      if(gameState == ongoing && getPlayerMissilesRemaining(&bases) > 0)
       {
-        /*
-         * Create new player missile if a valid input has been registered.
-         * Check if the input mouse left-click.
-         */
-        if(getmouse(&event) == OK && (event.bstate & BUTTON1_CLICKED))
+        // Create a missile at the location of the click event.
+        if(createPlayerMissile(&playerMissiles, clicks[c].target, &bases, clicks[c].ticks) != -1)
         {
-          // Check if click occurs within clickable bounds.
-          if(event.x >= 4 && event.x <= VIEWPORT_WIDTH - 5 && event.y >= 3 && event.y <= VIEWPORT_HEIGHT - 10)
-          {
-            // Check if the game state allows for missile fire and there are missiles remaining.
-            if(gameState == ongoing && getPlayerMissilesRemaining(bases) > 0)
-            {
-              for(int i = 0; i < PLAYER_MISSILE_BUFFER; i++)
-              {
-                if(!playerMissiles[i].isActive)
-                {
-                  // Create a missile at the location of the click event.
-                  struct Vector destination = {event.x, event.y};
-                  playerMissiles[i] = createPlayerMissile(destination, bases);
-
-                  break;
-                }
-              }
-            }
-          }
+          nextSnapshot->events.spawns++;
         }
-        break;
       }
     }
 
-    // Creates a new enemy missile.
-    if(enemyMissilesFired < ENEMY_MISSILES_PER_ROUND)
-    {
-      // Stores the indexes of enemy missiles that can fragment.
-      int fragmentIndexes[ENEMY_MISSILE_BUFFER] = {0};
-      // The number of missiles that are eligible for fragmentation.
-      unsigned short numberOfMissilesCanFragment = 0;
-
-      // Populates the fragmentIndexes array with the indexes of missiles that can fragment.
-      checkFragment(fragmentIndexes, enemyMissiles);
+    PROFILE_END(phaseLaunch);
 
-      // Calculates the number of missiles eligible for fragmentation.
-      for(int i = 0; i < ENEMY_MISSILE_BUFFER; i++)
+    // Missiles only move while a round is being played.
+    if(gameState == ongoing || gameState == roundEnding)
+    {
+      // Creates a new enemy missile.
+      if(enemyMissilesFired < ENEMY_MISSILES_PER_ROUND)
       {
-        if(fragmentIndexes[i])
-        {
-          numberOfMissilesCanFragment++;
-        }
-      }
+        PROFILE_BEGIN(phaseFragmentSpawn);
 
-      if(numberOfMissilesCanFragment)
-      {
-        // Determines the maximum number of missiles that can be fired on this tick.
-        unsigned short maximumSpawns = ENEMY_MISSILES_PER_ROUND - enemyMissilesFired;
+        // Stores the rows of enemy missiles that can fragment.
+        int fragmentIndexes[ENEMY_MISSILE_BUFFER] = {0};
+        // The number of missiles that are eligible for fragmentation.
+        unsigned short numberOfMissilesCanFragment = 0;
 
-        // A dedicated array for storing the indexes of missiles eligible for fragmenting.
-        int missilesCanFragment[numberOfMissilesCanFragment];
+        // Populates the fragmentIndexes array with the rows of missiles that can fragment.
+        checkFragment(fragmentIndexes, &enemyMissiles);
 
-        // Transfers the indexes of missiles eligible to fragment to the dedicated array.
-        int index = 0;
+        // Calculates the number of missiles eligible for fragmentation.
         for(int i = 0; i < ENEMY_MISSILE_BUFFER; i++)
         {
           if(fragmentIndexes[i])
           {
-            missilesCanFragment[index] = i;
-            index++;
+            numberOfMissilesCanFragment++;
           }
         }
 
-        // Determines the actual number to fragment. Ensures spawns cannot exceed the buffer.
-        short fragmentMissilesToSpawn = (numberOfMissilesCanFragment > maximumSpawns) ? maximumSpawns : numberOfMissilesCanFragment;
-
-        // Spawns missiles from fragmentation.
-        for(int i = 0; i < fragmentMissilesToSpawn; i++)
+        if(numberOfMissilesCanFragment)
         {
-          for(int j = 0; j < ENEMY_MISSILE_BUFFER; j++)
+          // Determines the maximum number of missiles that can be fired on this tick.
+          unsigned short maximumSpawns = ENEMY_MISSILES_PER_ROUND - enemyMissilesFired;
+
+          // A dedicated array for storing the indexes of missiles eligible for fragmenting.
+          int missilesCanFragment[numberOfMissilesCanFragment];
+
+          // Transfers the indexes of missiles eligible to fragment to the dedicated array.
+          int index = 0;
+          for(int i = 0; i < ENEMY_MISSILE_BUFFER; i++)
           {
-            if(!enemyMissiles[j].isActive)
+            if(fragmentIndexes[i])
             {
-              // Retrieves an eligible missile for fragmentation.
-              int selectedIndexToFragment = missilesCanFragment[i];
+              missilesCanFragment[index] = i;
+              index++;
+            }
+          }
 
-              // Prevents the base missile from fragmenting multiple times.
-              enemyMissiles[selectedIndexToFragment].canFragment = 0;
-              // Creates a new missile, fragmenting from the base missile's current position.
-              enemyMissiles[j] = createEnemyMissile(enemyMissiles, selectedIndexToFragment, bases, cities, enemyMissiles[selectedIndexToFragment].destPos.x);
-              enemyMissilesFired++;
+          // Determines the actual number to fragment. Ensures spawns cannot exceed the buffer.
+          short fragmentMissilesToSpawn = (numberOfMissilesCanFragment > maximumSpawns) ? maximumSpawns : numberOfMissilesCanFragment;
 
-              break;
-            }
+          // Spawns missiles from fragmentation, while there is room for them. New missiles are added after the rows being fragmented.
+          for(int i = 0; i < fragmentMissilesToSpawn && enemyMissiles.count < enemyMissiles.capacity; i++)
+          {
+            // Retrieves an eligible missile for fragmentation.
+            int selectedRowToFragment = missilesCanFragment[i];
+
+            // Prevents the base missile from fragmenting multiple times.
+            enemyMissiles.canFragment[selectedRowToFragment] = 0;
+            // Creates a new missile, fragmenting from the base missile's current position.
+            createEnemyMissile(&enemyMissiles, selectedRowToFragment, &bases, &cities, enemyMissiles.destX[selectedRowToFragment]);
+            enemyMissilesFired++;
+            nextSnapshot->events.spawns++;
           }
         }
-      }
-
-      // Determines the rate of enemy missile spawns from the top of the viewport.
-      unsigned short millisBetweenEnemySpawns = 2000;
 
-      // Spawns missile from clock timing.
-      if((!enemiesLastSpawnTime || getMillisElapsed(&enemiesLastSpawnTime) > millisBetweenEnemySpawns) && enemyMissilesFired < ENEMY_MISSILES_PER_ROUND)
-      {
-        enemiesLastSpawnTime = clock();
+        PROFILE_END(phaseFragmentSpawn);
+        PROFILE_BEGIN(phaseTimedSpawn);
 
-        for(int i = 0; i < ENEMY_MISSILE_BUFFER; i++)
+        // Spawns missile from clock timing.
+        if(!getMillisUntilDue(&enemiesLastSpawnTime, ENEMY_SPAWN_MILLIS) && enemyMissilesFired < ENEMY_MISSILES_PER_ROUND)
         {
-          if(!enemyMissiles[i].isActive)
+          enemiesLastSpawnTime = clock();
+          nextSnapshot->events.timersFired++;
+
+          // Spawns an enemy missile from the top of the viewport.
+          if(createEnemyMissile(&enemyMissiles, -1, &bases, &cities, -1) != -1)
           {
-            // Spawns an enemy missile from the top of the viewport.
-            enemyMissiles[i] = createEnemyMissile(enemyMissiles, -1, bases, cities, -1);
             enemyMissilesFired++;
-
-            break;
+            nextSnapshot->events.spawns++;
           }
         }
+
+        PROFILE_END(phaseTimedSpawn);
+      }
+
+      runMissilePhases(&tick);
+
+      drawScore(score);
+
+      PROFILE_BEGIN(phaseEndOfRound);
+
+      // Checks whether the end of the round should initiate.
+      checkEndOfRoundPending(&gameState, &bases, &cities, &playerMissiles, &enemyMissiles, enemyMissilesFired);
+      // Checks whether the round has ended.
+      checkEndOfRound(&gameState, &cities, &playerMissiles, &enemyMissiles, enemyMissilesFired);
+
+      // Initiate the end of the round and game.
+      if(gameState == endOfGame)
+      {
+        // The render thread keeps showing the end game screen until the player leaves.
+        drawGameEnd();
+        gameState = gameOver;
       }
+      // Shows the results of the round. The next round starts once they have been shown for ROUND_SUMMARY_MILLIS.
+      else if(gameState == endOfRound)
+      {
+        drawRoundEnd(&score, &bases, &cities, enemyMissilesDestroyed, roundNumber);
+        roundSummaryStarted = clock();
+        gameState = showingRoundSummary;
+      }
+
+      PROFILE_END(phaseEndOfRound);
     }
+    // Prepares the next round once the results of the last one have been shown.
+    else if(gameState == showingRoundSummary && !getMillisUntilDue(&roundSummaryStarted, ROUND_SUMMARY_MILLIS))
+    {
+      PROFILE_BEGIN(phaseEndOfRound);
 
-    updatePlayerMissiles(playerMissiles, &gameState, &playersLastUpdateTime);
-    updateEnemyMissiles(enemyMissiles, &gameState, &enemiesLastUpdateTime, roundNumber);
+      hideRoundEnd();
 
-    // Marks the assets that have hit been hit by enemy missiles as not being alive.
-    destroyAssets(enemyMissiles, bases, cities);
-    // Checks whether any enemy missiles have been intercepted.
-    checkInterceptions(enemyMissiles, &score, &enemyMissilesDestroyed);
+      roundNumber++;
+
+      enemyMissilesFired = 0;
+      enemyMissilesDestroyed = 0;
+      gameState = ongoing;
+
+      removeAllEntities(&playerMissiles);
+      removeAllEntities(&enemyMissiles);
 
-    drawScore(score);
+      initBases(&bases);
+      drawBases(&bases);
+
+      enemiesLastSpawnTime = 0;
+      enemiesLastUpdateTime = 0;
+      playersLastUpdateTime = 0;
 
-    // Checks whether the end of the round should initiate.
-    checkEndOfRoundPending(&gameState, bases, cities, playerMissiles, enemyMissiles, enemyMissilesFired);
-    // Checks whether the round has ended.
-    checkEndOfRound(&gameState, cities, playerMissiles, enemyMissiles, enemyMissilesFired);
+      PROFILE_END(phaseEndOfRound);
+    }
 
-    // Initiate the end of the round and game.
-    if(gameState == endOfGame)
+    if(canvas.changed)
     {
-      drawGameEnd();
+      publishSnapshot();
+    }
+
+    // Sleeps until the next timer is due, or a click arrives.
+    waitForTick(getMillisUntilNextTick(gameState, &playerMissiles, &enemyMissiles, &enemiesLastSpawnTime, &enemiesLastUpdateTime,
+      &playersLastUpdateTime, enemyMissilesFired, roundNumber, &roundSummaryStarted));
+  }
+
+  stopTaskPool();
+
+  freeArchetypeTable(&bases);
+  freeArchetypeTable(&cities);
+  freeArchetypeTable(&playerMissiles);
+  freeArchetypeTable(&enemyMissiles);
+
+  return 0;
+}
+
+/**
+ * stopSimulation
+ * Description: Asks the simulation thread to stop, and waits for it to finish. Render thread.
+ */
+void stopSimulation()
+{
+  SetEvent(simulationStop);
+  WaitForSingleObject(simulationThread, INFINITE);
+}
 
-      // Keeps the end game screen open and prevents screen resizing.
-      while(1)
+/**
+ * readInput
+ * Description:
+ * Reads the events that PDCurses has waiting. Clicks go to the simulation thread through the input ring.
+ * Other keys become INPUT_REQUEST bits for the render thread. Reads from inputWindow rather than stdscr, as wgetch() refreshes a window that has changed
+ * and would draw over the banner and overlay, and outside the resizing state. Input thread, with cursesLock held.
+ * Returns: 0 once Escape has been pressed, else 1
+ */
+int readInput()
+{
+  MEVENT events[MOUSE_EVENT_BATCH];
+  int inputEvent;
+
+  while((inputEvent = wgetch(inputWindow)) != ERR)
+  {
+    switch(inputEvent)
+    {
+      case ESCAPE:
+      {
+        requestRender(INPUT_REQUEST_QUIT);
+        return 0;
+      }
+      case KEY_RESIZE:
+      {
+        requestRender(INPUT_REQUEST_RESIZE);
+        break;
+      }
+#ifndef NDEBUG
+      case PROFILE_OVERLAY_KEY:
+      {
+        requestRender(INPUT_REQUEST_OVERLAY);
+        break;
+      }
+#endif
+      case KEY_MOUSE:
       {
-        inputEvent = getch();
+        // Collects this mouse event and any others that are waiting, so that no clicks are lost.
+        int eventCount = nc_getmouse_batch(events, MOUSE_EVENT_BATCH);
 
-        switch(inputEvent)
+        for(int e = 0; e < eventCount; e++)
         {
-          case ESCAPE:
-          {
-            endwin();
-            exit(0);
-          }
-          case KEY_RESIZE:
+          MEVENT event = events[e];
+
+          /*
+           * Passes the click to the simulation thread, which creates a new player missile if the game allows it.
+           * Fires on the press of the left button, without waiting for its release.
+           */
+          if(event.bstate & BUTTON1_PRESSED)
           {
-            resize_term(VIEWPORT_HEIGHT, VIEWPORT_WIDTH);
-            /*
-             * The amount of sleep affects whether the screen clips when it is resized.
-             * I do not know why this behaviour is happening.
-             * At the value of 300, the clipping does not seem to appear (Windows 10.0.22621) but that may not be universal.
-             */
-            Sleep(300);
+            // Check if click occurs within clickable bounds.
+            if(event.x >= 4 && event.x <= VIEWPORT_WIDTH - 5 && event.y >= 3 && event.y <= VIEWPORT_HEIGHT - 10)
+            {
+              struct Vector destination = {event.x, event.y};
+              pushClick(destination, event.time);
+            }
           }
         }
+        break;
+      }
+    }
+  }
+
+  return 1;
+}
+
+/**
+ * runInput
+ * Description:
+ * Reads input on its own thread, so that clicks are taken as they arrive however long a frame takes.
+ * Blocks until the console has input, then reads all of it with cursesLock held.
+ * Params:
+ * unused - required by CreateThread()
+ * Returns: 0 once Escape has been pressed or inputStop has been signalled
+ */
+DWORD WINAPI runInput(LPVOID unused)
+{
+  HANDLE console = GetStdHandle(STD_INPUT_HANDLE);
+  int reading = 1;
+
+  while(reading && WaitForSingleObject(inputStop, 0) == WAIT_TIMEOUT)
+  {
+    // Returns as soon as there is console input; the timeout only bounds how long stopping takes.
+    WaitForSingleObject(console, INPUT_WAIT_MILLIS);
+
+    EnterCriticalSection(&cursesLock);
+    reading = readInput();
+    LeaveCriticalSection(&cursesLock);
+  }
+
+  return 0;
+}
+
+/**
+ * lockCurses
+ * Description: Takes cursesLock for the render thread, and notes the heap's allocations so far for unlockCurses(). Render thread.
+ */
+void lockCurses()
+{
+  EnterCriticalSection(&cursesLock);
+  allocationsAtLock = cursesHeap->stats.allocs;
+}
+
+/**
+ * unlockCurses
+ * Description: Adds the allocations made since lockCurses() to renderAllocations, and releases cursesLock. Render thread.
+ */
+void unlockCurses()
+{
+  renderAllocations += cursesHeap->stats.allocs - allocationsAtLock;
+  LeaveCriticalSection(&cursesLock);
+}
+
+/**
+ * stopThreads
+ * Description: Stops the input and simulation threads, and waits for them to finish. Render thread.
+ */
+void stopThreads()
+{
+  SetEvent(inputStop);
+  WaitForSingleObject(inputThread, INFINITE);
+
+  stopSimulation();
+}
+
+/**
+ * main
+ * Description: controls the game loop and handles updates in the game's state.
+ * Returns: 0 at the end of normal program execution, else a non-zero value
+ */
+int main()
+{
+  /*
+   * PDCURSES SETUP.
+   */
+  // Initialises curses. This must be the first curses function to be called in the program.
+  initscr();
+  // Sets the dimensions  of the viewport.
+  resize_term(VIEWPORT_HEIGHT, VIEWPORT_WIDTH);
+  // Sets the input mode for the current terminal to cbreak mode.
+  cbreak();
+  // Removes the cursor from the viewport.
+  curs_set(0);
+  // Prevents characters from keyboard input being printed to the terminal.
+  noecho();
+  // Opens the window that input is read from, and asks for the mouse events that the game uses.
+  initInput();
+
+  // Redefines colour pair combinations.
+  initColours();
+
+  // Prepares the art for assets and explosions.
+  initSprites();
+
+  // Sets aside the memory for short-lived windows, and notes the heap that frames should leave alone.
+  initAllocators();
+
+  // Sets the frame budget that the flight recorder watches for.
+  initFlightRecorder();
+
+#ifndef NDEBUG
+  atexit(reportHeapAllocations);
+  atexit(reportRenderStats);
+  atexit(reportLatency);
+  initProfiler();
+  initTracer();
+#endif
+
+  /*
+   * The simulation runs on its own thread, and hands the render thread snapshots to draw.
+   * Input is read on a third thread, which passes clicks to the simulation and other keys to the render thread.
+   */
+  snapshotReady = CreateEvent(NULL, FALSE, FALSE, NULL);
+  renderWake = CreateEvent(NULL, FALSE, FALSE, NULL);
+  clicksReady = CreateEvent(NULL, FALSE, FALSE, NULL);
+  simulationStop = CreateEvent(NULL, TRUE, FALSE, NULL);
+  inputStop = CreateEvent(NULL, TRUE, FALSE, NULL);
+
+  // Falls back to a timer that keeps to the system tick on versions of Windows without high resolution timers.
+  tickTimer = CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+  if(!tickTimer)
+  {
+    tickTimer = CreateWaitableTimer(NULL, FALSE, NULL);
+  }
+
+  InitializeCriticalSection(&cursesLock);
+  simulationThread = CreateThread(NULL, 0, runSimulation, NULL, 0, NULL);
+  inputThread = CreateThread(NULL, 0, runInput, NULL, 0, NULL);
+
+  enum screenStates screenState = showing;
+  // When the console was last resized.
+  clock_t resizeStarted = 0;
+
+  while(1)
+  {
+    unsigned long allocationsBeforeFrame = renderAllocations;
+    // Cleared on frames that rebuild the screen, which the flight recorder should not report as slow.
+    int checkFrameBudget = 1;
+
+    beginFlightFrame();
+
+    if(screenState == resizing && !getMillisUntilDue(&resizeStarted, RESIZE_SETTLE_MILLIS))
+    {
+      screenState = showing;
+    }
+
+    // Draws the newest snapshot.
+    PROFILE_BEGIN(phaseRefresh);
+    if(screenState == showing)
+    {
+      lockCurses();
+      if(takeSnapshot())
+      {
+        applySnapshot(&snapshots[renderSnapshot]);
+      }
+      wnoutrefresh(stdscr);
+      if(roundEndBanner)
+      {
+        wnoutrefresh(roundEndBanner);
       }
+#ifndef NDEBUG
+      refreshProfileOverlay();
+#endif
+      doupdate();
+      unlockCurses();
     }
-    // Initiate the end of the round and prepares the next round.
-    else if(gameState == endOfRound)
+    PROFILE_END(phaseRefresh);
+
+    // The snapshot has been drawn, so any missiles launched in it have reached the screen.
+    collectFirstCellLatencies();
+
+    // Acts on the keys that the input thread has read since the last frame.
+    PROFILE_BEGIN(phaseInput);
+    LONG requests = InterlockedExchange(&inputRequests, 0);
+
+    if(requests & INPUT_REQUEST_QUIT)
     {
-      drawRoundEnd(&score, bases, cities, enemyMissilesDestroyed, roundNumber);
+      stopThreads();
+      endwin();
+      exit(0);
+    }
 
-      roundNumber++;
+    if(requests & INPUT_REQUEST_RESIZE)
+    {
+      lockCurses();
+      resize_term(VIEWPORT_HEIGHT, VIEWPORT_WIDTH);
 
-      enemyMissilesFired = 0;
-      enemyMissilesDestroyed = 0;
-      gameState = ongoing;
+      if(roundEndBanner)
+      {
+        touchwin(roundEndBanner);
+      }
+      unlockCurses();
 
-      initMissiles(playerMissiles, PLAYER_MISSILE_BUFFER);
-      initMissiles(enemyMissiles, ENEMY_MISSILE_BUFFER);
+      /*
+       * The time that drawing waits affects whether the screen clips when it is resized.
+       * I do not know why this behaviour is happening.
+       * At the value of 300, the clipping does not seem to appear (Windows 10.0.22621) but that may not be universal.
+       */
+      resizeStarted = clock();
+      screenState = resizing;
+      checkFrameBudget = 0;
+    }
 
-      initBases(bases);
-      drawBases(bases);
+#ifndef NDEBUG
+    if(requests & INPUT_REQUEST_OVERLAY)
+    {
+      lockCurses();
+      toggleProfileOverlay();
+      unlockCurses();
+    }
+#endif
+    PROFILE_END(phaseInput);
 
-      enemiesLastSpawnTime = 0;
-      enemiesLastUpdateTime = 0;
-      playersLastUpdateTime = 0;
+    // Resizing rebuilds the screen, so only the other frames are expected to leave the heap alone.
+    if(!(requests & INPUT_REQUEST_RESIZE))
+    {
+      framesPlayed++;
 
-      eraseRoundEnd();
+      if(renderAllocations != allocationsBeforeFrame)
+      {
+        framesThatAllocated++;
+      }
     }
+
+    PROFILE_END_FRAME();
+    endFlightFrame(checkFrameBudget);
+
+    // Sleeps until there is a snapshot to draw, a request from the input thread, or the console has settled after a resize.
+    HANDLE wakers[2] = {snapshotReady, renderWake};
+    WaitForMultipleObjects(2, wakers, FALSE, (screenState == resizing) ? getMillisUntilDue(&resizeStarted, RESIZE_SETTLE_MILLIS) : INFINITE);
   }
 }
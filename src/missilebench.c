@@ -0,0 +1,163 @@
+/**
+ * Description: Times each version of the missile stepping kernel in missilestep.h that the processor supports, and checks them against the scalar version.
+ *
+ * Usage: missilebench [MISSILES]
+ * Steps 100000 missiles unless told otherwise; first with every missile moving, then with every other missile at its destination,
+ * and then with a random half of them at their destinations, which the scalar version cannot predict.
+ * Builds on its own, e.g.: gcc -O2 -o missilebench missilebench.c
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "missilestep.h"
+
+// The number of times each kernel steps the missiles, to time it over.
+#define BENCH_PASSES 1000
+// The number of columns in MissileSteppers.
+#define STEPPER_COLUMNS 5
+
+/**
+ * BenchKernel
+ * Description: A version of the kernel to time.
+ * Fields:
+ * name - the name of the version
+ * kernel - the version, or NULL if the processor does not support it
+ */
+struct BenchKernel {
+  const char* name;
+  MissileStepKernel kernel;
+};
+
+/**
+ * aimBenchMissiles
+ * Description: Aims the missiles at random destinations across a 99 by 45 viewport, as the game does, but with enough steps left that they keep moving.
+ * Params:
+ * steppers - the missiles to aim
+ * spread - 1 for every missile to move, 2 for every other missile to be at its destination, or 3 for a random half of them to be
+ */
+void aimBenchMissiles(struct MissileSteppers* steppers, int spread)
+{
+  srand(1);
+
+  for(int i = 0; i < steppers->count; i++)
+  {
+    int flightX = rand() % 97 - 48;
+    int flightY = rand() % 44 + 1;
+    int steps = (abs(flightX) > flightY) ? abs(flightX) : flightY;
+    int idle = (spread == 3) ? rand() % 2 : i % spread;
+
+    steppers->x[i] = (rand() % 97 + 1) * MISSILE_FIXED_ONE;
+    steppers->y[i] = MISSILE_FIXED_ONE;
+    steppers->stepX[i] = flightX * MISSILE_FIXED_ONE / steps;
+    steppers->stepY[i] = flightY * MISSILE_FIXED_ONE / steps;
+    steppers->stepsLeft[i] = idle ? 0 : BENCH_PASSES + 1;
+  }
+}
+
+/**
+ * runBench
+ * Description: Times a version of the kernel, stepping the missiles BENCH_PASSES times.
+ * Params:
+ * bench - the version to time
+ * steppers - the missiles, which are aimed afresh
+ * cells - receives the cells that the missiles entered
+ * spread - passed to aimBenchMissiles()
+ * Returns: the number of cells listed by the last pass
+ */
+int runBench(struct BenchKernel* bench, struct MissileSteppers* steppers, struct MissileCells* cells, int spread)
+{
+  int moved = 0;
+
+  aimBenchMissiles(steppers, spread);
+
+  clock_t started = clock();
+
+  for(int pass = 0; pass < BENCH_PASSES; pass++)
+  {
+    moved = bench->kernel(steppers, cells);
+  }
+
+  double micros = (double)(clock() - started) * 1000000 / CLOCKS_PER_SEC / BENCH_PASSES;
+
+  printf("%-8s %9.1f us a pass, %6.2f ns a missile\n", bench->name, micros, micros * 1000 / steppers->count);
+
+  return moved;
+}
+
+int main(int argc, char* argv[])
+{
+  int count = (argc > 1) ? atoi(argv[1]) : 100000;
+  // The SIMD versions are filled in below if the processor supports them.
+  struct BenchKernel benches[3] = {{"scalar", stepMissilesScalar}, {"SSE4.1", NULL}, {"AVX2", NULL}};
+  int failures = 0;
+
+  if(count < 1)
+  {
+    fprintf(stderr, "Usage: %s [MISSILES]\n", argv[0]);
+    return 2;
+  }
+
+#if MISSILE_STEP_SIMD
+  __builtin_cpu_init();
+  benches[1].kernel = __builtin_cpu_supports("sse4.1") ? stepMissilesSse41 : NULL;
+  benches[2].kernel = __builtin_cpu_supports("avx2") ? stepMissilesAvx2 : NULL;
+#endif
+
+  // The scalar version's state is kept, to check the others against.
+  int32_t* columns = malloc(sizeof(int32_t) * count * (STEPPER_COLUMNS + 3) * 2);
+
+  if(!columns)
+  {
+    fprintf(stderr, "%s: cannot allocate %d missiles\n", argv[0], count);
+    return 1;
+  }
+
+  struct MissileSteppers steppers[2];
+  struct MissileCells cells[2];
+
+  for(int i = 0; i < 2; i++)
+  {
+    int32_t* column = columns + (size_t)count * (STEPPER_COLUMNS + 3) * i;
+
+    steppers[i] = (struct MissileSteppers){column, column + count, column + count * 2, column + count * 3, column + count * 4, count};
+    cells[i] = (struct MissileCells){column + count * 5, column + count * 6, column + count * 7};
+  }
+
+  const char* picked;
+  getMissileStepKernel(&picked);
+  printf("%d missiles, %d passes; the game uses %s\n", count, BENCH_PASSES, picked);
+
+  const char* spreadNames[3] = {"Every missile moving", "Every other missile moving", "A random half of the missiles moving"};
+
+  for(int spread = 1; spread <= 3; spread++)
+  {
+    printf("\n%s:\n", spreadNames[spread - 1]);
+
+    int expected = runBench(&benches[0], &steppers[0], &cells[0], spread);
+
+    for(int i = 1; i < 3; i++)
+    {
+      if(!benches[i].kernel)
+      {
+        printf("%-8s not supported\n", benches[i].name);
+        continue;
+      }
+
+      int moved = runBench(&benches[i], &steppers[1], &cells[1], spread);
+
+      // Both versions must leave the missiles in the same state, having listed the same cells.
+      if(moved != expected || memcmp(steppers[0].x, steppers[1].x, sizeof(int32_t) * count * STEPPER_COLUMNS) ||
+         memcmp(cells[0].rows, cells[1].rows, sizeof(int32_t) * moved) || memcmp(cells[0].x, cells[1].x, sizeof(int32_t) * moved) ||
+         memcmp(cells[0].y, cells[1].y, sizeof(int32_t) * moved))
+      {
+        printf("%-8s differs from scalar\n", benches[i].name);
+        failures++;
+      }
+    }
+  }
+
+  free(columns);
+
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,309 @@
+/**
+ * Description: The kernel that steps missiles along their paths, shared by the game and the missilebench benchmark.
+ *
+ * Missiles are stepped as structure-of-arrays, with positions in fixed point. Every step moves a missile one cell along the
+ * major axis of its path and a fraction of a cell along the other, so each missile that is stepped occupies a new cell.
+ * There are SSE4.1 and AVX2 versions of the kernel, and a scalar version for other processors; getMissileStepKernel() picks
+ * the best one that the processor supports.
+ */
+#ifndef MISSILESTEP_H
+#define MISSILESTEP_H
+
+#include <stdint.h>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define MISSILE_STEP_SIMD 1
+#include <immintrin.h>
+#else
+#define MISSILE_STEP_SIMD 0
+#endif
+
+// The number of fraction bits in a fixed point coordinate.
+#define MISSILE_FIXED_SHIFT 16
+// A whole cell in fixed point. Coordinates and distances are multiplied by it, as shifting negative distances is undefined.
+#define MISSILE_FIXED_ONE (1 << MISSILE_FIXED_SHIFT)
+// Half a cell in fixed point, added before shifting so that coordinates round to the nearest cell.
+#define MISSILE_FIXED_HALF (1 << (MISSILE_FIXED_SHIFT - 1))
+
+/**
+ * MissileSteppers
+ * Description: The movement state of a set of missiles, as a column for each field. Each column has count values.
+ * Fields:
+ * x - the x coordinate of each missile, in fixed point
+ * y - the y coordinate of each missile, in fixed point
+ * stepX - the distance each missile moves along the x axis in a step, in fixed point
+ * stepY - the distance each missile moves along the y axis in a step, in fixed point
+ * stepsLeft - the steps until each missile reaches its destination. Missiles with none left are not stepped.
+ * count - the number of missiles
+ */
+struct MissileSteppers {
+  int32_t* x;
+  int32_t* y;
+  int32_t* stepX;
+  int32_t* stepY;
+  int32_t* stepsLeft;
+  int count;
+};
+
+/**
+ * MissileCells
+ * Description: The cells that missiles entered in a step, in the order of the missiles. Each column must have room for every missile.
+ * Fields:
+ * rows - the index of the missile that entered each cell
+ * x - the x coordinate of each cell
+ * y - the y coordinate of each cell
+ */
+struct MissileCells {
+  int32_t* rows;
+  int32_t* x;
+  int32_t* y;
+};
+
+/**
+ * MissileStepKernel
+ * Description: Steps every missile that has steps left, and lists the cells they entered.
+ * Params:
+ * steppers - the missiles to step
+ * cells - receives the cells that the missiles entered
+ * Returns: the number of cells listed
+ */
+typedef int (*MissileStepKernel)(struct MissileSteppers* steppers, struct MissileCells* cells);
+
+/**
+ * stepMissilesFrom
+ * Description: Steps the missiles from the given index onwards, one at a time.
+ * Params:
+ * steppers - the missiles to step
+ * cells - receives the cells that the missiles entered
+ * first - the index of the first missile to step
+ * moved - the number of cells already listed
+ * Returns: the number of cells listed
+ */
+static int stepMissilesFrom(struct MissileSteppers* steppers, struct MissileCells* cells, int first, int moved)
+{
+  for(int i = first; i < steppers->count; i++)
+  {
+    if(steppers->stepsLeft[i] > 0)
+    {
+      steppers->x[i] += steppers->stepX[i];
+      steppers->y[i] += steppers->stepY[i];
+      steppers->stepsLeft[i]--;
+
+      cells->rows[moved] = i;
+      cells->x[moved] = (steppers->x[i] + MISSILE_FIXED_HALF) >> MISSILE_FIXED_SHIFT;
+      cells->y[moved] = (steppers->y[i] + MISSILE_FIXED_HALF) >> MISSILE_FIXED_SHIFT;
+      moved++;
+    }
+  }
+
+  return moved;
+}
+
+/**
+ * stepMissilesScalar
+ * Description: The MissileStepKernel for processors without SSE4.1.
+ */
+static int stepMissilesScalar(struct MissileSteppers* steppers, struct MissileCells* cells)
+{
+  return stepMissilesFrom(steppers, cells, 0, 0);
+}
+
+#if MISSILE_STEP_SIMD
+
+/*
+ * For each mask of four lanes, the shuffle that packs the lanes in the mask to the front of a vector, in order.
+ * Lanes that are not in the mask are zeroed.
+ */
+static const uint8_t missileCompressShuffles[16][16] = {
+  {0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+  {0x00, 0x01, 0x02, 0x03, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+  {0x04, 0x05, 0x06, 0x07, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+  {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+  {0x08, 0x09, 0x0a, 0x0b, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+  {0x00, 0x01, 0x02, 0x03, 0x08, 0x09, 0x0a, 0x0b, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+  {0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+  {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x80, 0x80, 0x80, 0x80},
+  {0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+  {0x00, 0x01, 0x02, 0x03, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+  {0x04, 0x05, 0x06, 0x07, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+  {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80},
+  {0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80},
+  {0x00, 0x01, 0x02, 0x03, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80},
+  {0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x80, 0x80, 0x80, 0x80},
+  {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f}
+};
+
+/*
+ * For each mask of four lanes, the number of lanes in it.
+ * POPCNT is not part of SSE4.1, so __builtin_popcount() would be a call into libgcc for every vector.
+ */
+static const uint8_t missileLaneCounts[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+
+/**
+ * compressMissileCells
+ * Description: Lists the cells entered by the missiles of four lanes that were stepped, packed together so that they can be stored at once.
+ * Params:
+ * cells - receives the cells
+ * moved - the number of cells already listed. The columns of cells must have room for four more.
+ * rows - the index of each lane's missile
+ * cellX - the x coordinate of each lane's cell
+ * cellY - the y coordinate of each lane's cell
+ * mask - a bit for each lane, set if its missile was stepped
+ * Returns: the number of cells listed
+ */
+__attribute__((target("sse4.1")))
+static int compressMissileCells(struct MissileCells* cells, int moved, __m128i rows, __m128i cellX, __m128i cellY, int mask)
+{
+  __m128i shuffle = _mm_loadu_si128((const __m128i*)missileCompressShuffles[mask]);
+
+  _mm_storeu_si128((__m128i*)(cells->rows + moved), _mm_shuffle_epi8(rows, shuffle));
+  _mm_storeu_si128((__m128i*)(cells->x + moved), _mm_shuffle_epi8(cellX, shuffle));
+  _mm_storeu_si128((__m128i*)(cells->y + moved), _mm_shuffle_epi8(cellY, shuffle));
+
+  return moved + missileLaneCounts[mask];
+}
+
+/**
+ * stepMissilesSse41
+ * Description: The MissileStepKernel for processors with SSE4.1, which steps four missiles at a time.
+ */
+__attribute__((target("sse4.1")))
+static int stepMissilesSse41(struct MissileSteppers* steppers, struct MissileCells* cells)
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i half = _mm_set1_epi32(MISSILE_FIXED_HALF);
+  const __m128i lanes = _mm_setr_epi32(0, 1, 2, 3);
+  int moved = 0;
+  int i = 0;
+
+  for(; i + 4 <= steppers->count; i += 4)
+  {
+    __m128i stepsLeft = _mm_loadu_si128((__m128i*)(steppers->stepsLeft + i));
+    __m128i active = _mm_cmpgt_epi32(stepsLeft, zero);
+
+    // Skips vectors of missiles that have all reached their destination.
+    if(_mm_testz_si128(active, active))
+    {
+      continue;
+    }
+
+    __m128i x = _mm_add_epi32(_mm_loadu_si128((__m128i*)(steppers->x + i)), _mm_and_si128(_mm_loadu_si128((__m128i*)(steppers->stepX + i)), active));
+    __m128i y = _mm_add_epi32(_mm_loadu_si128((__m128i*)(steppers->y + i)), _mm_and_si128(_mm_loadu_si128((__m128i*)(steppers->stepY + i)), active));
+
+    _mm_storeu_si128((__m128i*)(steppers->x + i), x);
+    _mm_storeu_si128((__m128i*)(steppers->y + i), y);
+    // The active lanes are all ones, which is -1.
+    _mm_storeu_si128((__m128i*)(steppers->stepsLeft + i), _mm_add_epi32(stepsLeft, active));
+
+    __m128i cellX = _mm_srai_epi32(_mm_add_epi32(x, half), MISSILE_FIXED_SHIFT);
+    __m128i cellY = _mm_srai_epi32(_mm_add_epi32(y, half), MISSILE_FIXED_SHIFT);
+    int mask = _mm_movemask_ps(_mm_castsi128_ps(active));
+
+    // The cells are stored at moved, which is no more than i, so there is always room for a whole vector.
+    moved = compressMissileCells(cells, moved, _mm_add_epi32(_mm_set1_epi32(i), lanes), cellX, cellY, mask);
+  }
+
+  return stepMissilesFrom(steppers, cells, i, moved);
+}
+
+/**
+ * stepMissilesAvx2
+ * Description: The MissileStepKernel for processors with AVX2, which steps eight missiles at a time.
+ */
+__attribute__((target("avx2")))
+static int stepMissilesAvx2(struct MissileSteppers* steppers, struct MissileCells* cells)
+{
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i half = _mm256_set1_epi32(MISSILE_FIXED_HALF);
+  const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+  int moved = 0;
+  int i = 0;
+
+  for(; i + 8 <= steppers->count; i += 8)
+  {
+    __m256i stepsLeft = _mm256_loadu_si256((__m256i*)(steppers->stepsLeft + i));
+    __m256i active = _mm256_cmpgt_epi32(stepsLeft, zero);
+
+    // Skips vectors of missiles that have all reached their destination.
+    if(_mm256_testz_si256(active, active))
+    {
+      continue;
+    }
+
+    __m256i x = _mm256_add_epi32(_mm256_loadu_si256((__m256i*)(steppers->x + i)), _mm256_and_si256(_mm256_loadu_si256((__m256i*)(steppers->stepX + i)), active));
+    __m256i y = _mm256_add_epi32(_mm256_loadu_si256((__m256i*)(steppers->y + i)), _mm256_and_si256(_mm256_loadu_si256((__m256i*)(steppers->stepY + i)), active));
+
+    _mm256_storeu_si256((__m256i*)(steppers->x + i), x);
+    _mm256_storeu_si256((__m256i*)(steppers->y + i), y);
+    // The active lanes are all ones, which is -1.
+    _mm256_storeu_si256((__m256i*)(steppers->stepsLeft + i), _mm256_add_epi32(stepsLeft, active));
+
+    __m256i cellX = _mm256_srai_epi32(_mm256_add_epi32(x, half), MISSILE_FIXED_SHIFT);
+    __m256i cellY = _mm256_srai_epi32(_mm256_add_epi32(y, half), MISSILE_FIXED_SHIFT);
+    int mask = _mm256_movemask_ps(_mm256_castsi256_ps(active));
+
+    if(mask == 0xFF)
+    {
+      _mm256_storeu_si256((__m256i*)(cells->rows + moved), _mm256_add_epi32(_mm256_set1_epi32(i), lanes));
+      _mm256_storeu_si256((__m256i*)(cells->x + moved), cellX);
+      _mm256_storeu_si256((__m256i*)(cells->y + moved), cellY);
+      moved += 8;
+    }
+    // Packs each half of the vector in turn, as there is no instruction that packs the lanes of a whole one.
+    else
+    {
+      __m256i rows = _mm256_add_epi32(_mm256_set1_epi32(i), lanes);
+
+      moved = compressMissileCells(cells, moved, _mm256_castsi256_si128(rows), _mm256_castsi256_si128(cellX), _mm256_castsi256_si128(cellY), mask & 0xF);
+      moved = compressMissileCells(cells, moved, _mm256_extracti128_si256(rows, 1), _mm256_extracti128_si256(cellX, 1),
+        _mm256_extracti128_si256(cellY, 1), mask >> 4);
+    }
+  }
+
+  return stepMissilesFrom(steppers, cells, i, moved);
+}
+
+#endif
+
+/**
+ * getMissileStepKernel
+ * Description: Picks the fastest version of the kernel that the processor supports.
+ * Params:
+ * name - receives the name of the version, unless NULL
+ * Returns: the kernel
+ */
+static MissileStepKernel getMissileStepKernel(const char** name)
+{
+#if MISSILE_STEP_SIMD
+  __builtin_cpu_init();
+
+  if(__builtin_cpu_supports("avx2"))
+  {
+    if(name)
+    {
+      *name = "AVX2";
+    }
+
+    return stepMissilesAvx2;
+  }
+
+  if(__builtin_cpu_supports("sse4.1"))
+  {
+    if(name)
+    {
+      *name = "SSE4.1";
+    }
+
+    return stepMissilesSse41;
+  }
+#endif
+
+  if(name)
+  {
+    *name = "scalar";
+  }
+
+  return stepMissilesScalar;
+}
+
+#endif
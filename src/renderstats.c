@@ -0,0 +1,189 @@
+/**
+ * Description:
+ * Checks that PDCurses sends the screen only the cells that changed, and that frames leave the heap alone, by drawing the game's frames on the offscreen port
+ * and reading its render stats and allocation counters.
+ *
+ * Usage: renderstats
+ * Draws the landscape at the start of a round, presents the same snapshot again unchanged, and then presents one with the landscape redrawn over itself
+ * and one cell of the sky changed, each as the render thread does. Then shows and hides the round end banner, and presents an unchanged frame again.
+ * Fails if the first frame does not redraw the whole screen, if an unchanged frame sends anything, if the changed frame sends more than the one changed cell,
+ * or if any frame, the banner's included, allocates from the heap.
+ * Builds like the game, which it includes, but against the offscreen port; see the Makefile, or e.g.:
+ * make -C ../lib/PDCurses-3.9/offscreen && gcc -std=gnu99 -O2 -I../lib/PDCurses-3.9 -o renderstats renderstats.c ../lib/PDCurses-3.9/offscreen/pdcurses.a
+ */
+#include <curses.h>
+#include <limits.h>
+#include <math.h>
+#include <time.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+
+// The game is included with its own main() renamed.
+#define main gameMain
+
+#include "main.c"
+
+#undef main
+
+// Reads back a cell of the offscreen port's screen; see offscreen/README.md.
+PDCEX chtype PDC_offscreen_cell(int y, int x);
+
+/**
+ * ExpectedStats
+ * Description: What a frame should have sent to the screen.
+ * Fields:
+ * lines - the lines that doupdate() should scan or redraw
+ * compared - the cells that it should compare with the last screen
+ * runs - the runs of cells that it should send to the port
+ * cells - the cells in those runs
+ */
+struct ExpectedStats {
+  unsigned long lines;
+  unsigned long compared;
+  unsigned long runs;
+  unsigned long cells;
+};
+
+/**
+ * presentFrame
+ * Description:
+ * Publishes the canvas, and draws the snapshot as the render thread does. Prints what the frame sent and how often it allocated from the heap,
+ * and checks them against what is expected.
+ * Params:
+ * name - what the frame is, to print beside its stats
+ * expected - what the frame should send, or NULL to check only that it does not allocate
+ * Returns: 1 if the frame sent what was expected and did not allocate from the heap, else 0
+ */
+int presentFrame(const char* name, struct ExpectedStats* expected)
+{
+  PDC_RENDER_STATS stats;
+  unsigned long allocationsBeforeFrame = renderAllocations;
+  int passed = 1;
+
+  publishSnapshot();
+  PDC_reset_render_stats();
+
+  lockCurses();
+  if(takeSnapshot())
+  {
+    applySnapshot(&snapshots[renderSnapshot]);
+  }
+  wnoutrefresh(stdscr);
+  if(roundEndBanner)
+  {
+    wnoutrefresh(roundEndBanner);
+  }
+  doupdate();
+  unlockCurses();
+
+  PDC_get_render_stats(&stats);
+
+  unsigned long allocations = renderAllocations - allocationsBeforeFrame;
+
+  printf("%-20s %6lu lines %6lu compared %6lu runs %6lu cells %7lu bytes %3lu allocations\n", name, stats.lines, stats.compared, stats.runs,
+    stats.cells, stats.bytes, allocations);
+
+  // The offscreen port stores each cell it is sent as a chtype.
+  if(expected && (stats.lines != expected->lines || stats.compared != expected->compared || stats.runs != expected->runs ||
+     stats.cells != expected->cells || stats.bytes != stats.cells * sizeof(chtype)))
+  {
+    printf("FAIL: the %s should send %lu lines, %lu compared, %lu runs and %lu cells of %u bytes\n", name, expected->lines, expected->compared,
+      expected->runs, expected->cells, (unsigned)sizeof(chtype));
+    passed = 0;
+  }
+
+  if(allocations)
+  {
+    printf("FAIL: the %s allocated from the heap\n", name);
+    passed = 0;
+  }
+
+  return passed;
+}
+
+int main(int argc, char* argv[])
+{
+  struct ArchetypeTable bases;
+  struct ArchetypeTable cities;
+  // A new screen is redrawn whole, a line at a time, without comparing anything.
+  struct ExpectedStats firstFrame = {VIEWPORT_HEIGHT, 0, VIEWPORT_HEIGHT, VIEWPORT_HEIGHT * VIEWPORT_WIDTH};
+  struct ExpectedStats unchangedFrame = {0, 0, 0, 0};
+  struct ExpectedStats changedFrame = {1, 1, 1, 1};
+  int y = VIEWPORT_HEIGHT / 2;
+  int x = VIEWPORT_WIDTH / 2;
+  int score = 0;
+  int failures = 0;
+
+  if(argc > 1)
+  {
+    fprintf(stderr, "Usage: %s\n", argv[0]);
+    return 2;
+  }
+
+  initscr();
+
+  if(resize_term(VIEWPORT_HEIGHT, VIEWPORT_WIDTH) == ERR)
+  {
+    endwin();
+    fprintf(stderr, "%s: cannot make a %d by %d screen\n", argv[0], VIEWPORT_WIDTH, VIEWPORT_HEIGHT);
+    return 1;
+  }
+
+  initColours();
+  initSprites();
+  initAllocators();
+
+  // Publishing a snapshot signals the render thread, and frames are drawn with cursesLock held, as in the game.
+  snapshotReady = CreateEvent(NULL, FALSE, FALSE, NULL);
+  InitializeCriticalSection(&cursesLock);
+
+  if(!initArchetypeTable(&bases, BASE_ARCHETYPE, NUMBER_OF_BASES, 0) || !initArchetypeTable(&cities, CITY_ARCHETYPE, NUMBER_OF_CITIES, 0))
+  {
+    endwin();
+    fprintf(stderr, "%s: cannot allocate the tables\n", argv[0]);
+    return 1;
+  }
+
+  // The start of a round.
+  initBases(&bases);
+  initCities(&cities, &bases);
+  clearCanvas();
+  drawLandscape(&bases, &cities);
+  failures += !presentFrame("first frame", &firstFrame);
+
+  failures += !presentFrame("unchanged frame", &unchangedFrame);
+
+  // The landscape is drawn again over itself, as when a round ends, so only the one sky cell differs.
+  drawLandscape(&bases, &cities);
+  storeCanvasCell(y, x, '*' | COLOR_PAIR(WHITE));
+  failures += !presentFrame("one cell changed", &changedFrame);
+
+  if(PDC_offscreen_cell(y, x) != ('*' | COLOR_PAIR(WHITE)))
+  {
+    printf("FAIL: the changed cell did not reach the screen\n");
+    failures++;
+  }
+
+  // The banner is taken from the overlay arena, which is emptied when the banner is erased.
+  drawRoundEnd(&score, &bases, &cities, 0, 1);
+  failures += !presentFrame("round end banner", NULL);
+
+  hideRoundEnd();
+  failures += !presentFrame("banner erased", NULL);
+  failures += !presentFrame("unchanged frame", &unchangedFrame);
+
+  if(overlayAllocator->stats.bytes)
+  {
+    printf("FAIL: the overlay arena still holds %lu bytes once the banner is erased\n", (unsigned long)overlayAllocator->stats.bytes);
+    failures++;
+  }
+
+  endwin();
+
+  printf("%s\n", failures ? "FAILED" : "OK");
+
+  return failures ? 1 : 0;
+}
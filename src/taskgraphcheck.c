@@ -0,0 +1,338 @@
+/**
+ * Description: Checks that a tick whose missile phases run as frameGraph on the task pool leaves the canvas and the game's state exactly as the serial path does.
+ *
+ * Usage: taskgraphcheck [TICKS]
+ * Plays 2000 ticks unless told otherwise, keeping the missile buffers full. Each tick is run twice from the same state and the same random seed:
+ * once on the simulation thread, and once through runTaskGraph() with PARALLEL_MISSILES_VARIABLE set to 1. Fails if the canvas, a table, the score or the tick's events differ.
+ * The clock is simulated, so that both runs see the same timers fall due. Needs more than one processor.
+ * Builds like the game, which it includes, with MinGW on Windows: "make check" builds and runs it with the other checks, or "make taskgraphcheck.exe" builds it alone.
+ */
+#include <curses.h>
+#include <limits.h>
+#include <math.h>
+#include <time.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+
+// The game is included with its own main() renamed, and with its clock replaced by checkClock().
+#define main gameMain
+#define clock() checkClock()
+
+static clock_t checkClock();
+
+#include "main.c"
+
+#undef main
+#undef clock
+
+// The simulated time between ticks, in clock ticks.
+#define CHECK_TICK_CLOCKS (CLOCKS_PER_SEC / 100)
+// The number of ticks after which destroyed bases and cities are rebuilt, so that missiles keep being fired at them.
+#define CHECK_ROUND_TICKS 400
+// The number of tables in a tick's state.
+#define CHECK_TABLES 4
+
+// The simulated time, advanced by CHECK_TICK_CLOCKS each tick.
+static clock_t checkTime = CLOCKS_PER_SEC;
+
+/**
+ * checkClock
+ * Description: Stands in for clock() in the game, so that both runs of a tick see the same time.
+ * Returns: the simulated time
+ */
+static clock_t checkClock()
+{
+  return checkTime;
+}
+
+/**
+ * TickState
+ * Description: Everything that the missile phases of a tick can change, to restore before the second run and to compare the runs by.
+ * Fields:
+ * tables - the bases, cities, player missiles and enemy missiles
+ * storage - a copy of the storage of each table
+ * canvas - the canvas
+ * events - the tick's events
+ * score - the player's score
+ * enemyMissilesDestroyed - the number of enemy missiles intercepted
+ * gameState - the state of the game
+ * playersLastUpdateTime - when the player missiles last moved
+ * enemiesLastUpdateTime - when the enemy missiles last moved
+ */
+struct TickState {
+  struct ArchetypeTable tables[CHECK_TABLES];
+  unsigned char* storage[CHECK_TABLES];
+  struct Canvas canvas;
+  struct FlightRecord events;
+  int score;
+  int enemyMissilesDestroyed;
+  enum gameStates gameState;
+  clock_t playersLastUpdateTime;
+  clock_t enemiesLastUpdateTime;
+};
+
+/**
+ * getTableStorageSize
+ * Description: Measures the storage of a table, without changing the table.
+ * Params:
+ * table - the table
+ * Returns: the bytes of storage that the table has
+ */
+size_t getTableStorageSize(struct ArchetypeTable* table)
+{
+  struct ArchetypeTable scratch = *table;
+
+  return layoutArchetypeTable(&scratch, NULL);
+}
+
+/**
+ * saveTickState
+ * Description: Copies the state that a tick works on.
+ * Params:
+ * state - the copy, whose storage has been allocated
+ * tables - the tick's tables, in the order of TickState
+ * tick - the tick
+ */
+void saveTickState(struct TickState* state, struct ArchetypeTable** tables, struct SimulationTick* tick)
+{
+  for(int i = 0; i < CHECK_TABLES; i++)
+  {
+    state->tables[i] = *tables[i];
+    memcpy(state->storage[i], tables[i]->storage, getTableStorageSize(tables[i]));
+  }
+
+  state->canvas = canvas;
+  state->events = nextSnapshot->events;
+  state->score = *tick->score;
+  state->enemyMissilesDestroyed = *tick->enemyMissilesDestroyed;
+  state->gameState = *tick->gameState;
+  state->playersLastUpdateTime = *tick->playersLastUpdateTime;
+  state->enemiesLastUpdateTime = *tick->enemiesLastUpdateTime;
+}
+
+/**
+ * restoreTickState
+ * Description: Puts back the state that a tick works on, as saveTickState() copied it.
+ * Params:
+ * state - the copy
+ * tables - the tick's tables, in the order of TickState
+ * tick - the tick
+ */
+void restoreTickState(struct TickState* state, struct ArchetypeTable** tables, struct SimulationTick* tick)
+{
+  for(int i = 0; i < CHECK_TABLES; i++)
+  {
+    *tables[i] = state->tables[i];
+    memcpy(tables[i]->storage, state->storage[i], getTableStorageSize(tables[i]));
+  }
+
+  canvas = state->canvas;
+  nextSnapshot->events = state->events;
+  *tick->score = state->score;
+  *tick->enemyMissilesDestroyed = state->enemyMissilesDestroyed;
+  *tick->gameState = state->gameState;
+  *tick->playersLastUpdateTime = state->playersLastUpdateTime;
+  *tick->enemiesLastUpdateTime = state->enemiesLastUpdateTime;
+}
+
+/**
+ * reportDifference
+ * Description: Prints what differed between the serial and parallel runs of a tick.
+ * Params:
+ * tick - the number of the tick
+ * difference - what differed
+ * Returns: 0, for compareTickStates() to return
+ */
+int reportDifference(int tick, const char* difference)
+{
+  printf("FAIL: tick %d: the %s differ\n", tick, difference);
+  return 0;
+}
+
+/**
+ * compareTickStates
+ * Description: Compares the states that the serial and parallel runs of a tick left, and prints the first difference.
+ * Params:
+ * serial - the state the serial run left
+ * parallel - the state the parallel run left
+ * tick - the number of the tick, to print
+ * Returns: 1 if the states are the same, else 0
+ */
+int compareTickStates(struct TickState* serial, struct TickState* parallel, int tick)
+{
+  const char* tableNames[CHECK_TABLES] = {"bases", "cities", "player missiles", "enemy missiles"};
+
+  for(int i = 0; i < CHECK_TABLES; i++)
+  {
+    if(serial->tables[i].count != parallel->tables[i].count ||
+       serial->tables[i].trails.freeCount != parallel->tables[i].trails.freeCount ||
+       memcmp(serial->storage[i], parallel->storage[i], getTableStorageSize(&serial->tables[i])))
+    {
+      return reportDifference(tick, tableNames[i]);
+    }
+  }
+
+  if(memcmp(serial->canvas.cells, parallel->canvas.cells, sizeof(serial->canvas.cells)) || serial->canvas.changed != parallel->canvas.changed)
+  {
+    return reportDifference(tick, "canvases");
+  }
+
+  if(serial->score != parallel->score || serial->enemyMissilesDestroyed != parallel->enemyMissilesDestroyed || serial->gameState != parallel->gameState)
+  {
+    return reportDifference(tick, "scores or game states");
+  }
+
+  if(serial->events.spawns != parallel->events.spawns || serial->events.interceptions != parallel->events.interceptions ||
+     serial->events.timersFired != parallel->events.timersFired)
+  {
+    return reportDifference(tick, "events");
+  }
+
+  if(serial->playersLastUpdateTime != parallel->playersLastUpdateTime || serial->enemiesLastUpdateTime != parallel->enemiesLastUpdateTime)
+  {
+    return reportDifference(tick, "missile timers");
+  }
+
+  return 1;
+}
+
+int main(int argc, char* argv[])
+{
+  int ticks = (argc > 1) ? atoi(argv[1]) : 2000;
+  struct ArchetypeTable bases;
+  struct ArchetypeTable cities;
+  struct ArchetypeTable playerMissiles;
+  struct ArchetypeTable enemyMissiles;
+  int score = 0;
+  int enemyMissilesDestroyed = 0;
+  int roundNumber = 1;
+  enum gameStates gameState = ongoing;
+  clock_t playersLastUpdateTime = 0;
+  clock_t enemiesLastUpdateTime = 0;
+  struct BlastGrid blastGrid;
+  struct SimulationTick tick = {&playerMissiles, &enemyMissiles, &bases, &cities, &gameState, &playersLastUpdateTime,
+    &enemiesLastUpdateTime, &roundNumber, &score, &enemyMissilesDestroyed, &blastGrid};
+  struct ArchetypeTable* tables[CHECK_TABLES] = {&bases, &cities, &playerMissiles, &enemyMissiles};
+  struct TickState before;
+  struct TickState serial;
+  struct TickState parallel;
+  unsigned long missileTicks = 0;
+  unsigned long interceptions = 0;
+  int failures = 0;
+
+  if(ticks < 1)
+  {
+    fprintf(stderr, "Usage: %s [TICKS]\n", argv[0]);
+    return 2;
+  }
+
+  int tablesCreated = initArchetypeTable(&bases, BASE_ARCHETYPE, NUMBER_OF_BASES, 0);
+  tablesCreated &= initArchetypeTable(&cities, CITY_ARCHETYPE, NUMBER_OF_CITIES, 0);
+  tablesCreated &= initArchetypeTable(&playerMissiles, PLAYER_MISSILE_ARCHETYPE, PLAYER_MISSILE_BUFFER, BLUE);
+  tablesCreated &= initArchetypeTable(&enemyMissiles, ENEMY_MISSILE_ARCHETYPE, ENEMY_MISSILE_BUFFER, WHITE);
+
+  for(int i = 0; i < CHECK_TABLES && tablesCreated; i++)
+  {
+    size_t size = getTableStorageSize(tables[i]);
+
+    before.storage[i] = malloc(size);
+    serial.storage[i] = malloc(size);
+    parallel.storage[i] = malloc(size);
+    tablesCreated = before.storage[i] && serial.storage[i] && parallel.storage[i];
+  }
+
+  if(!tablesCreated)
+  {
+    fprintf(stderr, "%s: cannot allocate the tables\n", argv[0]);
+    return 1;
+  }
+
+  // The parallel runs use the threshold that the variable sets, as the game does.
+  putenv(PARALLEL_MISSILES_VARIABLE "=1");
+  initSprites();
+  initFrameGraph(&tick);
+
+  unsigned int threshold = parallelMissiles;
+
+  if(!startTaskPool())
+  {
+    printf("The task pool has a single worker on this machine, so there is nothing to check\n");
+    return 0;
+  }
+
+  missileStepKernel = getMissileStepKernel(NULL);
+
+  for(int t = 0; t < ticks; t++)
+  {
+    checkTime += CHECK_TICK_CLOCKS;
+    nextSnapshot->launchCount = 0;
+    memset(&nextSnapshot->events, 0, sizeof(nextSnapshot->events));
+
+    if(t % CHECK_ROUND_TICKS == 0)
+    {
+      initBases(&bases);
+      initCities(&cities, &bases);
+      clearCanvas();
+      drawLandscape(&bases, &cities);
+    }
+
+    // Keeps both buffers full, firing at the enemy missiles so that there are interceptions to check.
+    srand(t);
+
+    while(enemyMissiles.count < enemyMissiles.capacity)
+    {
+      if(createEnemyMissile(&enemyMissiles, -1, &bases, &cities, -1) == -1)
+      {
+        break;
+      }
+    }
+
+    for(int row = 0; row < bases.count; row++)
+    {
+      bases.ammoCount[row] = MISSILES_PER_BASE;
+    }
+
+    if(enemyMissiles.count)
+    {
+      int row = rand() % enemyMissiles.count;
+      struct Vector target = {enemyMissiles.currX[row], enemyMissiles.currY[row] + 3};
+
+      createPlayerMissile(&playerMissiles, target, &bases, 0);
+    }
+
+    if(countActiveMissiles(&playerMissiles, &enemyMissiles))
+    {
+      missileTicks++;
+    }
+
+    saveTickState(&before, tables, &tick);
+
+    srand(t);
+    parallelMissiles = UINT_MAX;
+    runMissilePhases(&tick);
+    saveTickState(&serial, tables, &tick);
+
+    restoreTickState(&before, tables, &tick);
+
+    srand(t);
+    parallelMissiles = threshold;
+    runMissilePhases(&tick);
+    saveTickState(&parallel, tables, &tick);
+
+    interceptions += parallel.events.interceptions;
+
+    if(!compareTickStates(&serial, &parallel, t))
+    {
+      failures++;
+    }
+  }
+
+  stopTaskPool();
+
+  printf("%d ticks on %d workers, %lu with missiles, %lu interceptions: %s\n", ticks, taskWorkers, missileTicks, interceptions, failures ? "FAILED" : "OK");
+
+  return failures ? 1 : 0;
+}